@@ -43,7 +43,9 @@ class FileSystem;
  * initialized using a lambda-expression) that will be called whenever the file changes on
  * the hard disk. The callback function has this object passed as a parameter. If many
  * changes of the file happen in quick succession, each change will trigger a separate
- * call of the callback. The file system is not polled, but the changes are pushed to the
+ * call of the callback, except on Linux, where the callbacks are called from
+ * FileSystem::triggerFilesystemEvents once for all changes since its previous call. The
+ * file system is not polled, but the changes are pushed to the
  * application, so the changes are registered efficiently and are solely impacted by the
  * overhead of <code>std::function</code>.
  */
@@ -29,8 +29,11 @@
 #include <ghoul/designpattern/singleton.h>
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/filesystem/file.h>
+#include <ghoul/misc/mpscqueue.h>
 
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <functional>
@@ -258,6 +261,13 @@ public:
      */
     CacheManager* cacheManager();
 
+    /**
+     * Returns whether a CacheManager has been created with createCacheManager and not
+     * been destroyed since.
+     * \return <code>true</code> if the CacheManager exists; <code>false</code> otherwise
+     */
+    bool hasCacheManager() const;
+
     /**
      * Listen to file for changes. When file is changed the File callback will 
      * be called.
@@ -272,10 +282,25 @@ public:
 	void removeFileListener(File* file);
     
     /**
-     * Triggers callbacks on filesystem. May not be needed depending on environment.
+     * Triggers callbacks on filesystem, which may not be needed depending on
+     * environment, and calls the events that were queued with #queueFilesystemEvent.
+     * On Linux, the File callbacks are called from this method for all changes that
+     * have been detected since it was called last, and each File is only notified once
+     * regardless of how often its file has changed in the meantime. This method must
+     * not be called from more than one thread at a time.
      */
 	void triggerFilesystemEvents();
 
+    /**
+     * Queues the <code>event</code> to be called during the next call to
+     * #triggerFilesystemEvents on the thread that calls it. This method is thread-safe
+     * and lock-free and can be used by background threads to hand their results to the
+     * thread that triggers the filesystem events, usually the main thread. Events that
+     * are queued while the queued events are called are called by the following call.
+     * \param event The function that is called by #triggerFilesystemEvents
+     */
+    void queueFilesystemEvent(std::function<void()> event);
+
     friend class Singleton<FileSystem>;
 
 private:
@@ -343,6 +368,9 @@ private:
 	/// The cache manager object, only allocated if createCacheManager is called
 	CacheManager* _cacheManager;
 
+    /// The events that are called by the next triggerFilesystemEvents
+    MpscQueue<std::function<void()>> _queuedEvents;
+
 #ifdef WIN32
 
 	/**
@@ -412,14 +440,64 @@ private:
 	void deinitializeInternalLinux();
 
 	/**
-	 * Function that run by the watcher thread
+	 * Function that run by the watcher thread. It waits on the epoll instance for
+	 * either inotify events or the shutdown signal of the eventfd
+	 */
+	void inotifyWatcher();
+
+	/**
+	 * Reads all pending inotify events and pushes the relevant ones to the
+	 * _inotifyEvents queue. Called by the watcher thread
 	 */
-	static void inotifyWatcher();
+	void readInotifyEvents();
+
+	/**
+	 * Handles all events in the _inotifyEvents queue and calls the callback of each
+	 * affected File once. Called by triggerFilesystemEvents
+	 */
+	void dispatchInotifyEvents();
+
+	/**
+	 * Calls the callbacks of all files tracked with the watch descriptor <code>wd</code>
+	 */
+	void notifyTrackedFiles(int wd);
+
+	/**
+	 * Watches the path of the files tracked with the watch descriptor <code>wd</code>
+	 * again and moves them to the new watch descriptor, which is returned. This is
+	 * necessary if the watched file was replaced or if its watch was removed
+	 */
+	int rewatchTrackedFiles(int wd);
+
+	/**
+	 * Rewatches all tracked files after events have been lost due to an overflow of the
+	 * inotify event queue and returns the watch descriptors, all of which have to be
+	 * notified
+	 */
+	std::vector<int> rescanTrackedFiles();
+
+    /// A relevant inotify event that is passed from the watcher thread to
+    /// triggerFilesystemEvents
+    struct InotifyEvent {
+        int wd;
+        uint32_t mask;
+    };
 
     int _inotifyHandle;
-    bool _keepGoing;
+    /// The epoll instance on which the watcher thread waits
+    int _epollHandle;
+    /// The eventfd that is signaled to stop the watcher thread
+    int _shutdownHandle;
     std::thread _t;
+    /// The tracked files keyed by the inotify watch descriptor of their path
     std::multimap<int, File*> _trackedFiles;
+    /// Protects _trackedFiles, which is only used by the threads adding and removing
+    /// file listeners, including from within the callbacks, and triggering the events
+    std::recursive_mutex _trackedFilesMutex;
+    /// The buffer into which the inotify events are read by the watcher thread
+    std::vector<char> _inotifyBuffer;
+    /// The events that the watcher thread passes to triggerFilesystemEvents
+    MpscQueue<InotifyEvent> _inotifyEvents;
     
 #endif
 };
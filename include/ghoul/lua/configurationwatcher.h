@@ -0,0 +1,139 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __CONFIGURATIONWATCHER_H__
+#define __CONFIGURATIONWATCHER_H__
+
+#include <ghoul/misc/dictionary.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * The ConfigurationWatcher keeps Lua configuration files, as loaded by
+ * #loadDictionaryFromFile, up to date while they are edited. Each watched file is
+ * tracked with a ghoul::filesystem::File callback. When a file changes, it is reloaded
+ * on a background thread once no further change has been reported for the debounce
+ * interval, so that the burst of writes caused by saving a file results in a single
+ * reload. Only the changed script is executed, using a state leased from the internal
+ * LuaStatePool, and the differences to the previous configuration are computed on the
+ * background thread as well. The new configuration and the differences are then
+ * delivered to the ReloadCallback through FileSystem::queueFilesystemEvent, that is, on
+ * the thread that calls FileSystem::triggerFilesystemEvents, which usually is the main
+ * thread. Thus, the thread calling FileSystem::triggerFilesystemEvents never executes a
+ * script and only pays for the callbacks. If a script fails to load, an error is logged
+ * and the previous configuration is kept. A change that does not result in a
+ * different configuration is not delivered. The FileSystem has to remain initialized
+ * while a ConfigurationWatcher exists. All methods are thread-safe.
+ */
+class ConfigurationWatcher {
+public:
+    /**
+     * The callback that is called with the new <code>configuration</code> of a file and
+     * the <code>changes</code> compared to the previous configuration. The
+     * <code>configuration</code> is an immutable snapshot as created by
+     * ghoul::Dictionary::freeze.
+     */
+    typedef std::function<void (const Dictionary& configuration,
+        const Dictionary::ChangeSet& changes)> ReloadCallback;
+
+    /**
+     * Creates a ConfigurationWatcher and starts its background thread.
+     * \param debounceInterval The time that has to pass after the last change of a file
+     * before the file is reloaded
+     * \param contiguousArrays If <code>true</code>, tables that are non-empty sequences
+     * of numbers are stored as contiguous arrays. See #luaDictionaryFromState
+     */
+    explicit ConfigurationWatcher(
+        std::chrono::milliseconds debounceInterval = std::chrono::milliseconds(20),
+        bool contiguousArrays = false);
+
+    /**
+     * Stops the background thread and all watches. Reloads that have been queued but
+     * not yet been delivered by FileSystem::triggerFilesystemEvents are discarded.
+     */
+    ~ConfigurationWatcher();
+
+    /**
+     * Loads the configuration file <code>filename</code> and starts watching it. The
+     * <code>callback</code> is called once on the calling thread with the initial
+     * configuration, in which case all keys are reported as added, and afterwards on the
+     * thread calling FileSystem::triggerFilesystemEvents whenever the file has been
+     * reloaded. If the file is already watched, its <code>callback</code> is replaced
+     * and it is reloaded.
+     * \param filename The path to the Lua configuration file, which may contain tokens
+     * \param callback The callback that is called with each new configuration
+     * \return <code>true</code> if the initial configuration was loaded successfully,
+     * <code>false</code> otherwise, in which case the file is not watched
+     */
+    bool watch(const std::string& filename, ReloadCallback callback);
+
+    /**
+     * Stops watching the configuration file <code>filename</code>. Reloads of the file
+     * that have not yet been delivered are discarded.
+     * \param filename The path to the Lua configuration file, which may contain tokens
+     */
+    void unwatch(const std::string& filename);
+
+    /**
+     * Returns <code>true</code> if the configuration file <code>filename</code> is
+     * watched.
+     * \param filename The path to the Lua configuration file, which may contain tokens
+     * \return <code>true</code> if the file is watched, <code>false</code> otherwise
+     */
+    bool isWatching(const std::string& filename) const;
+
+    /**
+     * Returns the most recently loaded configuration of the file <code>filename</code>,
+     * which might not have been delivered to the ReloadCallback yet, or
+     * <code>nullptr</code> if the file is not watched.
+     * \param filename The path to the Lua configuration file, which may contain tokens
+     * \return The most recently loaded configuration or <code>nullptr</code>
+     */
+    std::shared_ptr<const Dictionary> configuration(const std::string& filename) const;
+
+private:
+    struct Data;
+
+    ConfigurationWatcher(const ConfigurationWatcher&) = delete;
+    ConfigurationWatcher& operator=(const ConfigurationWatcher&) = delete;
+
+    /// The state that is shared with the background thread and the queued deliveries
+    std::shared_ptr<Data> _data;
+
+    /// The background thread that reloads the changed files
+    std::thread _worker;
+};
+
+} // namespace lua
+} // namespace ghoul
+
+#endif // __CONFIGURATIONWATCHER_H__
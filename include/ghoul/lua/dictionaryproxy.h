@@ -0,0 +1,98 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __DICTIONARYPROXY_H__
+#define __DICTIONARYPROXY_H__
+
+#include <memory>
+
+struct lua_State;
+
+namespace ghoul {
+
+class Dictionary;
+
+namespace lua {
+
+/**
+ * Pushes a read-only proxy for the <code>dictionary</code> onto the stack of the Lua
+ * state <code>L</code>. In contrast to #luaDictionaryToState, no table is created;
+ * instead, the proxy is a userdata whose <code>__index</code>, <code>__len</code>, and
+ * <code>__pairs</code> metamethods read from the <code>dictionary</code> when a script
+ * accesses it, so that a script which only reads a few keys of a large
+ * #ghoul::Dictionary only pays for these keys. Each accessed value is cached in the
+ * proxy, and nested #ghoul::Dictionary%s are returned as proxies themselves, so
+ * accessing the same key twice returns the same object. Keys are looked up verbatim
+ * on each level, that is, <code>proxy.a.b</code> has to be used instead of
+ * <code>proxy["a.b"]</code>, and numeric keys are converted into strings, just as they
+ * are by #luaDictionaryFromState. Contiguous arrays are converted into a new table on
+ * each access, which is a mutable copy, so modifying it does not affect the proxy.
+ * Values that are stored as <code>boost::any</code> are <code>nil</code>. Assigning to
+ * a proxy raises a Lua error. A full table can be created with
+ * #dictionaryProxyToTable.
+ * \param L The Lua state onto which the proxy is pushed
+ * \param dictionary The immutable #ghoul::Dictionary, as created by
+ * ghoul::Dictionary::freeze, that is shared with the proxy. It is kept alive until the
+ * proxy and all of its nested proxies have been garbage collected
+ */
+void pushDictionaryProxy(lua_State* L, std::shared_ptr<const Dictionary> dictionary);
+
+/**
+ * Pushes a read-only proxy for a snapshot of the <code>dictionary</code> onto the stack
+ * of the Lua state <code>L</code>. The snapshot is a copy of the <code>dictionary</code>,
+ * so later modifications of the <code>dictionary</code> are not visible to the proxy.
+ * See #pushDictionaryProxy for more information.
+ * \param L The Lua state onto which the proxy is pushed
+ * \param dictionary The #ghoul::Dictionary whose snapshot is accessed by the proxy
+ */
+void pushDictionaryProxy(lua_State* L, const Dictionary& dictionary);
+
+/**
+ * Returns the #ghoul::Dictionary that is accessed by the proxy at the
+ * <code>index</code> of the stack of the Lua state <code>L</code>, or
+ * <code>nullptr</code> if the value at the <code>index</code> is not a proxy created by
+ * #pushDictionaryProxy. For nested proxies, this is the nested #ghoul::Dictionary. The
+ * returned #ghoul::Dictionary is only valid as long as the proxy is.
+ * \param L The Lua state
+ * \param index The index of the stack entry that is tested
+ * \return The #ghoul::Dictionary of the proxy or <code>nullptr</code>
+ */
+const Dictionary* dictionaryFromProxy(lua_State* L, int index);
+
+/**
+ * A <code>lua_CFunction</code> that converts the proxy that is passed as its only
+ * argument into a table with #luaDictionaryToState and returns it. Tables are returned
+ * unchanged, so that scripts can call it regardless of which of them they have been
+ * given. To make it available to scripts, it has to be registered, for example with
+ * <code>lua_register(L, "toTable", &ghoul::lua::dictionaryProxyToTable)</code>.
+ * \param L The Lua state from which the function is called
+ * \return The number of values returned to Lua
+ */
+int dictionaryProxyToTable(lua_State* L);
+
+} // namespace lua
+} // namespace ghoul
+
+#endif // __DICTIONARYPROXY_H__
@@ -31,12 +31,18 @@
 
 #include <exception>
 #include <stdexcept>
+#include <vector>
 
 struct lua_State;
+extern "C" {
+    typedef void* (*lua_Alloc)(void* ud, void* ptr, size_t osize, size_t nsize);
+}
 
 namespace ghoul {
 namespace lua {
 
+class LuaAllocator;
+
 class FormattingException : public std::runtime_error {
 public:
     FormattingException(const std::string&);
@@ -75,19 +81,51 @@ std::string logStack(lua_State* state, logging::LogManager::LogLevel level =
                          logging::LogManager::LogLevel::Info);
 
 
+/**
+ * Determines what #loadDictionaryFromFile stores in the filesystem::CacheManager to speed
+ * up later loads of the same file. Nothing is cached if the FileSystem does not have a
+ * filesystem::CacheManager.
+ */
+enum class ScriptCache {
+    /// Nothing is cached
+    None,
+    /// The compiled script is cached and reused as long as the contents of the file do
+    /// not change. The script is still executed on every load
+    Bytecode,
+    /**
+     * In addition to the bytecode, the resulting #ghoul::Dictionary is cached together
+     * with all files that were loaded through <code>dofile</code>,
+     * <code>loadfile</code>, or <code>require</code> while the script was executed. As
+     * long as none of these files change, later loads deserialize the cached
+     * #ghoul::Dictionary without executing the script or leasing a Lua state. This is
+     * only correct for scripts that always return the same table for the same files
+     */
+    Result
+};
+
 /**
  * Loads a Lua configuration into the given #ghoul::Dictionary%, extending the passed in
  * dictionary. This method will overwrite value with the same keys, but will not remove
  * any other keys from the dictionary. The script contained in the file must return a
  * single table, which is then parsed and included into the #ghoul::Dictionary. The single
  * restriction on the script is that it can only contain a pure array-style table (= only
- * indexed by numbers) or a pure dictionary-style table (= no numbering indices).
+ * indexed by numbers) or a pure dictionary-style table (= no numbering indices). If the
+ * <code>dictionary</code> was created with a ghoul::MemoryArena, all levels that are
+ * added are allocated from it (see ghoul::Dictionary::arena), which is useful for large
+ * configurations that are built once and not modified afterwards.
  * \param filename The filename pointing to the script that is executed
  * \param dictionary The #ghoul::Dictionary into which the values from the script are
  * added
  * \param state If this is set to a valid lua_State, this state is used instead of
- * creating a new state. It is the callers responsibility to ensure that the passed state
- * is valid. After calling this method, the stack of the passed state will be empty.
+ * leasing a state from an internal LuaStatePool, which is what makes concurrent calls
+ * without a <code>state</code> safe. It is the callers responsibility to ensure that the
+ * passed state is valid. After calling this method, the stack of the passed state will
+ * be empty.
+ * \param contiguousArrays If <code>true</code>, tables that are non-empty sequences of
+ * numbers are stored as contiguous <code>std::vector<double></code>s rather than as
+ * nested #ghoul::Dictionary%s. See #luaDictionaryFromState
+ * \param cache Determines whether the compiled script or its result are cached in the
+ * filesystem::CacheManager. See ScriptCache
  * \return Returns <code>true</code> if the loading succeeded; <code>false</code>
  * otherwise.
  * \throws #ghoul::lua::FormattingException If the #ghoul::Dictionary contains mixed
@@ -96,7 +134,9 @@ std::string logStack(lua_State* state, logging::LogManager::LogLevel level =
 bool loadDictionaryFromFile(
     const std::string& filename,
     ghoul::Dictionary& dictionary,
-    lua_State* state = nullptr
+    lua_State* state = nullptr,
+    bool contiguousArrays = false,
+    ScriptCache cache = ScriptCache::None
     );
 
 /**
@@ -105,13 +145,21 @@ bool loadDictionaryFromFile(
  * any other keys from the dictionary. The script contained in the string must return a
  * single table, which is then parsed and included into the #ghoul::Dictionary. The single
  * restriction on the script is that it can only contain a pure array-style table (= only
- * indexed by numbers) or a pure dictionary-style table (= no numbering indices).
+ * indexed by numbers) or a pure dictionary-style table (= no numbering indices). If the
+ * <code>dictionary</code> was created with a ghoul::MemoryArena, all levels that are
+ * added are allocated from it (see ghoul::Dictionary::arena), which is useful for large
+ * configurations that are built once and not modified afterwards.
  * \param script The source code of the script that is executed
  * \param dictionary The #ghoul::Dictionary into which the values from the script are
  * added
  * \param state If this is set to a valid lua_State, this state is used instead of
- * creating a new state. It is the callers responsibility to ensure that the passed state
- * is valid. After calling this method, the stack of the passed state will be empty.
+ * leasing a state from an internal LuaStatePool, which is what makes concurrent calls
+ * without a <code>state</code> safe. It is the callers responsibility to ensure that the
+ * passed state is valid. After calling this method, the stack of the passed state will
+ * be empty.
+ * \param contiguousArrays If <code>true</code>, tables that are non-empty sequences of
+ * numbers are stored as contiguous <code>std::vector<double></code>s rather than as
+ * nested #ghoul::Dictionary%s. See #luaDictionaryFromState
  * \return Returns <code>true</code> if the loading succeeded; <code>false</code>
  * otherwise.
  * \throws #ghoul::lua::FormattingException If the #ghoul::Dictionary contains mixed
@@ -120,7 +168,36 @@ bool loadDictionaryFromFile(
 bool loadDictionaryFromString(
     const std::string& script,
     ghoul::Dictionary& dictionary,
-    lua_State* state = nullptr
+    lua_State* state = nullptr,
+    bool contiguousArrays = false
+    );
+
+/**
+ * Loads each of the Lua configurations in <code>filenames</code> into a separate
+ * #ghoul::Dictionary in the same way as #loadDictionaryFromFile. The files are loaded in
+ * parallel by up to one thread per hardware thread, including the calling thread, each
+ * of which leases its own state from an internal LuaStatePool. This method returns after
+ * all files have been loaded.
+ * \param filenames The filenames pointing to the scripts that are executed
+ * \param dictionaries Will contain one #ghoul::Dictionary per file in the same order as
+ * the <code>filenames</code>. The #ghoul::Dictionary of a file that could not be loaded
+ * is empty
+ * \param contiguousArrays If <code>true</code>, tables that are non-empty sequences of
+ * numbers are stored as contiguous <code>std::vector<double></code>s rather than as
+ * nested #ghoul::Dictionary%s. See #luaDictionaryFromState
+ * \param cache Determines whether the compiled scripts or their results are cached.
+ * See ScriptCache
+ * \return Returns <code>true</code> if all files were loaded successfully;
+ * <code>false</code> otherwise
+ * \throws #ghoul::lua::FormattingException If one of the #ghoul::Dictionary%s contains
+ * mixed keys of both type <code>string</code> and type <code>number</code>. All other
+ * files are still loaded before the exception is thrown
+ */
+bool loadDictionariesFromFiles(
+    const std::vector<std::string>& filenames,
+    std::vector<ghoul::Dictionary>& dictionaries,
+    bool contiguousArrays = false,
+    ScriptCache cache = ScriptCache::None
     );
 
 /**
@@ -150,13 +227,71 @@ std::string luaTypeToString(int type);
  */
 lua_State* createNewLuaState();
 
+/**
+ * Creates a new Lua state that allocates all of its memory through the
+ * <code>allocator</code> function and initializes it with the default Lua libraries. If
+ * the allocation of memory fails, an error is logged and <code>nullptr</code> is
+ * returned.
+ * \param allocator The function through which the state allocates, reallocates, and
+ * releases all of its memory
+ * \param userData The opaque pointer that is passed to every call of
+ * <code>allocator</code>
+ * \return A valid Lua state or <code>nullptr</code> if the state creation failed
+ */
+lua_State* createNewLuaState(lua_Alloc allocator, void* userData);
+
+/**
+ * Creates a new Lua state that allocates all of its memory from the
+ * <code>allocator</code> and initializes it with the default Lua libraries. The
+ * <code>allocator</code> must outlive the state and must not be used by another state.
+ * If the allocation of memory fails, for example because the memory limit of the
+ * <code>allocator</code> is too low, an error is logged and <code>nullptr</code> is
+ * returned.
+ * \param allocator The LuaAllocator that provides the memory of the state
+ * \return A valid Lua state or <code>nullptr</code> if the state creation failed
+ */
+lua_State* createNewLuaState(LuaAllocator& allocator);
+
 /**
  * Destroys the passed lua state and frees all memory that is associated with it.
  * \param state The Lua state that is to be deleted
  */
 void destroyLuaState(lua_State* state);
 
-void luaDictionaryFromState(lua_State* L, ghoul::Dictionary& d);
+/**
+ * Adds the contents of the table at the top of the stack of the Lua state <code>L</code>
+ * to the #ghoul::Dictionary <code>d</code>. Nested tables are added as nested
+ * #ghoul::Dictionary%s, which use the same ghoul::MemoryArena as <code>d</code>. If
+ * <code>contiguousArrays</code> is <code>true</code>, nested tables that are non-empty
+ * sequences of numbers are instead added as a single contiguous
+ * <code>std::vector<double></code>, which avoids one Dictionary entry per element for
+ * large numeric arrays. These arrays are transparently converted into the
+ * vector and matrix types of the Dictionary, but their elements cannot be accessed by
+ * nested keys, which is why this is not the default. The keys of the table are added
+ * verbatim, so a key that contains a <code>.</code> does not create nested levels but
+ * can still be accessed as a whole, and sequences are added in the order of their
+ * indices.
+ * \param L The Lua state whose top-most stack entry is converted
+ * \param d The #ghoul::Dictionary into which the values are added
+ * \param contiguousArrays If <code>true</code>, numeric sequences are stored
+ * contiguously
+ * \throws #ghoul::lua::FormattingException If the table contains mixed keys of both
+ * type <code>string</code> and type <code>number</code>
+ */
+void luaDictionaryFromState(lua_State* L, ghoul::Dictionary& d,
+                            bool contiguousArrays = false);
+
+/**
+ * Pushes a new table with the contents of the #ghoul::Dictionary <code>d</code> onto the
+ * stack of the Lua state <code>L</code>, which is the inverse of #luaDictionaryFromState.
+ * Nested #ghoul::Dictionary%s and contiguous arrays become nested tables and keys that
+ * are positive integers become numeric keys, so sequences remain sequences. As booleans
+ * are stored as integral values, they are pushed as numbers. Values that are stored as
+ * <code>boost::any</code> cannot be converted and are skipped with a warning.
+ * \param L The Lua state onto which the table is pushed
+ * \param d The #ghoul::Dictionary that is converted
+ */
+void luaDictionaryToState(lua_State* L, const ghoul::Dictionary& d);
 
 namespace internal {
     void deinitializeGlobalState();
@@ -0,0 +1,154 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __LUAALLOCATOR_H__
+#define __LUAALLOCATOR_H__
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * A LuaAllocator provides the memory for a single Lua state and keeps track of how much
+ * memory the state uses. It is passed to the state through #allocate, which has the
+ * signature of a <code>lua_Alloc</code> function, and the pointer to the LuaAllocator
+ * as the user data (see #createNewLuaState). Small blocks, which make up the majority of
+ * Lua's allocations, are served from free lists of fixed size classes that are carved out
+ * of larger chunks, larger blocks are passed on to <code>std::realloc</code>. The chunks
+ * are only released when the LuaAllocator is destroyed, so blocks are reused by later
+ * allocations of the same size class. If a memory limit is set, all allocations that
+ * would exceed the limit fail, which causes Lua to raise a memory error in the state.
+ * As Lua states are single-threaded, the LuaAllocator is not thread-safe and must only be
+ * used by a single state.
+ */
+class LuaAllocator {
+public:
+    /// The memory usage of the Lua state that allocates from a LuaAllocator
+    struct Statistics {
+        /// The number of bytes that are currently allocated by the state
+        size_t currentBytes;
+        /// The highest number of bytes that were allocated at the same time
+        size_t peakBytes;
+        /// The number of allocations of new blocks
+        size_t nAllocations;
+        /// The number of reallocations of existing blocks to a different size
+        size_t nReallocations;
+        /// The number of blocks that were released
+        size_t nDeallocations;
+        /// The number of allocations that failed due to the memory limit
+        size_t nFailedAllocations;
+    };
+
+    /**
+     * Creates a LuaAllocator. No memory is requested before the first allocation.
+     * \param memoryLimit The maximum number of bytes that can be allocated at the same
+     * time. If it is <code>0</code>, the memory usage is not limited
+     */
+    explicit LuaAllocator(size_t memoryLimit = 0);
+
+    /**
+     * Releases all memory of this LuaAllocator. The Lua state that is using this
+     * LuaAllocator has to be closed before.
+     */
+    ~LuaAllocator();
+
+    /**
+     * The <code>lua_Alloc</code> function that allocates from the LuaAllocator that is
+     * passed as <code>allocator</code>. If <code>pointer</code> is <code>nullptr</code>,
+     * <code>oldSize</code> is ignored, as Lua passes the type of the new object instead.
+     * \param allocator The LuaAllocator from which the memory is allocated
+     * \param pointer The block that is reallocated or released, or <code>nullptr</code>
+     * \param oldSize The size of the block at <code>pointer</code>
+     * \param newSize The requested size of the block. If it is <code>0</code>, the block
+     * is released
+     * \return The reallocated block or <code>nullptr</code> if the block was released or
+     * the allocation failed
+     */
+    static void* allocate(void* allocator, void* pointer, size_t oldSize,
+                          size_t newSize);
+
+    /**
+     * Returns the memory usage of the Lua state using this LuaAllocator.
+     * \return The memory usage of the Lua state
+     */
+    const Statistics& statistics() const;
+
+    /**
+     * Returns the maximum number of bytes that can be allocated at the same time, or
+     * <code>0</code> if the memory usage is not limited.
+     * \return The maximum number of bytes that can be allocated at the same time
+     */
+    size_t memoryLimit() const;
+
+    /**
+     * Sets the maximum number of bytes that can be allocated at the same time. Lowering
+     * the limit below the current memory usage does not release any memory, but causes
+     * all further allocations that increase the memory usage to fail.
+     * \param memoryLimit The maximum number of bytes that can be allocated at the same
+     * time. If it is <code>0</code>, the memory usage is not limited
+     */
+    void setMemoryLimit(size_t memoryLimit);
+
+private:
+    LuaAllocator(const LuaAllocator& rhs) = delete;
+    LuaAllocator& operator=(const LuaAllocator& rhs) = delete;
+
+    /// The difference in size between neighboring size classes
+    static const size_t Granularity = 16;
+    /// The number of size classes, which determines the largest pooled block size
+    static const size_t NSizeClasses = 16;
+    /// The size of the chunks from which the blocks of the size classes are taken
+    static const size_t ChunkSize = 16 * 1024;
+
+    /// Reallocates the block at <code>pointer</code> as described in #allocate
+    void* reallocate(void* pointer, size_t oldSize, size_t newSize);
+
+    /// Returns a block of size class <code>sizeClass</code>
+    void* allocateBlock(size_t sizeClass);
+
+    /// Returns the block at <code>pointer</code> to the size class
+    /// <code>sizeClass</code>
+    void deallocateBlock(void* pointer, size_t sizeClass);
+
+    /// All chunks that have been requested so far
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    /// The unused remainder of the last chunk
+    char* _current;
+    /// The end of the last chunk
+    char* _end;
+    /// The heads of the singly linked lists of free blocks for each size class
+    void* _freeBlocks[NSizeClasses];
+
+    Statistics _statistics;
+    size_t _memoryLimit;
+};
+
+} // namespace lua
+} // namespace ghoul
+
+#endif // __LUAALLOCATOR_H__
@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __LUABINDING_H__
+#define __LUABINDING_H__
+
+#include <ghoul/glm.h>
+#include <ghoul/lua/dictionaryproxy.h>
+#include <ghoul/lua/ghoul_lua.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif // __cplusplus >= 201703L
+
+/**
+ * If <code>GHOUL_LUA_CHECK_ARGUMENTS</code> is <code>1</code>, the functions bound with
+ * ghoul::lua::bind and ghoul::lua::pushFunction check the number and the types of their
+ * arguments and raise a Lua error if they do not match. If it is <code>0</code>, the
+ * arguments are converted without any checks. Unless it is defined before this file is
+ * included, the checks are enabled if <code>NDEBUG</code> is not defined, just as
+ * <code>ghoul_assert</code>.
+ */
+#ifndef GHOUL_LUA_CHECK_ARGUMENTS
+#ifdef NDEBUG
+#define GHOUL_LUA_CHECK_ARGUMENTS 0
+#else
+#define GHOUL_LUA_CHECK_ARGUMENTS 1
+#endif // NDEBUG
+#endif // GHOUL_LUA_CHECK_ARGUMENTS
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * Converts values of type <code>T</code> between C++ and the stack of a Lua state. Each
+ * specialization provides the static methods
+ * \verbatim
+static void push(lua_State* L, const T& value);
+static T value(lua_State* L, int index);
+static bool hasValue(lua_State* L, int index);
+static const char* name();
+\endverbatim
+ * where <code>push</code> pushes the <code>value</code> onto the stack,
+ * <code>value</code> converts the stack entry at <code>index</code> without any checks,
+ * <code>hasValue</code> checks whether the stack entry at <code>index</code> can be
+ * converted, and <code>name</code> is used in error messages. Specializations exist for
+ * <code>bool</code>, all arithmetic types, <code>std::string</code>,
+ * <code>const char*</code>, <code>std::string_view</code> (if compiled as C++17), the
+ * glm vector types, which are represented as sequences of numbers, and
+ * #ghoul::Dictionary, which is represented as a table, but also accepts the proxies
+ * created by ghoul::lua::pushDictionaryProxy. Further types can be supported by
+ * adding specializations.
+ * \tparam T The C++ type that is converted
+ * \tparam Enable Used to specialize for groups of types
+ */
+template <typename T, typename Enable = void>
+struct StackTraits;
+
+/**
+ * Pushes the <code>value</code> onto the stack of the Lua state <code>L</code> using
+ * the StackTraits of <code>T</code>.
+ * \param L The Lua state
+ * \param value The value that is pushed
+ */
+template <typename T>
+void push(lua_State* L, const T& value);
+
+/**
+ * Converts the stack entry at the <code>index</code> of the Lua state <code>L</code>
+ * into a <code>T</code> using the StackTraits of <code>T</code>. The entry is not
+ * checked, so hasValue has to be used first if the type of the entry is unknown.
+ * \param L The Lua state
+ * \param index The index of the stack entry that is converted
+ * \return The converted value
+ */
+template <typename T>
+T value(lua_State* L, int index);
+
+/**
+ * Returns whether the stack entry at the <code>index</code> of the Lua state
+ * <code>L</code> can be converted into a <code>T</code>.
+ * \param L The Lua state
+ * \param index The index of the stack entry that is tested
+ * \return <code>true</code> if the stack entry can be converted; <code>false</code>
+ * otherwise
+ */
+template <typename T>
+bool hasValue(lua_State* L, int index);
+
+/**
+ * A <code>lua_CFunction</code> that calls the free function <code>Function</code> with
+ * the arguments on the stack and pushes its results. As the function is a template
+ * argument, the marshalling of all arguments and results is generated at compile time
+ * and the call is direct. Each argument is converted with the StackTraits of its decayed
+ * type, the result is pushed the same way, unless it is <code>void</code>, in which case
+ * no value is returned, or an <code>std::tuple</code>, whose elements are returned as
+ * multiple values. If <code>GHOUL_LUA_CHECK_ARGUMENTS</code> is enabled, a Lua error is
+ * raised if the number or types of the arguments do not match. Exceptions derived from
+ * <code>std::exception</code> that are thrown by <code>Function</code> are converted
+ * into Lua errors. Example:
+ * \verbatim
+double add(double a, double b);
+lua_register(L, "add", (&ghoul::lua::bind<decltype(&add), &add>));
+\endverbatim
+ * The parentheses are required when the function is passed to a macro, such as
+ * <code>lua_register</code>, as the template arguments contain a comma.
+ * \tparam Signature The type of the function pointer
+ * \tparam Function The function that is called
+ * \param L The Lua state from which the function is called
+ * \return The number of values returned to Lua
+ */
+template <typename Signature, Signature Function>
+int bind(lua_State* L);
+
+/**
+ * Pushes a Lua function that calls the <code>function</code> with the same marshalling
+ * as #bind. Unlike #bind, this works for any callable object, such as lambdas with
+ * captures, at the cost of an indirect call. The <code>function</code> is stored in a
+ * userdata that is destroyed when the Lua function is garbage collected.
+ * \param L The Lua state onto which the function is pushed
+ * \param function The function that is called
+ */
+template <typename R, typename... Args>
+void pushFunction(lua_State* L, std::function<R(Args...)> function);
+
+} // namespace lua
+} // namespace ghoul
+
+#include "luabinding.inl"
+
+#endif // __LUABINDING_H__
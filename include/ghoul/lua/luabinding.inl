@@ -0,0 +1,415 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <exception>
+#include <typeinfo>
+
+namespace ghoul {
+namespace lua {
+
+template <>
+struct StackTraits<bool> {
+    static void push(lua_State* L, bool value) {
+        lua_pushboolean(L, value ? 1 : 0);
+    }
+    static bool value(lua_State* L, int index) {
+        return lua_toboolean(L, index) != 0;
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_isboolean(L, index);
+    }
+    static const char* name() { return "boolean"; }
+};
+
+template <typename T>
+struct StackTraits<T, typename std::enable_if<
+    std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+    static void push(lua_State* L, T value) {
+        lua_pushinteger(L, static_cast<lua_Integer>(value));
+    }
+    static T value(lua_State* L, int index) {
+        int isInteger = 0;
+        const lua_Integer v = lua_tointegerx(L, index, &isInteger);
+        // Numbers with a fractional part are truncated as in a C++ conversion
+        return isInteger ? static_cast<T>(v) : static_cast<T>(lua_tonumber(L, index));
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_type(L, index) == LUA_TNUMBER;
+    }
+    static const char* name() { return "number"; }
+};
+
+template <typename T>
+struct StackTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static void push(lua_State* L, T value) {
+        lua_pushnumber(L, static_cast<lua_Number>(value));
+    }
+    static T value(lua_State* L, int index) {
+        return static_cast<T>(lua_tonumber(L, index));
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_type(L, index) == LUA_TNUMBER;
+    }
+    static const char* name() { return "number"; }
+};
+
+template <>
+struct StackTraits<std::string> {
+    static void push(lua_State* L, const std::string& value) {
+        lua_pushlstring(L, value.data(), value.size());
+    }
+    static std::string value(lua_State* L, int index) {
+        size_t length = 0;
+        const char* v = lua_tolstring(L, index, &length);
+        return std::string(v, length);
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_type(L, index) == LUA_TSTRING;
+    }
+    static const char* name() { return "string"; }
+};
+
+/// The returned pointer is only valid as long as the string remains on the stack
+template <>
+struct StackTraits<const char*> {
+    static void push(lua_State* L, const char* value) {
+        lua_pushstring(L, value);
+    }
+    static const char* value(lua_State* L, int index) {
+        return lua_tostring(L, index);
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_type(L, index) == LUA_TSTRING;
+    }
+    static const char* name() { return "string"; }
+};
+
+/// Character arrays decay into <code>char*</code>, which are only pushed
+template <>
+struct StackTraits<char*> {
+    static void push(lua_State* L, const char* value) {
+        lua_pushstring(L, value);
+    }
+};
+
+#if __cplusplus >= 201703L
+/// The returned view is only valid as long as the string remains on the stack
+template <>
+struct StackTraits<std::string_view> {
+    static void push(lua_State* L, std::string_view value) {
+        lua_pushlstring(L, value.data(), value.size());
+    }
+    static std::string_view value(lua_State* L, int index) {
+        size_t length = 0;
+        const char* v = lua_tolstring(L, index, &length);
+        return std::string_view(v, length);
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_type(L, index) == LUA_TSTRING;
+    }
+    static const char* name() { return "string"; }
+};
+#endif // __cplusplus >= 201703L
+
+namespace internal {
+
+/// The StackTraits of glm vectors, which are represented as sequences of numbers
+template <typename V, int N>
+struct VectorStackTraits {
+    typedef typename V::value_type Component;
+
+    static void push(lua_State* L, const V& value) {
+        lua_createtable(L, N, 0);
+        for (int i = 0; i < N; ++i) {
+            StackTraits<Component>::push(L, value[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+    }
+    static V value(lua_State* L, int index) {
+        V result;
+        for (int i = 0; i < N; ++i) {
+            lua_rawgeti(L, index, i + 1);
+            result[i] = StackTraits<Component>::value(L, -1);
+            lua_pop(L, 1);
+        }
+        return result;
+    }
+    static bool hasValue(lua_State* L, int index) {
+        if (!lua_istable(L, index) || lua_rawlen(L, index) != N)
+            return false;
+        for (int i = 0; i < N; ++i) {
+            lua_rawgeti(L, index, i + 1);
+            const bool isComponent = StackTraits<Component>::hasValue(L, -1);
+            lua_pop(L, 1);
+            if (!isComponent)
+                return false;
+        }
+        return true;
+    }
+    static const char* name() {
+        static const std::string n = "sequence of " + std::to_string(N) + " " +
+                                     StackTraits<Component>::name() + "s";
+        return n.c_str();
+    }
+};
+
+} // namespace internal
+
+template <>
+struct StackTraits<glm::vec2> : internal::VectorStackTraits<glm::vec2, 2> {};
+template <>
+struct StackTraits<glm::vec3> : internal::VectorStackTraits<glm::vec3, 3> {};
+template <>
+struct StackTraits<glm::vec4> : internal::VectorStackTraits<glm::vec4, 4> {};
+template <>
+struct StackTraits<glm::dvec2> : internal::VectorStackTraits<glm::dvec2, 2> {};
+template <>
+struct StackTraits<glm::dvec3> : internal::VectorStackTraits<glm::dvec3, 3> {};
+template <>
+struct StackTraits<glm::dvec4> : internal::VectorStackTraits<glm::dvec4, 4> {};
+template <>
+struct StackTraits<glm::ivec2> : internal::VectorStackTraits<glm::ivec2, 2> {};
+template <>
+struct StackTraits<glm::ivec3> : internal::VectorStackTraits<glm::ivec3, 3> {};
+template <>
+struct StackTraits<glm::ivec4> : internal::VectorStackTraits<glm::ivec4, 4> {};
+template <>
+struct StackTraits<glm::uvec2> : internal::VectorStackTraits<glm::uvec2, 2> {};
+template <>
+struct StackTraits<glm::uvec3> : internal::VectorStackTraits<glm::uvec3, 3> {};
+template <>
+struct StackTraits<glm::uvec4> : internal::VectorStackTraits<glm::uvec4, 4> {};
+template <>
+struct StackTraits<glm::bvec2> : internal::VectorStackTraits<glm::bvec2, 2> {};
+template <>
+struct StackTraits<glm::bvec3> : internal::VectorStackTraits<glm::bvec3, 3> {};
+template <>
+struct StackTraits<glm::bvec4> : internal::VectorStackTraits<glm::bvec4, 4> {};
+
+/// Dictionaries are converted with luaDictionaryToState and luaDictionaryFromState.
+/// Proxies created by pushDictionaryProxy are accepted as well and are copied, which
+/// shares their levels
+template <>
+struct StackTraits<Dictionary> {
+    static void push(lua_State* L, const Dictionary& value) {
+        luaDictionaryToState(L, value);
+    }
+    static Dictionary value(lua_State* L, int index) {
+        const Dictionary* proxied = dictionaryFromProxy(L, index);
+        if (proxied)
+            return *proxied;
+        Dictionary result;
+        lua_pushvalue(L, index);
+        luaDictionaryFromState(L, result);
+        lua_pop(L, 1);
+        return result;
+    }
+    static bool hasValue(lua_State* L, int index) {
+        return lua_istable(L, index) || dictionaryFromProxy(L, index) != nullptr;
+    }
+    static const char* name() { return "table"; }
+};
+
+template <typename T>
+void push(lua_State* L, const T& value) {
+    StackTraits<typename std::decay<T>::type>::push(L, value);
+}
+
+template <typename T>
+T value(lua_State* L, int index) {
+    return StackTraits<typename std::decay<T>::type>::value(L, index);
+}
+
+template <typename T>
+bool hasValue(lua_State* L, int index) {
+    return StackTraits<typename std::decay<T>::type>::hasValue(L, index);
+}
+
+namespace internal {
+
+template <size_t... I>
+struct IndexSequence {};
+
+template <size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MakeIndexSequence<0, I...> {
+    typedef IndexSequence<I...> type;
+};
+
+/// Converts the argument with the zero-based <code>index</code> of a bound function
+template <typename T>
+typename std::decay<T>::type argument(lua_State* L, size_t index) {
+    return lua::value<typename std::decay<T>::type>(L, static_cast<int>(index) + 1);
+}
+
+/// Pushes the result of a bound function and returns the number of pushed values
+template <typename R>
+struct Results {
+    static int push(lua_State* L, const R& value) {
+        lua::push(L, value);
+        return 1;
+    }
+};
+
+template <typename... Ts>
+struct Results<std::tuple<Ts...>> {
+    static int push(lua_State* L, const std::tuple<Ts...>& values) {
+        pushElements(L, values, typename MakeIndexSequence<sizeof...(Ts)>::type());
+        return static_cast<int>(sizeof...(Ts));
+    }
+
+    template <size_t... I>
+    static void pushElements(lua_State* L, const std::tuple<Ts...>& values,
+                             IndexSequence<I...>)
+    {
+        const int expand[] = { 0, (lua::push(L, std::get<I>(values)), 0)... };
+        (void)expand;
+    }
+};
+
+/// Calls a bound function with the converted arguments and pushes its results
+template <typename R, typename... Args>
+struct Invoker {
+    template <typename F, size_t... I>
+    static int invoke(lua_State* L, F& function, IndexSequence<I...>) {
+        typedef typename std::decay<R>::type Result;
+        return Results<Result>::push(L, function(argument<Args>(L, I)...));
+    }
+};
+
+template <typename... Args>
+struct Invoker<void, Args...> {
+    template <typename F, size_t... I>
+    static int invoke(lua_State* L, F& function, IndexSequence<I...>) {
+        function(argument<Args>(L, I)...);
+        return 0;
+    }
+};
+
+/// Raises a Lua error if the argument at <code>index</code> cannot be converted into
+/// a <code>T</code>
+template <typename T>
+void checkArgument(lua_State* L, int index) {
+    typedef StackTraits<typename std::decay<T>::type> Traits;
+    if (!Traits::hasValue(L, index)) {
+        const char* message = lua_pushfstring(
+            L, "%s expected, got %s", Traits::name(), luaL_typename(L, index)
+        );
+        luaL_argerror(L, index, message);
+    }
+}
+
+/// Raises a Lua error if the number or the types of the arguments do not match
+template <typename... Args, size_t... I>
+void checkArguments(lua_State* L, IndexSequence<I...>) {
+    const int nArguments = lua_gettop(L);
+    if (nArguments != static_cast<int>(sizeof...(Args))) {
+        luaL_error(
+            L,
+            "Expected %d arguments, got %d",
+            static_cast<int>(sizeof...(Args)),
+            nArguments
+        );
+    }
+    const int expand[] = { 0, (checkArgument<Args>(L, static_cast<int>(I) + 1), 0)... };
+    (void)expand;
+}
+
+/**
+ * Calls the <code>function</code> with the arguments on the stack. The checks happen
+ * before any C++ object is created and the Lua error for an exception is only raised
+ * after the exception has been handled, as raising a Lua error does not unwind the C++
+ * stack if Lua is compiled as C.
+ */
+template <typename R, typename... Args, typename F>
+int callFunction(lua_State* L, F& function) {
+    typedef typename MakeIndexSequence<sizeof...(Args)>::type Indices;
+#if GHOUL_LUA_CHECK_ARGUMENTS
+    checkArguments<Args...>(L, Indices());
+#endif // GHOUL_LUA_CHECK_ARGUMENTS
+    try {
+        return Invoker<R, Args...>::invoke(L, function, Indices());
+    }
+    catch (const std::exception& e) {
+        lua_pushstring(L, e.what());
+    }
+    return lua_error(L);
+}
+
+template <typename Signature, Signature Function>
+struct FunctionBinding;
+
+template <typename R, typename... Args, R (*Function)(Args...)>
+struct FunctionBinding<R (*)(Args...), Function> {
+    static int call(lua_State* L) {
+        R (*function)(Args...) = Function;
+        return callFunction<R, Args...>(L, function);
+    }
+};
+
+/// Calls the <code>std::function</code> that is stored in the first upvalue
+template <typename R, typename... Args>
+int callStoredFunction(lua_State* L) {
+    std::function<R(Args...)>* function = static_cast<std::function<R(Args...)>*>(
+        lua_touserdata(L, lua_upvalueindex(1))
+    );
+    return callFunction<R, Args...>(L, *function);
+}
+
+/// Destroys the <code>std::function</code> that is stored in a userdata
+template <typename R, typename... Args>
+int destroyStoredFunction(lua_State* L) {
+    typedef std::function<R(Args...)> Function;
+    static_cast<Function*>(lua_touserdata(L, 1))->~Function();
+    return 0;
+}
+
+} // namespace internal
+
+template <typename Signature, Signature Function>
+int bind(lua_State* L) {
+    return internal::FunctionBinding<Signature, Function>::call(L);
+}
+
+template <typename R, typename... Args>
+void pushFunction(lua_State* L, std::function<R(Args...)> function) {
+    typedef std::function<R(Args...)> Function;
+    void* storage = lua_newuserdata(L, sizeof(Function));
+    new (storage) Function(std::move(function));
+
+    // All stored functions of the same type share one metatable
+    if (luaL_newmetatable(L, typeid(Function).name())) {
+        lua_pushcfunction(L, (&internal::destroyStoredFunction<R, Args...>));
+        lua_setfield(L, -2, "__gc");
+    }
+    lua_setmetatable(L, -2);
+    lua_pushcclosure(L, (&internal::callStoredFunction<R, Args...>), 1);
+}
+
+} // namespace lua
+} // namespace ghoul
@@ -0,0 +1,264 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __LUAPROFILER_H__
+#define __LUAPROFILER_H__
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/highresclock.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct lua_State;
+struct lua_Debug;
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * A LuaProfiler measures where the scripts executed in a Lua state spend their time. It
+ * is attached to a state with #attach, which installs a hook with
+ * <code>lua_sethook</code> that is called whenever a function is called or returns and
+ * every <code>instructionInterval</code> virtual machine instructions. From these
+ * events, the LuaProfiler aggregates the number of calls, the inclusive and exclusive
+ * wall time, and the number of instructions for each function, the number of
+ * instructions and the time for each source line, and the exclusive time and
+ * instructions for each distinct call stack. The results can be retrieved as
+ * FunctionProfile%s and LineProfile%s, as a formatted flat profile, or as collapsed
+ * stacks that can be converted into flame graphs. The overhead for each function call is
+ * two clock readings and two hash lookups, the overhead for the instruction counting can
+ * be reduced by increasing the <code>instructionInterval</code>, at the expense of the
+ * precision of the instruction counts and the line times.<br>
+ * Only one LuaProfiler can be attached to a state at a time, and it replaces any other
+ * hook that was set on the state. Coroutines that are created after the LuaProfiler was
+ * attached inherit the hook and are profiled with separate call stacks. Functions that
+ * are left by an error are closed when a function further up the stack returns. The
+ * LuaProfiler is not thread-safe and has to be used from the thread executing the state.
+ */
+class LuaProfiler {
+public:
+    /// The aggregated measurements of a single function
+    struct FunctionProfile {
+        /// The name of the function, including the location where it was defined
+        std::string name;
+        /// The number of times the function was called
+        uint64_t nCalls;
+        /// The wall time spent in the function, including the functions it called.
+        /// Recursive calls are only counted once
+        std::chrono::nanoseconds inclusiveTime;
+        /// The wall time spent in the function, excluding the functions it called
+        std::chrono::nanoseconds exclusiveTime;
+        /// The number of instructions executed by the function itself
+        uint64_t nInstructions;
+    };
+
+    /// The aggregated measurements of a single source line
+    struct LineProfile {
+        /// The name of the function to which the line belongs
+        std::string function;
+        /// The line in the source of the function
+        int line;
+        /// The number of instructions executed in the line
+        uint64_t nInstructions;
+        /// The wall time spent in the line, measured between the instruction samples
+        std::chrono::nanoseconds time;
+    };
+
+    /// The value that is reported for each stack by #collapsedStacks
+    enum class StackValue {
+        Time,           ///< The exclusive time in microseconds
+        Instructions    ///< The number of instructions
+    };
+
+    /**
+     * Creates a LuaProfiler that is not attached to any state.
+     * \param instructionInterval The number of instructions after which the instruction
+     * counts and line times are updated. Has to be positive
+     */
+    explicit LuaProfiler(int instructionInterval = 1000);
+
+    /// Detaches the LuaProfiler from its state, if it is attached
+    ~LuaProfiler();
+
+    /**
+     * Attaches this LuaProfiler to the <code>state</code> and starts measuring. If the
+     * LuaProfiler is already attached to another state, it is detached first. The
+     * measurements of previous attachments are kept until #reset is called.
+     * \param state The state that is profiled. It has to outlive the attachment
+     */
+    void attach(lua_State* state);
+
+    /**
+     * Removes the hook from the state this LuaProfiler is attached to and closes all
+     * functions that are still running. Does nothing if the LuaProfiler is not attached.
+     */
+    void detach();
+
+    /**
+     * Returns whether this LuaProfiler is attached to a state.
+     * \return <code>true</code> if this LuaProfiler is attached; <code>false</code>
+     * otherwise
+     */
+    bool isAttached() const;
+
+    /// Removes all measurements. Functions that are currently running are not affected
+    void reset();
+
+    /**
+     * Returns the measurements of all functions that were called, sorted by their
+     * exclusive time in descending order.
+     * \return The measurements of all functions
+     */
+    std::vector<FunctionProfile> functionProfiles() const;
+
+    /**
+     * Returns the measurements of all source lines that were executed when the
+     * instructions were counted, sorted by their number of instructions in descending
+     * order.
+     * \return The measurements of all source lines
+     */
+    std::vector<LineProfile> lineProfiles() const;
+
+    /**
+     * Returns a flat profile with one line for each function, as returned by
+     * #functionProfiles, that lists the number of calls, the inclusive and exclusive time
+     * in milliseconds, and the number of instructions.
+     * \return The formatted flat profile
+     */
+    std::string flatProfile() const;
+
+    /**
+     * Returns one line for each distinct call stack in the <code>collapsed</code> format
+     * that is used by the flame graph tools. Each line consists of the names of the
+     * functions from the outermost to the innermost, separated by <code>;</code>,
+     * followed by a space and the <code>value</code> of the innermost function in this
+     * stack.
+     * \param value The value that is reported for each stack
+     * \return The collapsed stacks
+     */
+    std::string collapsedStacks(StackValue value = StackValue::Time) const;
+
+    /**
+     * Logs the #flatProfile at the provided <code>level</code> and returns the logged
+     * string, in the same way as #logStack.
+     * \param level The logging::LogManager::LogLevel at which the profile is logged
+     * \return The same string that was logged
+     */
+    std::string logProfile(logging::LogManager::LogLevel level =
+                           logging::LogManager::LogLevel::Info) const;
+
+private:
+    LuaProfiler(const LuaProfiler& rhs) = delete;
+    LuaProfiler& operator=(const LuaProfiler& rhs) = delete;
+
+    /// The hook that is installed in the state and forwards to the attached LuaProfiler
+    static void hook(lua_State* state, lua_Debug* ar);
+
+    /// A function that is currently running in one of the threads of the state
+    struct Frame {
+        size_t function;
+        size_t node;
+        HighResClock::time_point start;
+        std::chrono::nanoseconds childTime;
+    };
+
+    /// A node in the tree of call stacks
+    struct Node {
+        size_t function;
+        size_t parent;
+        std::vector<size_t> children;
+        std::chrono::nanoseconds exclusiveTime;
+        uint64_t nInstructions;
+    };
+
+    /// The measurements of a function
+    struct Function {
+        FunctionProfile profile;
+        /// The number of frames of the function that are currently running
+        int nActive;
+    };
+
+    /// The identification of a Lua function for the fast path of #functionIndex
+    struct LuaFunction {
+        /// The source of the function as reported by Lua, which is only compared by
+        /// address as it might have been collected
+        const char* source;
+        /// The line in which the function was defined
+        int line;
+        /// The printable version of the source
+        std::string shortSource;
+        /// The index of the function in #_functions
+        size_t function;
+    };
+
+    void enterFunction(lua_State* state, lua_Debug* ar, bool isTailCall);
+    void leaveFunction(lua_State* state, lua_Debug* ar);
+    void countInstructions(lua_State* state, lua_Debug* ar);
+
+    /// Closes the top frame of the <code>stack</code> at the time <code>now</code>
+    void closeFrame(std::vector<Frame>& stack, HighResClock::time_point now);
+
+    /// Returns the index of the function that is described by <code>ar</code>
+    size_t functionIndex(lua_State* state, lua_Debug* ar);
+
+    /// Returns the child node of <code>parent</code> for <code>function</code>
+    size_t childNode(size_t parent, size_t function);
+
+    /// Returns the names of the functions from the root to the <code>node</code>
+    std::string stackName(size_t node) const;
+
+    const int _instructionInterval;
+    lua_State* _state;
+
+    /// All functions that have been called, indexed by the values in the maps below
+    std::vector<Function> _functions;
+    /// The indices of Lua functions by the pointer to their source and their first line
+    std::unordered_map<uint64_t, LuaFunction> _luaFunctions;
+    /// The indices of C functions by their address
+    std::unordered_map<const void*, size_t> _cFunctions;
+    /// The indices of all functions by their name
+    std::unordered_map<std::string, size_t> _functionsByName;
+
+    /// The measurements of each line, indexed by function index and line
+    std::unordered_map<uint64_t, LineProfile> _lines;
+
+    /// The tree of call stacks, of which the first node is the root
+    std::vector<Node> _nodes;
+
+    /// The call stacks of all threads of the state
+    std::unordered_map<lua_State*, std::vector<Frame>> _stacks;
+
+    /// The time of the last instruction sample
+    HighResClock::time_point _lastSample;
+};
+
+} // namespace lua
+} // namespace ghoul
+
+#endif // __LUAPROFILER_H__
@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __LUASTATEPOOL_H__
+#define __LUASTATEPOOL_H__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+struct lua_State;
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * A LuaStatePool hands out Lua states with all standard libraries opened to callers that
+ * need one temporarily, for example to execute a configuration script. A state is leased
+ * through #acquire and is exclusively owned by the returned Lease until the Lease is
+ * destroyed, which allows every thread to use its own state concurrently. When a state is
+ * returned, its stack is cleared, all global variables and the table of loaded modules
+ * (<code>package.loaded</code>) are restored to the values they had after the libraries
+ * were opened, and a full garbage collection is performed, so that the next lease finds
+ * the state in the same condition as a newly created one. Changes to the contents of
+ * the library tables themselves are not undone. Up to
+ * <code>maximumIdleStates</code> returned states are kept for reuse, any additional
+ * states are closed. All methods are thread-safe.
+ */
+class LuaStatePool {
+public:
+    /**
+     * An exclusive lease of a Lua state from a LuaStatePool. The state is returned to the
+     * pool when the Lease is destroyed. A Lease can be moved, but not copied.
+     */
+    class Lease {
+    public:
+        /// Returns the leased state to its LuaStatePool
+        ~Lease();
+
+        /// Takes over the state leased by <code>other</code>
+        Lease(Lease&& other);
+
+        /// Returns the current state and takes over the state leased by
+        /// <code>other</code>
+        Lease& operator=(Lease&& other);
+
+        /**
+         * Returns the leased Lua state, which is <code>nullptr</code> if the creation of
+         * a new state failed.
+         * \return The leased Lua state
+         */
+        lua_State* state() const;
+
+        /// Returns <code>true</code> if this Lease holds a valid Lua state
+        explicit operator bool() const;
+
+    private:
+        friend class LuaStatePool;
+
+        Lease(LuaStatePool* pool, lua_State* state);
+        Lease(const Lease& rhs) = delete;
+        Lease& operator=(const Lease& rhs) = delete;
+
+        LuaStatePool* _pool;
+        lua_State* _state;
+    };
+
+    /**
+     * Creates an empty LuaStatePool. No state is created before the first call to
+     * #acquire.
+     * \param maximumIdleStates The maximum number of returned states that are kept for
+     * reuse. If it is <code>0</code>, the number of hardware threads is used
+     */
+    explicit LuaStatePool(size_t maximumIdleStates = 0);
+
+    /**
+     * Closes all idle states. All Lease%s of this LuaStatePool have to be destroyed
+     * before the LuaStatePool is destroyed.
+     */
+    ~LuaStatePool();
+
+    /**
+     * Leases an idle Lua state or creates a new one if no idle state exists. If the
+     * creation fails, an error is logged and the returned Lease holds no state.
+     * \return The Lease of the Lua state
+     */
+    Lease acquire();
+
+    /**
+     * Returns the number of states that are currently idle and ready to be leased.
+     * \return The number of idle states
+     */
+    size_t nIdleStates() const;
+
+    /**
+     * Closes all states that are currently idle. States that are leased at the time of
+     * the call are not affected.
+     */
+    void clear();
+
+private:
+    LuaStatePool(const LuaStatePool& rhs) = delete;
+    LuaStatePool& operator=(const LuaStatePool& rhs) = delete;
+
+    /// Creates a new state with all libraries and records its pristine globals and
+    /// loaded modules
+    static lua_State* createState();
+
+    /// Restores the <code>state</code> to its pristine condition
+    static void resetState(lua_State* state);
+
+    /// Resets the <code>state</code> and keeps it for reuse or closes it
+    void release(lua_State* state);
+
+    /// The maximum number of states in #_idleStates
+    const size_t _maximumIdleStates;
+    /// The states that are ready to be leased
+    std::vector<lua_State*> _idleStates;
+    /// Protects #_idleStates
+    mutable std::mutex _mutex;
+};
+
+} // namespace lua
+} // namespace ghoul
+
+#endif // __LUASTATEPOOL_H__
@@ -37,6 +37,8 @@
 
 namespace ghoul {
 
+class Dictionary;
+
 /**
  * This class is a buffer container for serialized objects. The serialize
  * functions copies the memory of the provided object to the end of the 
@@ -188,7 +190,29 @@ public:
 	template<typename T>
 	void deserialize(std::vector<T>& v);
     
+    /**
+     * Deserializes a Dictionary that was serialized with the Dictionary specialization
+     * of serialize. The values are only added to <code>v</code> if the whole Dictionary
+     * could be read, so truncated or malformed data leaves <code>v</code> unchanged.
+     * \param v The Dictionary to which the deserialized values are added
+     * \return <code>true</code> if the Dictionary was deserialized successfully
+     */
+    bool deserialize(Dictionary& v);
+    
 private:
+    /**
+     * Returns whether <code>size</code> bytes are left to be read
+     * \param size The number of bytes that should be read
+     * \return <code>true</code> if <code>size</code> bytes can be read
+     */
+    bool canRead(size_t size) const;
+    
+    /**
+     * Deserializes a std::string if enough bytes are left to be read
+     * \param v The string into which the data is read
+     * \return <code>true</code> if the string was deserialized successfully
+     */
+    bool deserializeChecked(std::string& v);
 
     std::vector<value_type> _data;
     size_t _offsetWrite;
@@ -207,6 +231,11 @@ void Buffer::serialize(const std::vector<std::string>& v);
 template<>
 void Buffer::deserialize(std::vector<std::string>& v);
 
+// Specialization for Dictionary. Values that are not of one of the types that the
+// Dictionary converts into a StorageType are skipped with a warning
+template<>
+void Buffer::serialize(const Dictionary& v);
+
 } // namespace ghoul
 
 #include "buffer.inl"
@@ -26,13 +26,35 @@
 #ifndef __DICTIONARY_H__
 #define __DICTIONARY_H__
 
+#include <ghoul/misc/dictionarykey.h>
+#include <ghoul/misc/memoryarena.h>
+
 #include <boost/any.hpp>
-#include <map>
+#include <boost/variant.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
 #include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif // __cplusplus >= 201703L
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace ghoul {
 
+class Buffer;
+class MappedDictionary;
+template <typename T>
+class DictionarySchema;
+namespace lua {
+    class DictionaryConverter;
+    class DictionaryProxy;
+} // namespace lua
+
 /**
  * The Dictionary is a class to generically store arbitrary items associated with and
  * accessible using an <code>std::string</code>%s. It has the abilitiy to store and
@@ -111,9 +133,61 @@ namespace ghoul {
  * controls if each individual level of the Dictionary is created on-the-fly or not. None
  * of the method will throw an exception of their own, but might pass exceptions from
  * the underlying systems, for example <code>boost::any</code>.
+ *
+ * Internally, the entries of each level are stored contiguously in insertion order
+ * together with the hash of their key. Small levels are searched linearly, larger levels
+ * use an additional open-addressing index into the entries. Values of the
+ * <code>StorageType</code>s, <code>std::string</code>s, and nested Dictionaries are
+ * stored inline in a closed variant; only values of other types require a
+ * <code>boost::any</code> with its separate allocation. The entries of a level are held
+ * in a reference-counted node that is shared between copies of a Dictionary and only
+ * copied once one of the copies is modified (copy-on-write). Copying a Dictionary is
+ * therefore a constant-time operation regardless of its size, and modifying a value in
+ * a copy only duplicates the levels on the path to this value, while all other nested
+ * Dictionaries remain shared. #memoryUsage reports how much memory is shared this way.
+ *
+ * Homogeneous numeric arrays can be stored contiguously as an
+ * <code>std::vector<double></code> or <code>std::vector<long long></code>. The elements
+ * of such an array cannot be addressed by nested keys, but the array is transparently
+ * converted into any of the types in the table above if the number of values agrees,
+ * and #getArray retrieves it, or a legacy Dictionary with the keys <code>1</code>,
+ * <code>2</code>, ..., as an <code>std::vector</code> of any numeric type. #valuePtr
+ * provides direct access to the contiguous storage.
  */
-class Dictionary : private std::map<std::string, boost::any> {
+class Dictionary {
 public:
+    /**
+     * A non-owning reference to a, potentially nested, key that is used by all methods
+     * that only look up values. A KeyView is implicitly created from an
+     * <code>std::string</code>, a null-terminated <code>const char*</code>, and, if
+     * compiled as C++17, an <code>std::string_view</code>, so that a lookup with a string
+     * literal or a part of a larger string does not create a temporary
+     * <code>std::string</code>. The referenced characters have to outlive the KeyView.
+     */
+    class KeyView {
+    public:
+        KeyView() : _data(""), _size(0) {}
+        KeyView(const char* key) : _data(key), _size(std::strlen(key)) {}
+        KeyView(const char* key, size_t size) : _data(key), _size(size) {}
+        KeyView(const std::string& key) : _data(key.data()), _size(key.size()) {}
+#if __cplusplus >= 201703L
+        KeyView(std::string_view key) : _data(key.data()), _size(key.size()) {}
+#endif // __cplusplus >= 201703L
+
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        std::string str() const { return std::string(_data, _size); }
+
+        friend std::ostream& operator<<(std::ostream& os, const KeyView& key) {
+            return os.write(key._data, key._size);
+        }
+
+    private:
+        const char* _data;
+        size_t _size;
+    };
+
     /**
      * Creates an empty Dictionary
      */
@@ -129,6 +203,22 @@ public:
      */
     Dictionary(std::initializer_list<std::pair<std::string, boost::any>> l);
 
+    /**
+     * Creates an empty Dictionary whose levels are allocated from the <code>arena</code>.
+     * All levels that are created within this Dictionary, either implicitly through
+     * #setValue with <code>createIntermediate</code> or when a level is copied before it
+     * is modified, are allocated from the same <code>arena</code>, which is kept alive
+     * until the last of these levels is destroyed. Building and destroying a large
+     * Dictionary then only requires a few bulk allocations. As the <code>arena</code>
+     * never reuses memory, it is only suited for Dictionaries that are built once and
+     * rarely modified afterwards. Keys and values that do not fit into an entry are
+     * still allocated individually. Snapshots created with #freeze do not use the
+     * <code>arena</code>.
+     * \param arena The MemoryArena that is used for the levels of this Dictionary, or
+     * <code>nullptr</code> to allocate them individually
+     */
+    explicit Dictionary(std::shared_ptr<MemoryArena> arena);
+
     /**
      * Returns all of the keys that are stored in the dictionary at a given
      * <code>location</code>. This location specifier can be recursive to inspect the keys
@@ -137,7 +227,7 @@ public:
      * \return A list of all keys that are stored in the Dictionary for the provided
      * location
      */
-    std::vector<std::string> keys(const std::string& location = "") const;
+    std::vector<std::string> keys(KeyView location = KeyView()) const;
 
     /**
      * Returns <code>true</code> if there is a specific key in the Dictionary, regardless
@@ -147,7 +237,7 @@ public:
      * \return <code>true</code> if the provided key exists in the Dictionary,
      * <code>false</code> otherwise
      */
-    bool hasKey(const std::string& key) const;
+    bool hasKey(KeyView key) const;
 
     /**
      * Adds the <code>value</code> for a given location at <code>key</code>. If a value
@@ -195,7 +285,7 @@ public:
      * <code>false</code> otherwise
      */
     template <typename T>
-    bool getValue(const std::string& key, T& value) const;
+    bool getValue(KeyView key, T& value) const;
 
     /**
      * Returns the value stored at location with a given <code>key</code>. This key can be
@@ -213,7 +303,7 @@ public:
      * \return value The value stored at the <code>key</code>
      */
 	template <typename T>
-	T value(const std::string& key) const;
+	T value(KeyView key) const;
 
     /**
      * Returns <code>true</code> if the Dictionary stores a value at the provided
@@ -228,7 +318,7 @@ public:
      * <code>false</code> otherwise
      */
     template <typename T>
-    bool hasValue(const std::string& key) const;
+    bool hasValue(KeyView key) const;
     
     /**
      * Returns <code>true</code> if the Dictionary contains a value for the specified
@@ -240,7 +330,153 @@ public:
      * <code>key</code> and the value is of type <code>T</code>
      */
     template <typename T>
-    bool hasKeyAndValue(const std::string& key) const;
+    bool hasKeyAndValue(KeyView key) const;
+
+    /**
+     * Returns <code>true</code> if there is a specific, pre-parsed <code>key</code> in
+     * the Dictionary, regardless of its type. See #hasKey for more information.
+     * \param key The key that should be checked for existence
+     * \return <code>true</code> if the provided key exists in the Dictionary,
+     * <code>false</code> otherwise
+     */
+    bool hasKey(const DictionaryKey& key) const;
+
+    /**
+     * Adds the <code>value</code> at the location of the pre-parsed <code>key</code>.
+     * See #setValue for more information.
+     * \param key The pre-parsed key at which the <code>value</code> will be entered
+     * \param value The value that will be added into the Dictionary
+     * \param createIntermediate If <code>true</code> all intermediate levels in the
+     * Dictionary will be automatically created along the way
+     * \return <code>true</code> if the value was stored successfully, <code>false</code>
+     * otherwise
+     */
+    template <typename T>
+    bool setValue(const DictionaryKey& key, T value, bool createIntermediate = false);
+
+    /**
+     * Returns the value stored at the location of the pre-parsed <code>key</code>. See
+     * #getValue for more information.
+     * \tparam The type of the value that should be retrieved
+     * \param key The pre-parsed key for which the stored value should be returned
+     * \param value A reference to the value where the value will be copied to, if it
+     * could be found and the types agree
+     * \return <code>true</code> if the value was retrieved successfully,
+     * <code>false</code> otherwise
+     */
+    template <typename T>
+    bool getValue(const DictionaryKey& key, T& value) const;
+
+    /**
+     * Returns the value stored at the location of the pre-parsed <code>key</code>. See
+     * #value for more information.
+     * \tparam The type of the value that should be retrieved
+     * \param key The pre-parsed key for which the stored value should be returned
+     * \return value The value stored at the <code>key</code>
+     */
+    template <typename T>
+    T value(const DictionaryKey& key) const;
+
+    /**
+     * Returns <code>true</code> if the Dictionary stores a value at the pre-parsed
+     * <code>key</code> and the stored type agrees with the provided template parameter.
+     * See #hasValue for more information.
+     * \tparam The type of the value that should be tested
+     * \param key The pre-parsed key which should be checked for existence
+     * \return <code>true</code> if the Dictionary contains a value at the specified
+     * <code>key</code> with the correct type <code>T</code>
+     */
+    template <typename T>
+    bool hasValue(const DictionaryKey& key) const;
+
+    /**
+     * Returns <code>true</code> if the Dictionary contains a value for the pre-parsed
+     * <code>key</code> and the value that is stored is of the type <code>T</code>.
+     * \tparam T The type of the value that should be tested
+     * \param key The pre-parsed key that should be tested
+     * \return <code>true</code> if the Dictionary contains a value for the
+     * <code>key</code> and the value is of type <code>T</code>
+     */
+    template <typename T>
+    bool hasKeyAndValue(const DictionaryKey& key) const;
+
+    /**
+     * Returns a pointer to the value stored at the, potentially nested, <code>key</code>
+     * without copying it. In contrast to #getValue, no conversions are performed, so
+     * <code>T</code> has to be the type in which the value is stored; for the types
+     * listed above, this is the <code>StorageType</code> (or an <code>std::array</code>
+     * of it for more than one value). The pointer is invalidated by any modification of
+     * the Dictionary. No error is logged if the key does not exist or if the type does
+     * not agree.
+     * \tparam T The type in which the value is stored
+     * \param key The, potentially nested, key for which the value should be returned
+     * \return A pointer to the stored value, or <code>nullptr</code> if the
+     * <code>key</code> does not exist or the stored value is not of type <code>T</code>
+     */
+    template <typename T>
+    const T* valuePtr(KeyView key) const;
+
+    /**
+     * Returns a pointer to the value stored at the pre-parsed <code>key</code> without
+     * copying it. See #valuePtr for more information.
+     * \tparam T The type in which the value is stored
+     * \param key The pre-parsed key for which the value should be returned
+     * \return A pointer to the stored value, or <code>nullptr</code> if the
+     * <code>key</code> does not exist or the stored value is not of type <code>T</code>
+     */
+    template <typename T>
+    const T* valuePtr(const DictionaryKey& key) const;
+
+    /**
+     * Returns a reference to the Dictionary stored at the, potentially nested,
+     * <code>key</code> without copying it. If the <code>key</code> does not exist or does
+     * not contain a Dictionary, the errors are logged the same way as in #getValue and
+     * a reference to an empty Dictionary is returned. The reference is invalidated by any
+     * modification of this Dictionary.
+     * \param key The, potentially nested, key of the Dictionary that should be returned
+     * \return A reference to the Dictionary stored at the <code>key</code>
+     */
+    const Dictionary& subDictionary(KeyView key) const;
+
+    /**
+     * Returns a reference to the Dictionary stored at the pre-parsed <code>key</code>
+     * without copying it. See #subDictionary for more information.
+     * \param key The pre-parsed key of the Dictionary that should be returned
+     * \return A reference to the Dictionary stored at the <code>key</code>
+     */
+    const Dictionary& subDictionary(const DictionaryKey& key) const;
+
+    /**
+     * Retrieves the numeric array stored at the, potentially nested, <code>key</code>
+     * and converts each element to the type <code>T</code>. The array can either be
+     * stored contiguously as an <code>std::vector<double></code> or
+     * <code>std::vector<long long></code>, or as a Dictionary with the keys
+     * <code>1</code>, <code>2</code>, ..., <code>n</code> as it is created from a Lua
+     * table. If the value is neither, an error is logged the same way as in #getValue and
+     * <code>values</code> is unchanged.
+     * \tparam T The numeric type of the elements that should be retrieved
+     * \param key The, potentially nested, key for which the array should be returned
+     * \param values The array that will contain the converted elements
+     * \return <code>true</code> if the array was retrieved successfully,
+     * <code>false</code> otherwise
+     */
+    template <typename T>
+    bool getArray(KeyView key, std::vector<T>& values) const;
+
+    /**
+     * Calls the <code>visitor</code> for each top-level entry of this Dictionary in the
+     * order in which the entries were added. The <code>visitor</code> is called with the
+     * signature <code>void(const std::string& key, const Dictionary* dictionary)</code>,
+     * where <code>dictionary</code> points to the nested Dictionary stored under
+     * <code>key</code> or is <code>nullptr</code> if the entry is not a Dictionary.
+     * Other values can be accessed using #valuePtr or #getValue from within the
+     * <code>visitor</code>. In contrast to #keys, no list of keys is created and the
+     * Dictionary must not be modified by the <code>visitor</code>.
+     * \tparam Visitor The type of the callable <code>visitor</code>
+     * \param visitor The callable object that is called for each entry
+     */
+    template <typename Visitor>
+    void forEach(Visitor visitor) const;
 
     /**
      * Returns the total number of keys stored in this Dictionary. This method will not
@@ -251,6 +487,15 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Reserves space for <code>nEntries</code> top-level entries, so that adding up to
+     * this number of entries does not reallocate the storage of this level. This is
+     * useful if the number of entries is known before they are added, for example when
+     * converting a table of a known size.
+     * \param nEntries The number of top-level entries for which space is reserved
+     */
+    void reserve(size_t nEntries);
+
     /**
      * Clears the Dictionary and leaves it in the same state as if it would just have been
      * created.
@@ -275,7 +520,216 @@ public:
 	 * \return Returns <code>true</code> if the key was successfully found and removed,
 	 * <code>false</code> otherwise
 	 */
-	bool removeKey(const std::string& key);
+	bool removeKey(KeyView key);
+
+    /**
+     * Moves the value stored at the, potentially nested, <code>key</code> into
+     * <code>value</code> and removes the key from the Dictionary. If the value is stored
+     * as the type <code>T</code>, for example an <code>std::string</code>, a nested
+     * Dictionary, or a contiguous array, it is moved without copying its contents;
+     * otherwise it is converted the same way as in #getValue before the key is removed.
+     * If the key does not exist or the type does not agree, the errors are logged the
+     * same way as in #getValue and the Dictionary is unchanged.
+     * \tparam T The type of the value that should be retrieved
+     * \param key The, potentially nested, key of the value that should be removed
+     * \param value A reference to the value where the value will be moved to
+     * \return <code>true</code> if the value was retrieved and removed successfully,
+     * <code>false</code> otherwise
+     */
+    template <typename T>
+    bool takeValue(KeyView key, T& value);
+
+    /**
+     * Constructs a value of type <code>T</code> from the <code>args</code> and stores it
+     * at the, potentially nested, <code>key</code>, creating all intermediate levels
+     * that do not exist. Values that are stored inline, such as
+     * <code>std::string</code>, Dictionary, or the contiguous arrays, are moved into the
+     * Dictionary without being copied; all other types are stored as with #setValue.
+     * \tparam T The type of the value that is constructed
+     * \tparam Args The types of the constructor arguments
+     * \param key The, potentially nested, key at which the value is stored
+     * \param args The arguments that are passed to the constructor of <code>T</code>
+     * \return <code>true</code> if the value was stored successfully,
+     * <code>false</code> otherwise
+     */
+    template <typename T, typename... Args>
+    bool emplaceValue(std::string key, Args&&... args);
+
+    /**
+     * Removes the Dictionary stored at the, potentially nested, <code>key</code> and
+     * returns it without copying any of its levels, so that the returned Dictionary can
+     * be modified without duplicating them. If the <code>key</code> does not exist or
+     * does not contain a Dictionary, the errors are logged the same way as in #getValue
+     * and an empty Dictionary is returned.
+     * \param key The, potentially nested, key of the Dictionary that should be removed
+     * \return The Dictionary that was stored at the <code>key</code>
+     */
+    Dictionary extractSubDictionary(KeyView key);
+
+    /**
+     * Enables or disables the interning of keys for all Dictionaries. While interning is
+     * enabled, the key of each newly added entry is stored only once in a process-wide
+     * table that is shared by all Dictionaries and all threads, so that keys that are
+     * repeated across many levels, such as <code>Type</code> or <code>Name</code>, do not
+     * have to be allocated and copied for each entry and can be compared by their address
+     * before comparing their characters. The table is never shrunk, so interning should
+     * only be enabled if the set of distinct keys is bounded. Entries that were added
+     * before the interning was changed keep their storage.
+     * \param enabled <code>true</code> if new keys should be interned, <code>false</code>
+     * if each entry should store its own key, which is the default
+     */
+    static void setKeyInterningEnabled(bool enabled);
+
+    /**
+     * Returns <code>true</code> if the keys of new entries are interned. See
+     * #setKeyInterningEnabled for more information.
+     * \return <code>true</code> if the keys of new entries are interned
+     */
+    static bool isKeyInterningEnabled();
+
+    /// The memory usage of a Dictionary as reported by #memoryUsage
+    struct MemoryUsage {
+        /// The number of distinct levels that are reachable from the Dictionary
+        size_t nNodes = 0;
+        /// The number of bytes used by the distinct levels
+        size_t bytes = 0;
+        /// The number of bytes of the levels that are shared with other Dictionaries or
+        /// occur more than once in this Dictionary
+        size_t sharedBytes = 0;
+        /// The number of bytes this Dictionary would use if no level was shared within it
+        size_t logicalBytes = 0;
+    };
+
+    /**
+     * Returns an estimate of the memory that is used by this Dictionary and all of its
+     * nested Dictionaries. Each level that is shared between several places is only
+     * counted once in MemoryUsage::bytes, but is counted for each place in
+     * MemoryUsage::logicalBytes. The estimate includes the entries, the index, the keys,
+     * and the strings and numeric arrays stored inline, but not the contents of values
+     * that are stored in a <code>boost::any</code>.
+     * \return The memory usage of this Dictionary
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * Creates an immutable snapshot of this Dictionary. All levels of the snapshot are
+     * laid out compactly, that is, without any spare capacity, and levels that are shared
+     * within this Dictionary remain shared in the snapshot. As no non-<code>const</code>
+     * methods can be called on the snapshot, it can be queried from any number of threads
+     * concurrently without locking, and later modifications of this Dictionary do not
+     * affect it. Copying a Dictionary out of the snapshot is possible and shares its
+     * levels until the copy is modified. Snapshots can be passed between threads using a
+     * DictionaryPublisher.
+     * \return An immutable snapshot of this Dictionary
+     */
+    std::shared_ptr<const Dictionary> freeze() const;
+
+    /**
+     * Returns the MemoryArena from which the levels of this Dictionary are allocated or
+     * <code>nullptr</code> if they are allocated individually. The MemoryArena can be
+     * used to query the number of bytes and blocks that have been allocated.
+     * \return The MemoryArena of this Dictionary
+     */
+    std::shared_ptr<MemoryArena> arena() const;
+
+    /**
+     * Returns a 64-bit structural hash of the contents of this Dictionary that can be
+     * used, for example, as a key for caches of assets derived from it. Dictionaries
+     * with the same keys and equal values have the same hash regardless of the order in
+     * which the keys were added, and the hash does not change between runs of the
+     * program. The types of the values are part of the hash, so <code>1</code> stored as
+     * an integer and <code>1.0</code> stored as a floating point number result in
+     * different hashes. Values that are stored as a <code>boost::any</code> of a type
+     * that the Dictionary does not convert into a <code>StorageType</code> only
+     * contribute their type.
+     *
+     * The hash of each level is cached and only the levels along the key of a
+     * modification are invalidated, so that rehashing a Dictionary after a single value
+     * has changed is proportional to the depth of the key rather than to the size of the
+     * Dictionary. It is safe to call this method concurrently on an immutable Dictionary,
+     * such as a snapshot created by #freeze.
+     * \return The structural hash of this Dictionary
+     */
+    uint64_t hash() const;
+
+    /// A single difference between two Dictionaries as computed by #diff
+    struct Change {
+        /// The kind of the difference
+        enum class Type {
+            Added = 0,  ///< The key only exists in the new Dictionary
+            Removed,    ///< The key only exists in the old Dictionary
+            Modified    ///< The key exists in both, but with different values
+        };
+
+        /// The kind of the difference
+        Type type;
+        /// The full, potentially nested, key whose value differs
+        std::string key;
+        /// The segments of #key, which also identify keys that contain a literal
+        /// <code>.</code> on one of their levels
+        DictionaryKey path;
+    };
+
+    /// The differences between two Dictionaries as computed by #diff
+    struct ChangeSet;
+
+    /**
+     * Computes the differences that turn this Dictionary into the <code>other</code>
+     * Dictionary. Nested Dictionaries that exist on both sides are compared recursively,
+     * so that a change deep inside the Dictionary is reported with its full nested key
+     * instead of as a modification of the top-level key. Levels that are shared between
+     * both Dictionaries, for example because one is an unmodified copy of the other, are
+     * skipped without being compared, as are levels whose structural hashes (see #hash)
+     * are equal. Values that are stored as a
+     * <code>boost::any</code> of a type that the Dictionary does not convert into a
+     * <code>StorageType</code> cannot be compared and are always reported as modified;
+     * as their contents are not part of the hash, levels containing them are always
+     * compared.
+     * \param other The Dictionary that this Dictionary is compared to
+     * \return The differences that turn this Dictionary into the <code>other</code>
+     */
+    ChangeSet diff(const Dictionary& other) const;
+
+    /**
+     * Applies all <code>changes</code>, as computed by #diff, to this Dictionary. If
+     * this Dictionary is equal to the Dictionary on which #diff was called, it is equal
+     * to the Dictionary that was passed to #diff afterwards. Only the levels along the
+     * changed keys are modified; all other levels remain shared with their previous
+     * copies.
+     * \param changes The changes that are applied
+     * \return <code>true</code> if all changes could be applied, <code>false</code> if
+     * a removed key did not exist or the parent of an added or modified key was not a
+     * Dictionary. All other changes are applied in either case
+     */
+    bool apply(const ChangeSet& changes);
+
+    /// A single value that was found by #query
+    struct Match;
+
+    /**
+     * Finds all values whose keys match the <code>pattern</code> and appends them to
+     * <code>result</code>. The <code>pattern</code> is a nested key in which a segment
+     * can be the wildcard <code>*</code>, which matches any single key, or
+     * <code>**</code>, which matches any number of nested keys, including none. For
+     * example, <code>Layers.*.Opacity</code> finds the <code>Opacity</code> of each
+     * layer, while <code>**.Opacity</code> finds all <code>Opacity</code> values at any
+     * depth. The matches are found in a single depth-first traversal, in which levels
+     * that are only matched against regular keys are searched directly rather than
+     * visited entry by entry. See Match for how the values are accessed.
+     * \param pattern The, potentially nested, key that can contain wildcards
+     * \param result The list to which all matches are appended
+     */
+    void query(const std::string& pattern, std::vector<Match>& result) const;
+
+    /**
+     * Finds all values whose keys match any of the <code>patterns</code> and appends them
+     * to <code>result</code>. All <code>patterns</code> are resolved in the same
+     * traversal and each value is added only once, even if it matches more than one
+     * pattern. See #query for the format of the <code>patterns</code>.
+     * \param patterns The, potentially nested, keys that can contain wildcards
+     * \param result The list to which all matches are appended
+     */
+    void query(const std::vector<std::string>& patterns, std::vector<Match>& result) const;
 
 protected:
     /**
@@ -306,10 +760,363 @@ protected:
     bool setValueHelper(std::string key, T value, bool createIntermediate);
 
     template <typename T>
-    bool getValueHelper(const std::string& key, T& value) const;
+    bool getValueHelper(KeyView key, T& value) const;
 
     template <typename T>
-    bool hasValueHelper(const std::string& key) const;
+    bool hasValueHelper(KeyView key) const;
+
+private:
+    // The binary serializations need to inspect the stored values directly
+    friend class Buffer;
+    friend class MappedDictionary;
+    // The conversion from Lua tables adds the entries of each table directly
+    friend class lua::DictionaryConverter;
+    // The Lua proxies read the entries of each level directly
+    friend class lua::DictionaryProxy;
+    // The schemas decode the entries of a level without looking up their keys again
+    template <typename T>
+    friend class DictionarySchema;
+
+    /**
+     * The closed set of types that are stored inline in an entry. The first three types
+     * are the <code>IntegralType</code>, <code>UnsignedIntegralType</code>, and
+     * <code>FloatingType</code> that all converted types are stored as, the two
+     * <code>std::vector</code>s are the contiguous numeric arrays. All other types are
+     * stored in the <code>boost::any</code>.
+     */
+    typedef boost::variant<long long, unsigned long long, double, std::string, Dictionary,
+                           std::vector<long long>, std::vector<double>,
+                           boost::any> Value;
+
+    /// A single key-value pair of one level of the Dictionary
+    struct Entry;
+
+    /// All entries of one level of the Dictionary together with their index
+    struct Node;
+
+    /**
+     * Returns the entry with the non-nested <code>key</code> of the provided
+     * <code>length</code> and <code>hash</code> from this level of the Dictionary or
+     * <code>nullptr</code> if no such entry exists.
+     * \param key The key of the entry, which does not have to be null-terminated
+     * \param length The number of characters of the <code>key</code>
+     * \param hash The hash value of the key as computed by DictionaryKey::hash
+     * \return The entry for the key or <code>nullptr</code> if it does not exist
+     */
+    const Entry* findEntry(const char* key, size_t length, uint64_t hash) const;
+    Entry* findEntry(const char* key, size_t length, uint64_t hash);
+
+    /**
+     * Stores the <code>value</code> at the non-nested <code>key</code> on this level,
+     * overwriting an existing value with the same key.
+     * \param key The key of the value
+     * \param hash The hash value of the key as computed by DictionaryKey::hash
+     * \param value The value that is stored
+     * \return A reference to the stored value
+     */
+    Value& insertValue(std::string key, uint64_t hash, Value value);
+
+    /**
+     * Adds the <code>value</code> at the non-nested <code>key</code> on this level
+     * without checking whether the <code>key</code> already exists, which it must not.
+     * This level has to be detached already.
+     * \param key The key of the value
+     * \param hash The hash value of the key as computed by DictionaryKey::hash
+     * \param value The value that is stored
+     * \return A reference to the stored value
+     */
+    Value& appendValue(std::string key, uint64_t hash, Value value);
+
+    /// Rebuilds the open-addressing index for the entries on this level
+    void rebuildIndex();
+
+    /**
+     * Follows the, potentially nested, <code>key</code> through the levels of the
+     * Dictionary and returns the value stored at its end or <code>nullptr</code> if the
+     * key does not exist. A key that exists literally on a level takes precedence over
+     * interpreting its separators.
+     * \param key The, potentially nested, key of the value
+     * \param logErrors If <code>true</code>, failures are logged the same way #getValue
+     * logs them
+     * \return The value stored at the key or <code>nullptr</code>
+     */
+    const Value* resolveValue(KeyView key, bool logErrors) const;
+
+    /**
+     * Follows the, potentially nested, <code>key</code> the same way as #resolveValue,
+     * moves the value stored at its end into <code>value</code>, and removes the entry.
+     * All levels along the key are detached.
+     * \param key The, potentially nested, key of the value
+     * \param value The value that the stored value is moved into
+     * \return <code>true</code> if the key existed, <code>false</code> otherwise
+     */
+    bool extractValue(KeyView key, Value& value);
+
+    /// Removes the entry at the <code>position</code> from this level, which has to be
+    /// detached already, and updates the index
+    void eraseEntry(size_t position);
+
+    /**
+     * Follows all but the last segment of the pre-parsed <code>key</code> through the
+     * levels of the Dictionary and returns the Dictionary that contains the last segment
+     * or <code>nullptr</code> if one of the levels does not exist.
+     * \param key The pre-parsed key
+     * \param logErrors If <code>true</code>, failures are logged the same way #getValue
+     * logs them
+     * \return The Dictionary containing the last segment of the key or
+     * <code>nullptr</code>
+     */
+    const Dictionary* resolveParent(const DictionaryKey& key, bool logErrors) const;
+
+    /**
+     * Follows the pre-parsed <code>key</code> through the levels of the Dictionary and
+     * returns the value stored at its end or <code>nullptr</code> if the key does not
+     * exist. In contrast to the <code>std::string</code> keys, each segment, including
+     * the last one, is looked up literally.
+     * \param key The pre-parsed key
+     * \param logErrors If <code>true</code>, failures are logged the same way #getValue
+     * logs them
+     * \return The value stored at the key or <code>nullptr</code>
+     */
+    const Value* resolveValue(const DictionaryKey& key, bool logErrors) const;
+
+    /**
+     * Follows all but the last segment of the pre-parsed <code>key</code> through the
+     * levels of the Dictionary and returns the Dictionary that contains the last segment.
+     * If <code>createIntermediate</code> is <code>true</code>, missing levels are
+     * created, otherwise <code>nullptr</code> is returned for a missing level.
+     */
+    Dictionary* resolveParent(const DictionaryKey& key, bool createIntermediate);
+
+    /**
+     * The non-template part of #setValueHelper that stores the already converted
+     * <code>value</code> at the, potentially nested, <code>key</code>.
+     */
+    bool setValueInternal(std::string key, Value value, bool createIntermediate);
+
+    /// Wraps the <code>value</code> into the closed variant, using the inline
+    /// storage if the type is part of the variant and <code>boost::any</code> otherwise
+    template <typename T>
+    static Value makeValue(T value);
+
+    /// Converts the <code>value</code> into the <code>StorageType</code> in which
+    /// #setValue stores it and wraps it into the closed variant
+    template <typename T>
+    static Value storageValue(T value);
+
+    /// Returns a pointer to the content of type <code>T</code> of the <code>value</code>
+    /// or <code>nullptr</code> if the <code>value</code> does not contain a
+    /// <code>T</code>
+    template <typename T>
+    static const T* valuePointer(const Value& value);
+
+    /// Converts the <code>value</code> into <code>result</code> if it is one of the
+    /// numeric <code>StorageType</code>s and returns <code>false</code> otherwise
+    template <typename T>
+    static bool numericValue(const Value& value, T& result);
+
+    /// Converts the <code>value</code> into <code>result</code> with the same
+    /// conversions as #getValue, but without looking up a key and without logging errors
+    template <typename T>
+    static bool convertValue(const Value& value, T& result);
+
+    /// Returns the type information of the content of <code>value</code>
+    static const std::type_info& valueType(const Value& value);
+
+    /// The categories of values that can be written by the binary serializations
+    enum class SerializedType : uint8_t {
+        Integral = 0,
+        UnsignedIntegral,
+        Floating,
+        String,
+        Dictionary,
+        IntegralArray,
+        FloatingArray,
+        Unsupported
+    };
+
+    /**
+     * Returns the category of the <code>value</code> for the binary serializations. For
+     * the two array categories, either <code>integral</code> or <code>floating</code> is
+     * set to the elements of the array and <code>size</code> to the number of elements.
+     * This includes the contiguous arrays as well as the fixed-size arrays that the glm
+     * types are stored as. Values of all other types that are stored in a
+     * <code>boost::any</code> are <code>Unsupported</code>.
+     */
+    static SerializedType serializedType(const Value& value, const long long*& integral,
+                                         const double*& floating, size_t& size);
+
+    /// Ensures that #_node exists and is not shared with another Dictionary, so that it
+    /// can be modified, and invalidates its cached hash. All modifications of this level
+    /// have to call this method first
+    void detach();
+
+    /// Returns the structural hash of a single <code>value</code>
+    static uint64_t hashValue(const Value& value);
+
+    /// Returns <code>true</code> if this level or any nested level contains a value
+    /// whose contents are not part of the #hash, so that equal hashes do not imply equal
+    /// contents
+    bool hasUnsupportedValues() const;
+
+    /// Adds the memory usage of this Dictionary to <code>usage</code>, counting only the
+    /// nodes that are not already in <code>visited</code> as distinct. If
+    /// <code>isShared</code> is <code>true</code>, a parent level is shared
+    void accumulateMemoryUsage(MemoryUsage& usage,
+                               std::unordered_set<const Node*>& visited,
+                               bool isShared) const;
+
+    /// Appends the differences between this Dictionary and <code>other</code> to
+    /// <code>result</code>, prefixing all keys with the segments in <code>path</code>
+    void diff(const Dictionary& other, std::vector<std::string>& path,
+              ChangeSet& result) const;
+
+    /// Returns <code>true</code> if both values are known to be equal
+    static bool isEqual(const Value& lhs, const Value& rhs);
+
+    /// The position of a #query in one of its patterns: the index of the pattern and the
+    /// index of the segment that the keys of a level are compared against
+    struct QueryState {
+        uint32_t pattern;
+        uint32_t segment;
+    };
+
+    /// Adds the matches of the <code>states</code> in this level to <code>result</code>
+    /// and descends into the nested levels; <code>prefix</code> is the key of this level
+    void query(const std::vector<DictionaryKey>& patterns,
+               const std::vector<QueryState>& states, const std::string& prefix,
+               std::vector<Match>& result) const;
+
+    /// Returns a copy of this Dictionary that is laid out compactly. Nodes that are
+    /// already in <code>nodes</code> are reused, new nodes are added to it
+    Dictionary compactedCopy(
+        std::unordered_map<const Node*, std::shared_ptr<Node>>& nodes) const;
+
+    /// The, potentially shared, entries of this level or <code>nullptr</code> if this
+    /// Dictionary has never contained a value
+    std::shared_ptr<Node> _node;
+};
+
+struct Dictionary::ChangeSet {
+    /**
+     * Returns <code>true</code> if the, potentially nested, <code>key</code> is
+     * affected by any of the #changes, that is, if the <code>key</code> itself, any of
+     * its parents, or any of the keys nested inside it was added, removed, or modified.
+     * The empty <code>key</code> refers to the whole Dictionary.
+     * \param key The, potentially nested, key that is tested
+     * \return <code>true</code> if the <code>key</code> is affected by the changes
+     */
+    bool affects(const std::string& key) const;
+
+    /**
+     * Returns <code>true</code> if there are no #changes.
+     * \return <code>true</code> if there are no #changes
+     */
+    bool empty() const;
+
+    /// The changes in the order in which they were found
+    std::vector<Change> changes;
+
+    /// The new values of all added and modified keys, stored at the Change::path of
+    /// their changes
+    Dictionary values;
+};
+
+struct Dictionary::Match {
+    /**
+     * Returns a pointer to the value if it is stored as the type <code>T</code> without
+     * searching for it again. See Dictionary::valuePtr for more information.
+     * \tparam T The type of the value
+     * \return A pointer to the value or <code>nullptr</code> if it is not stored as the
+     * type <code>T</code>
+     */
+    template <typename T>
+    const T* valuePtr() const;
+
+    /**
+     * Converts the value into the type <code>T</code> without searching for it again.
+     * See Dictionary::getValue for more information.
+     * \tparam T The type of the value
+     * \param value The value that is set if the conversion was successful
+     * \return <code>true</code> if the value was retrieved successfully
+     */
+    template <typename T>
+    bool getValue(T& value) const;
+
+    /// The full, nested key of the value
+    std::string key;
+
+    /// The Dictionary that directly contains the value. The pointer, and the value, are
+    /// only valid as long as the queried Dictionary is not modified or destroyed
+    const Dictionary* parent;
+
+private:
+    friend class Dictionary;
+
+    /// The matched value in #parent
+    const Value* _value;
+};
+
+struct Dictionary::Entry {
+    /// Returns the key of this entry, regardless of whether it is interned or not
+    const std::string& key() const {
+        return (internedKey != nullptr) ? *internedKey : ownKey;
+    }
+
+    /// Returns <code>true</code> if this entry has the <code>key</code> of the provided
+    /// <code>length</code> and <code>hash</code>
+    bool matches(const char* key, size_t length, uint64_t hash) const {
+        if (this->hash != hash)
+            return false;
+        // Interned keys are usually looked up with their own characters
+        const std::string& k = this->key();
+        return (k.data() == key && k.size() == length) ||
+               (k.compare(0, std::string::npos, key, length) == 0);
+    }
+
+    /// The key of this entry if it is not interned, empty otherwise
+    std::string ownKey;
+    /// The key of this entry in the intern table or <code>nullptr</code>
+    const std::string* internedKey;
+    uint64_t hash;
+    Value value;
+};
+
+struct Dictionary::Node {
+    typedef std::vector<Entry, ArenaAllocator<Entry>> Entries;
+    typedef std::vector<uint32_t, ArenaAllocator<uint32_t>> Index;
+
+    explicit Node(const ArenaAllocator<Node>& allocator = ArenaAllocator<Node>())
+        : entries(allocator)
+        , index(allocator)
+        , hash(0)
+        , hasUnsupportedValues(false)
+    {}
+
+    Node(const Node& other)
+        : entries(other.entries)
+        , index(other.index)
+        , hash(other.hash.load(std::memory_order_acquire))
+        , hasUnsupportedValues(
+              other.hasUnsupportedValues.load(std::memory_order_relaxed)
+          )
+    {}
+
+    /// All entries of this level in insertion order
+    Entries entries;
+
+    /// The open-addressing index into #entries (storing the position + 1) or empty if
+    /// there are few enough entries to search them linearly
+    Index index;
+
+    /// The cached structural hash of this level or 0 if it has not been computed since
+    /// the last modification
+    mutable std::atomic<uint64_t> hash;
+
+    /// Whether this level or any nested level contains a value that cannot be compared
+    /// (see Dictionary::isEqual). This is computed together with #hash and only valid if
+    /// #hash is not 0
+    mutable std::atomic<bool> hasUnsupportedValues;
 };
 
 }  // namespace ghoul
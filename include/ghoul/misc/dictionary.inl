@@ -37,146 +37,320 @@
 
 #include <ghoul/logging/logmanager.h>
 
+#include <type_traits>
+
 namespace ghoul {
 
 template <typename T>
-bool ghoul::Dictionary::setValueHelper(std::string key, T value,
-                                       bool createIntermediate) {
-    std::string first;
-    std::string rest;
-    const bool hasRestPath = splitKey(key, first, rest);
-    if (!hasRestPath) {
-        // if no rest exists, key == first and we can just insert the value
-        (*this)[key] = std::move(value);
-        return true;
-    }
+Dictionary::Value Dictionary::makeValue(T value) {
+    return Value(boost::any(std::move(value)));
+}
 
-    // if we get to this point, the 'key' did contain a nested key
-    // so we have to find the correct Dictionary (or create it if it doesn't exist)
-    std::map<std::string, boost::any>::iterator keyIt = find(first);
-    if (keyIt == cend()) {
-        // didn't find the Dictionary
-        if (createIntermediate) {
-            ghoul::Dictionary intermediate;
-            (*this)[first] = intermediate;
-            keyIt = find(first);
-        }
-        else {
-            LERRORC("Dictionary", "Key '" << first << "' was not found in dictionary");
-            return false;
-        }
-    }
+template <>
+inline Dictionary::Value Dictionary::makeValue<long long>(long long value) {
+    return Value(value);
+}
 
-    // See if it is actually a Dictionary at this location
-    Dictionary* const dict = boost::any_cast<Dictionary>(&(keyIt->second));
-    if (dict == nullptr) {
-        LERRORC("Dictionary", "Error converting key '"
-            << first << "' to type 'Dictionary', was '"
-            << keyIt->second.type().name() << "'");
-        return false;
-    }
-    // Proper tail-recursion
-    return dict->setValue(rest, std::move(value), createIntermediate);
+template <>
+inline Dictionary::Value Dictionary::makeValue<unsigned long long>(
+                                                                unsigned long long value)
+{
+    return Value(value);
+}
+
+template <>
+inline Dictionary::Value Dictionary::makeValue<double>(double value) {
+    return Value(value);
+}
+
+template <>
+inline Dictionary::Value Dictionary::makeValue<std::string>(std::string value) {
+    return Value(std::move(value));
 }
 
+template <>
+inline Dictionary::Value Dictionary::makeValue<Dictionary>(Dictionary value) {
+    return Value(std::move(value));
+}
+
+template <>
+inline Dictionary::Value Dictionary::makeValue<std::vector<long long>>(
+                                                            std::vector<long long> value)
+{
+    return Value(std::move(value));
+}
+
+template <>
+inline Dictionary::Value Dictionary::makeValue<std::vector<double>>(
+                                                               std::vector<double> value)
+{
+    return Value(std::move(value));
+}
+
+template <>
+Dictionary::Value Dictionary::makeValue<boost::any>(boost::any value);
+
 template <typename T>
-bool Dictionary::setValue(std::string key, T value, bool createIntermediate) {
-    return setValueHelper(std::move(key), std::move(value), createIntermediate);
+Dictionary::Value Dictionary::storageValue(T value) {
+    return makeValue(std::move(value));
+}
+
+template <typename T>
+const T* Dictionary::valuePointer(const Value& value) {
+    const boost::any* const any = boost::get<boost::any>(&value);
+    return (any != nullptr) ? boost::any_cast<T>(any) : nullptr;
 }
 
+template <>
+inline const long long* Dictionary::valuePointer<long long>(const Value& value) {
+    return boost::get<long long>(&value);
+}
+
+template <>
+inline const unsigned long long* Dictionary::valuePointer<unsigned long long>(
+                                                                  const Value& value)
+{
+    return boost::get<unsigned long long>(&value);
+}
+
+template <>
+inline const double* Dictionary::valuePointer<double>(const Value& value) {
+    return boost::get<double>(&value);
+}
+
+template <>
+inline const std::string* Dictionary::valuePointer<std::string>(const Value& value) {
+    return boost::get<std::string>(&value);
+}
+
+template <>
+inline const Dictionary* Dictionary::valuePointer<Dictionary>(const Value& value) {
+    return boost::get<Dictionary>(&value);
+}
+
+template <>
+inline const std::vector<long long>* Dictionary::valuePointer<std::vector<long long>>(
+                                                                      const Value& value)
+{
+    return boost::get<std::vector<long long>>(&value);
+}
+
+template <>
+inline const std::vector<double>* Dictionary::valuePointer<std::vector<double>>(
+                                                                      const Value& value)
+{
+    return boost::get<std::vector<double>>(&value);
+}
 
 template <typename T>
-bool ghoul::Dictionary::getValueHelper(const std::string& key, T& value) const {
-    // If we can find the key directly, we can return it immediately
-    const std::map<std::string, boost::any>::const_iterator it = find(key);
-    if (it != cend()) {
-        const T* const v = boost::any_cast<T>(&(it->second));
-        // See if it has the correct type
-        if (v == nullptr) {
-            LERRORC("Dictionary", "Wrong type of key '"
-                << key << "': Expected '" << typeid(T).name()
-                << "', got '" << it->second.type().name() << "'");
-            return false;
-        }
-        value = *v;
-        return true;
-    }
+bool ghoul::Dictionary::setValueHelper(std::string key, T value,
+                                       bool createIntermediate) {
+    return setValueInternal(std::move(key), makeValue(std::move(value)),
+                            createIntermediate);
+}
 
-    // if we get to this point, the 'key' did contain a nested key
-    // so we have to find the correct Dictionary (or create it if it doesn't exist)
-    std::string first;
-    std::string rest;
-    splitKey(key, first, rest);
+template <typename T>
+bool Dictionary::setValue(std::string key, T value, bool createIntermediate) {
+    return setValueHelper(std::move(key), std::move(value), createIntermediate);
+}
 
-    const std::map<std::string, boost::any>::const_iterator keyIt = find(first);
-    if (keyIt == cend()) {
-#ifdef GHL_DEBUG
-		LERRORC("Dictionary", "Could not find key '" << first << "' in Dictionary");
-#endif
+
+template <typename T>
+bool ghoul::Dictionary::getValueHelper(KeyView key, T& value) const {
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
         return false;
-	}
-
-    const Dictionary* const dict = boost::any_cast<Dictionary>(&(keyIt->second));
-    // See if it is actually a Dictionary at this location
-    if (dict == nullptr) {
-        LERRORC("Dictionary", "Error converting key '"
-            << first << "' to type 'Dictionary', was '"
-            << keyIt->second.type().name() << "'");
+
+    const T* const typedValue = valuePointer<T>(*v);
+    // See if it has the correct type
+    if (typedValue == nullptr) {
+        LERRORC("Dictionary", "Wrong type of key '"
+            << key << "': Expected '" << typeid(T).name()
+            << "', got '" << valueType(*v).name() << "'");
         return false;
     }
-    // Proper tail-recursion
-    return dict->getValue<T>(rest, value);
+    value = *typedValue;
+    return true;
 }
 
 template <typename T>
-bool Dictionary::getValue(const std::string& key, T& value) const {
+bool Dictionary::getValue(KeyView key, T& value) const {
     return getValueHelper(key, value);
 }
 
 template <typename T>
-T ghoul::Dictionary::value(const std::string& key) const {
+T ghoul::Dictionary::value(KeyView key) const {
 	T value;
 	getValueHelper(key, value);
 	return value;
 }
 
 template <typename T>
-bool ghoul::Dictionary::hasValueHelper(const std::string& key) const {
-    const std::map<std::string, boost::any>::const_iterator it = find(key);
-    if (it != cend()) {
-        // If we can find the key directly, we can check the types and return
-        const bool typeCorrect = (it->second.type() == typeid(T));
-        return typeCorrect;
-    }
+bool ghoul::Dictionary::hasValueHelper(KeyView key) const {
+    return valuePtr<T>(key) != nullptr;
+}
 
-    std::string first;
-    std::string rest;
-    splitKey(key, first, rest);
+template <typename T>
+bool Dictionary::hasValue(KeyView key) const {
+    return hasValueHelper<T>(key);
+}
+    
+template <typename T>
+bool Dictionary::hasKeyAndValue(KeyView key) const {
+    // Short-circuit evaluation is used to guard the 'hasValue' function from non-existing
+    // keys
+    return (hasKey(key) && hasValue<T>(key));
+}
 
-    const std::map<std::string, boost::any>::const_iterator keyIt = find(first);
-    if (keyIt == cend())
-        // If we can't find the first part of nested key, there is no need to continue
+template <typename T>
+bool Dictionary::takeValue(KeyView key, T& value) {
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
         return false;
 
-    const Dictionary* const dict = boost::any_cast<Dictionary>(&(keyIt->second));
+    Value removed;
+    if (valuePointer<T>(*v) == nullptr) {
+        // The value has to be converted, so there is nothing that could be moved
+        return getValue(key, value) && extractValue(key, removed);
+    }
+    extractValue(key, removed);
+    // 'removed' is not used afterwards, so its content can be moved from
+    value = std::move(*const_cast<T*>(valuePointer<T>(removed)));
+    return true;
+}
+
+template <typename T, typename... Args>
+bool Dictionary::emplaceValue(std::string key, Args&&... args) {
+    return setValue(std::move(key), T(std::forward<Args>(args)...), true);
+}
+
+template <typename T>
+bool Dictionary::setValue(const DictionaryKey& key, T value, bool createIntermediate) {
+    Dictionary* const dict = resolveParent(key, createIntermediate);
     if (dict == nullptr)
-        // If it is not a Dictionary, the value can't be found and no recursion necessary
         return false;
+    // The last segment is stored literally as it might contain separators
+    const size_t last = key.nSegments() - 1;
+    dict->insertValue(
+        key.segment(last), key.segmentHash(last), storageValue(std::move(value))
+    );
+    return true;
+}
 
-    // Proper tail-recursion
-    return dict->hasValue<T>(rest);
+template <typename T>
+bool Dictionary::getValue(const DictionaryKey& key, T& value) const {
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
+        return false;
+    if (!convertValue(*v, value)) {
+        LERRORC("Dictionary", "Wrong type of key '"
+            << key.key() << "': Expected '" << typeid(T).name()
+            << "', got '" << valueType(*v).name() << "'");
+        return false;
+    }
+    return true;
 }
 
 template <typename T>
-bool Dictionary::hasValue(const std::string& key) const {
-    return hasValueHelper<T>(key);
+T Dictionary::value(const DictionaryKey& key) const {
+    T value = T();
+    getValue(key, value);
+    return value;
 }
-    
+
 template <typename T>
-bool Dictionary::hasKeyAndValue(const std::string& key) const {
-    // Short-circuit evaluation is used to guard the 'hasValue' function from non-existing
-    // keys
-    return (hasKey(key) && hasValue<T>(key));
+bool Dictionary::hasValue(const DictionaryKey& key) const {
+    const Value* const v = resolveValue(key, false);
+    T value;
+    return (v != nullptr) && convertValue(*v, value);
+}
+
+template <typename T>
+bool Dictionary::hasKeyAndValue(const DictionaryKey& key) const {
+    return hasValue<T>(key);
+}
+
+template <typename T>
+const T* Dictionary::valuePtr(KeyView key) const {
+    const Value* const v = resolveValue(key, false);
+    return (v != nullptr) ? valuePointer<T>(*v) : nullptr;
+}
+
+template <typename T>
+const T* Dictionary::valuePtr(const DictionaryKey& key) const {
+    const Value* const v = resolveValue(key, false);
+    return (v != nullptr) ? valuePointer<T>(*v) : nullptr;
+}
+
+template <typename T>
+bool Dictionary::numericValue(const Value& value, T& result) {
+    if (const double* const v = boost::get<double>(&value))
+        result = static_cast<T>(*v);
+    else if (const long long* const v = boost::get<long long>(&value))
+        result = static_cast<T>(*v);
+    else if (const unsigned long long* const v = boost::get<unsigned long long>(&value))
+        result = static_cast<T>(*v);
+    else
+        return false;
+    return true;
+}
+
+template <typename T>
+bool Dictionary::getArray(KeyView key, std::vector<T>& values) const {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "getArray only supports numeric types");
+
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
+        return false;
+
+    if (const std::vector<double>* const a = boost::get<std::vector<double>>(v)) {
+        values.resize(a->size());
+        for (size_t i = 0; i < a->size(); ++i)
+            values[i] = static_cast<T>((*a)[i]);
+        return true;
+    }
+    if (const std::vector<long long>* const a = boost::get<std::vector<long long>>(v)) {
+        values.resize(a->size());
+        for (size_t i = 0; i < a->size(); ++i)
+            values[i] = static_cast<T>((*a)[i]);
+        return true;
+    }
+    if (const Dictionary* const dict = boost::get<Dictionary>(v)) {
+        std::vector<T> result(dict->size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            const Value* const e = dict->resolveValue(std::to_string(i + 1), true);
+            if ((e == nullptr) || !numericValue(*e, result[i]))
+                return false;
+        }
+        values = std::move(result);
+        return true;
+    }
+
+    LERRORC("Dictionary", "Wrong type of key '"
+        << key << "': Expected '" << typeid(std::vector<T>).name()
+        << "', got '" << valueType(*v).name() << "'");
+    return false;
+}
+
+template <typename T>
+bool Dictionary::convertValue(const Value& value, T& result) {
+    const T* const v = valuePointer<T>(value);
+    if (v == nullptr)
+        return false;
+    result = *v;
+    return true;
+}
+
+template <typename Visitor>
+void Dictionary::forEach(Visitor visitor) const {
+    if (!_node)
+        return;
+
+    for (const Entry& e : _node->entries) {
+        const Dictionary* const dictionary = boost::get<Dictionary>(&e.value);
+        visitor(e.key(), dictionary);
+    }
 }
 
 // Make template definitions so that the compiler won't try to instantiate each
@@ -188,9 +362,10 @@ bool Dictionary::hasKeyAndValue(const std::string& key) const {
 #define DEF_EXT_TEMPLATES(TYPE)                                                          \
     template<> bool Dictionary::setValue<TYPE>(std::string key, TYPE value,         \
                                                     bool createIntermediate);            \
-    template<> bool Dictionary::getValue<TYPE>(const std::string& key, TYPE& value) \
-          const;                                                                         \
-    template<> bool Dictionary::hasValue<TYPE>(const std::string& key) const
+    template<> bool Dictionary::getValue<TYPE>(KeyView key, TYPE& value) const;          \
+    template<> bool Dictionary::hasValue<TYPE>(KeyView key) const;                       \
+    template<> bool Dictionary::convertValue<TYPE>(const Value& value, TYPE& result);    \
+    template<> Dictionary::Value Dictionary::storageValue<TYPE>(TYPE value)
 
 DEF_EXT_TEMPLATES(bool);
 DEF_EXT_TEMPLATES(char);
@@ -242,6 +417,16 @@ DEF_EXT_TEMPLATES(glm::dmat4x4);
 #undef DEF_EXT_TEMPLATES
 
 template<>
-bool Dictionary::getValue<Dictionary>(const std::string& key, Dictionary& value) const;
+bool Dictionary::getValue<Dictionary>(KeyView key, Dictionary& value) const;
+
+template <typename T>
+const T* Dictionary::Match::valuePtr() const {
+    return valuePointer<T>(*_value);
+}
+
+template <typename T>
+bool Dictionary::Match::getValue(T& value) const {
+    return Dictionary::convertValue(*_value, value);
+}
 
 } // namespace ghoul
@@ -0,0 +1,121 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __DICTIONARYKEY_H__
+#define __DICTIONARYKEY_H__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * A DictionaryKey is a, potentially nested, key into a Dictionary that is split into its
+ * individual segments only once at construction. Each segment is stored together with
+ * its precomputed hash value, so that a DictionaryKey can be reused for any number of
+ * lookups into any number of Dictionaries without splitting the key or allocating memory
+ * again. A DictionaryKey is meant for keys that are accessed repeatedly, for example in a
+ * per-frame loop:
+ * \verbatim
+const DictionaryKey RadiusKey("Renderable.Geometry.Radius");
+[...]
+double radius;
+dictionary.getValue(RadiusKey, radius);
+\endverbatim
+ * In contrast to the <code>std::string</code> keys, a DictionaryKey is always interpreted
+ * segment by segment; a key that contains a literal <code>.</code> on one level of a
+ * Dictionary can only be accessed through a DictionaryKey that is created from its
+ * segments.
+ */
+class DictionaryKey {
+public:
+    /**
+     * Creates a DictionaryKey by splitting the provided <code>key</code> at each
+     * <code>.</code> separator.
+     * \param key The, potentially nested, key that is represented by this object
+     */
+    explicit DictionaryKey(std::string key);
+
+    /**
+     * Creates a DictionaryKey from its individual <code>segments</code>, which are not
+     * split any further and thus may contain a literal <code>.</code>. The full #key is
+     * the <code>segments</code> joined by <code>.</code> separators. At least one
+     * segment has to be provided.
+     * \param segments The segments of the key from the outermost to the innermost level
+     */
+    explicit DictionaryKey(std::vector<std::string> segments);
+
+    /**
+     * Returns the full key that was used to create this DictionaryKey.
+     * \return The full key that was used to create this DictionaryKey
+     */
+    const std::string& key() const;
+
+    /**
+     * Returns the number of segments of this key. A non-nested key has exactly one
+     * segment.
+     * \return The number of segments of this key
+     */
+    size_t nSegments() const;
+
+    /**
+     * Returns the segment with the <code>index</code>. The <code>index</code> has to be
+     * smaller than #nSegments.
+     * \param index The index of the segment
+     * \return The segment with the <code>index</code>
+     */
+    const std::string& segment(size_t index) const;
+
+    /**
+     * Returns the precomputed hash value of the segment with the <code>index</code>. The
+     * <code>index</code> has to be smaller than #nSegments.
+     * \param index The index of the segment
+     * \return The hash value of the segment with the <code>index</code>
+     */
+    uint64_t segmentHash(size_t index) const;
+
+    /**
+     * Returns the hash value for the <code>length</code> first characters of
+     * <code>key</code>. This is the hash function that the Dictionary uses for finding
+     * its entries.
+     * \param key The key that should be hashed
+     * \param length The number of characters of the <code>key</code>
+     * \return The hash value for the key
+     */
+    static uint64_t hash(const char* key, size_t length);
+
+private:
+    /// The full key
+    std::string _key;
+    /// The segments of the key
+    std::vector<std::string> _segments;
+    /// The hash values for each of the <code>_segments</code>
+    std::vector<uint64_t> _hashes;
+};
+
+} // namespace ghoul
+
+#endif // __DICTIONARYKEY_H__
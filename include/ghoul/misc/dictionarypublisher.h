@@ -0,0 +1,89 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __DICTIONARYPUBLISHER_H__
+#define __DICTIONARYPUBLISHER_H__
+
+#include <ghoul/misc/dictionary.h>
+
+#include <memory>
+#include <mutex>
+
+namespace ghoul {
+
+/**
+ * The DictionaryPublisher holds the current immutable snapshot of a Dictionary (see
+ * Dictionary::freeze) and passes it from the thread that creates it to any number of
+ * reading threads. A writer creates a new snapshot and calls #publish, readers call
+ * #acquire to retrieve the most recent snapshot. Both operations only exchange a
+ * reference-counted pointer, so publishing never copies the Dictionary. They are not
+ * lock-free, but hold a lock that is private to the DictionaryPublisher just for the
+ * pointer exchange, so neither waits for the other to use or destroy a snapshot. A reader
+ * keeps using the snapshot it acquired until it releases it, even if a newer snapshot
+ * has been published in the meantime; the old snapshot is destroyed once the last reader
+ * has released it.
+ * \verbatim
+// Reload thread
+publisher.publish(dictionary.freeze());
+
+// Any reader thread
+std::shared_ptr<const Dictionary> configuration = publisher.acquire();
+\endverbatim
+ */
+class DictionaryPublisher {
+public:
+    /// The type of the immutable snapshots that are published
+    typedef std::shared_ptr<const Dictionary> Snapshot;
+
+    /**
+     * Creates a DictionaryPublisher that initially holds the <code>snapshot</code>.
+     * \param snapshot The snapshot that is initially returned by #acquire
+     */
+    explicit DictionaryPublisher(Snapshot snapshot = Snapshot());
+
+    /**
+     * Replaces the current snapshot with the <code>snapshot</code>. All subsequent calls
+     * to #acquire will return the new snapshot. This method is thread-safe.
+     * \param snapshot The snapshot that is published
+     */
+    void publish(Snapshot snapshot);
+
+    /**
+     * Returns the most recently published snapshot, or <code>nullptr</code> if no
+     * snapshot has been published yet. This method is thread-safe.
+     * \return The most recently published snapshot
+     */
+    Snapshot acquire() const;
+
+private:
+    /// The current snapshot, which is only accessed while holding the #_mutex
+    Snapshot _snapshot;
+    /// Protects the exchange of the #_snapshot pointer
+    mutable std::mutex _mutex;
+};
+
+} // namespace ghoul
+
+#endif // __DICTIONARYPUBLISHER_H__
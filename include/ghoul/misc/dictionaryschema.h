@@ -0,0 +1,176 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __DICTIONARYSCHEMA_H__
+#define __DICTIONARYSCHEMA_H__
+
+#include <ghoul/misc/dictionary.h>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * A DictionarySchema binds the keys of a Dictionary to the members of a struct or class
+ * <code>T</code>, so that a Dictionary can be decoded into an object of type
+ * <code>T</code> and an object can be encoded back into a Dictionary. The binding is
+ * declared once using #field, which fixes the type of each value at compile time through
+ * the type of the member:
+ * \verbatim
+struct AttributePointer {
+    int size = 0;
+    std::string type = "GL_FLOAT";
+};
+
+ghoul::DictionarySchema<AttributePointer> schema;
+schema.field("Size", &AttributePointer::size)
+      .field("Type", &AttributePointer::type, true);
+
+AttributePointer pointer;
+std::vector<std::string> errors;
+if (!schema.decode(dictionary, pointer, errors))
+    ...
+\endverbatim
+ * In contrast to a sequence of Dictionary::hasKey and Dictionary::getValue calls, #decode
+ * visits each entry of the Dictionary only once, finds the bound member through the
+ * precomputed hash of the key, converts the stored value without looking it up again,
+ * and does not log errors for individual values. Instead,
+ * all missing required keys and all values that have the wrong type are collected and
+ * returned together. Nested structs can be bound with a nested DictionarySchema.
+ * \tparam T The type of the objects that are decoded and encoded
+ */
+template <typename T>
+class DictionarySchema {
+public:
+    /**
+     * Binds the non-nested <code>key</code> to the <code>member</code> of
+     * <code>T</code>. The value stored at the <code>key</code> is retrieved using
+     * Dictionary::getValue for the type <code>U</code> and thus supports the same
+     * conversions.
+     * \tparam U The type of the member
+     * \param key The non-nested key that is bound to the <code>member</code>
+     * \param member The member of <code>T</code> that is bound to the <code>key</code>
+     * \param isOptional If <code>true</code>, a missing <code>key</code> is not an error
+     * and leaves the <code>member</code> unchanged
+     * \return A reference to this schema to allow chaining calls
+     */
+    template <typename U>
+    DictionarySchema& field(std::string key, U T::* member,
+                            bool isOptional = false);
+
+    /**
+     * Binds the non-nested <code>key</code>, which has to contain a Dictionary, to the
+     * <code>member</code> of <code>T</code>, which is decoded and encoded using the
+     * <code>schema</code>. The <code>schema</code> is copied.
+     * \tparam U The type of the member
+     * \param key The non-nested key that is bound to the <code>member</code>
+     * \param member The member of <code>T</code> that is bound to the <code>key</code>
+     * \param schema The schema that is used to decode and encode the <code>member</code>
+     * \param isOptional If <code>true</code>, a missing <code>key</code> is not an error
+     * and leaves the <code>member</code> unchanged
+     * \return A reference to this schema to allow chaining calls
+     */
+    template <typename U>
+    DictionarySchema& field(std::string key, U T::* member,
+                            const DictionarySchema<U>& schema,
+                            bool isOptional = false);
+
+    /**
+     * Decodes the <code>dictionary</code> into the <code>object</code> in a single pass
+     * over the <code>dictionary</code>. Keys that are not bound by this schema are
+     * ignored and members whose keys are missing are left unchanged. Decoding continues
+     * after an error so that all errors are reported at once; the members of the
+     * <code>object</code> that could be decoded are set in either case.
+     * \param dictionary The Dictionary that is decoded
+     * \param object The object whose members are set
+     * \param errors A description of each error is appended to this list
+     * \return <code>true</code> if all required keys were present and all values had
+     * the correct types, <code>false</code> otherwise
+     */
+    bool decode(const Dictionary& dictionary, T& object,
+                std::vector<std::string>& errors) const;
+
+    /**
+     * Decodes the <code>dictionary</code> into the <code>object</code> and logs all
+     * errors in a single message with the <code>category</code>. See #decode for more
+     * information.
+     * \param dictionary The Dictionary that is decoded
+     * \param object The object whose members are set
+     * \param category The logging category that is used for the errors
+     * \return <code>true</code> if all required keys were present and all values had
+     * the correct types, <code>false</code> otherwise
+     */
+    bool decode(const Dictionary& dictionary, T& object,
+                const std::string& category = "DictionarySchema") const;
+
+    /**
+     * Stores all bound members of the <code>object</code> in the
+     * <code>dictionary</code>, overwriting existing values with the same keys.
+     * \param object The object that is encoded
+     * \param dictionary The Dictionary in which the members are stored
+     */
+    void encode(const T& object, Dictionary& dictionary) const;
+
+private:
+    /// A single binding between a key and a member
+    struct Field {
+        std::string key;
+        uint64_t hash;
+        bool isOptional;
+        /// Converts the value that is stored at <code>key</code> into the member of the
+        /// object. Errors are appended with the provided prefix
+        std::function<bool(const Dictionary::Value&, T&, const std::string&,
+                           std::vector<std::string>&)> decode;
+        /// Stores the member in the Dictionary at <code>key</code>
+        std::function<void(const T&, Dictionary&)> encode;
+    };
+
+    /// Adds a binding and checks that the key is valid and not bound twice
+    void addField(Field field);
+
+    /**
+     * Decodes the <code>dictionary</code> into the <code>object</code> and prefixes the
+     * keys in error messages with <code>prefix</code>, which is used for the nested
+     * schemas.
+     */
+    bool decode(const Dictionary& dictionary, T& object, const std::string& prefix,
+                std::vector<std::string>& errors) const;
+
+    template <typename U>
+    friend class DictionarySchema;
+
+    std::vector<Field> _fields;
+    /// Maps the hash of each bound key to the index of its Field in #_fields
+    std::unordered_multimap<uint64_t, size_t> _fieldIndex;
+};
+
+} // namespace ghoul
+
+#include "dictionaryschema.inl"
+
+#endif // __DICTIONARYSCHEMA_H__
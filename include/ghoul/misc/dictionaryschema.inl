@@ -0,0 +1,164 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <typeinfo>
+
+namespace ghoul {
+
+template <typename T>
+template <typename U>
+DictionarySchema<T>& DictionarySchema<T>::field(std::string key, U T::* member,
+                                                bool isOptional)
+{
+    Field f;
+    f.hash = DictionaryKey::hash(key.data(), key.size());
+    f.isOptional = isOptional;
+    f.decode = [key, member](const Dictionary::Value& value, T& object,
+                             const std::string& prefix, std::vector<std::string>& errors)
+    {
+        // The key is known to exist, so a failure can only be caused by the type
+        if (!Dictionary::convertValue(value, object.*member)) {
+            errors.push_back("Key '" + prefix + key + "' does not have the type '" +
+                             typeid(U).name() + "'");
+            return false;
+        }
+        return true;
+    };
+    f.encode = [key, member](const T& object, Dictionary& dictionary) {
+        dictionary.setValue(key, object.*member);
+    };
+    f.key = std::move(key);
+    addField(std::move(f));
+    return *this;
+}
+
+template <typename T>
+template <typename U>
+DictionarySchema<T>& DictionarySchema<T>::field(std::string key, U T::* member,
+                                                const DictionarySchema<U>& schema,
+                                                bool isOptional)
+{
+    Field f;
+    f.hash = DictionaryKey::hash(key.data(), key.size());
+    f.isOptional = isOptional;
+    f.decode = [key, member, schema](const Dictionary::Value& value, T& object,
+                                     const std::string& prefix,
+                                     std::vector<std::string>& errors)
+    {
+        const Dictionary* const nested = Dictionary::valuePointer<Dictionary>(value);
+        if (nested == nullptr) {
+            errors.push_back("Key '" + prefix + key + "' is not a Dictionary");
+            return false;
+        }
+        return schema.decode(*nested, object.*member, prefix + key + ".", errors);
+    };
+    f.encode = [key, member, schema](const T& object, Dictionary& dictionary) {
+        Dictionary nested;
+        schema.encode(object.*member, nested);
+        dictionary.setValue(key, std::move(nested));
+    };
+    f.key = std::move(key);
+    addField(std::move(f));
+    return *this;
+}
+
+template <typename T>
+bool DictionarySchema<T>::decode(const Dictionary& dictionary, T& object,
+                                 std::vector<std::string>& errors) const
+{
+    return decode(dictionary, object, "", errors);
+}
+
+template <typename T>
+bool DictionarySchema<T>::decode(const Dictionary& dictionary, T& object,
+                                 const std::string& category) const
+{
+    std::vector<std::string> errors;
+    const bool success = decode(dictionary, object, "", errors);
+    if (!success) {
+        std::string message;
+        for (const std::string& e : errors)
+            message += "\n" + e;
+        LERRORC(category, "Error decoding Dictionary:" << message);
+    }
+    return success;
+}
+
+template <typename T>
+bool DictionarySchema<T>::decode(const Dictionary& dictionary, T& object,
+                                 const std::string& prefix,
+                                 std::vector<std::string>& errors) const
+{
+    const size_t nErrors = errors.size();
+    std::vector<bool> found(_fields.size(), false);
+
+    // Visit each entry of the dictionary once and dispatch its value to the bound field
+    // using the hash that is stored with the entry
+    if (dictionary._node) {
+        for (const Dictionary::Entry& e : dictionary._node->entries) {
+            const auto range = _fieldIndex.equal_range(e.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                const Field& f = _fields[it->second];
+                if (f.key == e.key()) {
+                    found[it->second] = true;
+                    f.decode(e.value, object, prefix, errors);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        if (!found[i] && !_fields[i].isOptional)
+            errors.push_back("Required key '" + prefix + _fields[i].key + "' is missing");
+    }
+    return errors.size() == nErrors;
+}
+
+template <typename T>
+void DictionarySchema<T>::encode(const T& object, Dictionary& dictionary) const {
+    for (const Field& f : _fields)
+        f.encode(object, dictionary);
+}
+
+template <typename T>
+void DictionarySchema<T>::addField(Field field) {
+    ghoul_assert(field.key.find('.') == std::string::npos,
+                 "Key '" << field.key << "' must not be nested");
+    ghoul_assert(
+        std::none_of(_fields.begin(), _fields.end(),
+            [&field](const Field& f) { return f.key == field.key; }
+        ),
+        "Key '" << field.key << "' is bound more than once"
+    );
+    _fieldIndex.emplace(field.hash, _fields.size());
+    _fields.push_back(std::move(field));
+}
+
+} // namespace ghoul
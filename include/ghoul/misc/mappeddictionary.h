@@ -0,0 +1,233 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MAPPEDDICTIONARY_H__
+#define __MAPPEDDICTIONARY_H__
+
+#include <ghoul/misc/dictionary.h>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * A MappedDictionary provides read-only access to a Dictionary that has been written to
+ * a file with #write without reading the whole file. The file is mapped into the address
+ * space of the process and each query only touches the parts of the file that lie on the
+ * path to the requested key, so that the operating system never has to page in subtrees
+ * that are not accessed. Parts of the file, or the whole file, can be turned back into a
+ * Dictionary using the #getValue method for a Dictionary.
+ *
+ * The file starts with a header that contains a magic number, the version of the format,
+ * the size of the file, and a CRC-32 checksum (see hashCRC32) of the rest of the file.
+ * Each level of the Dictionary is stored as a table of fixed-size records that are
+ * sorted by their keys, so that a key can be found with a binary search. Each record
+ * contains either the value itself (for single numbers) or the offset of the value's
+ * data in the file (for strings, arrays, and nested levels). All values are stored in
+ * the native byte order, so a file can only be read on a machine with the same
+ * endianness as the one that has written it.
+ *
+ * Values that are stored in a Dictionary as a <code>boost::any</code> and are not one of
+ * the types that the Dictionary converts into its <code>StorageType</code>s cannot be
+ * written and are skipped with a warning. Vectors and matrices are stored as numeric
+ * arrays and are read back as contiguous arrays, which the Dictionary converts into the
+ * original types transparently.
+ */
+class MappedDictionary {
+public:
+    /**
+     * Writes the <code>dictionary</code> into the file <code>filename</code> in the
+     * format that can be read by a MappedDictionary. An existing file is overwritten.
+     * \param dictionary The Dictionary that is written
+     * \param filename The path of the file that is written
+     * \return <code>true</code> if the file was written successfully, <code>false</code>
+     * otherwise
+     */
+    static bool write(const Dictionary& dictionary, const std::string& filename);
+
+    /**
+     * Maps the file <code>filename</code> that was written by #write into memory. If the
+     * file does not exist, cannot be mapped, or is not a valid file, the errors are
+     * logged and an invalid MappedDictionary is created. Only the header of the file is
+     * accessed, unless <code>verifyChecksum</code> is <code>true</code>, in which case
+     * the checksum of the entire file is verified.
+     * \param filename The path of the file that is mapped
+     * \param verifyChecksum If <code>true</code>, the CRC-32 checksum of the file is
+     * verified, which requires reading the entire file
+     */
+    MappedDictionary(const std::string& filename, bool verifyChecksum = false);
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedDictionary();
+
+    /**
+     * Returns <code>true</code> if the file was mapped successfully and can be queried.
+     * \return <code>true</code> if the file was mapped successfully
+     */
+    bool isValid() const;
+
+    /**
+     * Computes the CRC-32 checksum of the entire file and compares it with the checksum
+     * stored in its header. This requires reading the entire file.
+     * \return <code>true</code> if the checksums agree, <code>false</code> otherwise
+     */
+    bool verifyChecksum() const;
+
+    /**
+     * Returns <code>true</code> if the, potentially nested, <code>key</code> exists. See
+     * Dictionary::hasKey for more information.
+     * \param key The, potentially nested, key that is checked
+     * \return <code>true</code> if the <code>key</code> exists, <code>false</code>
+     * otherwise
+     */
+    bool hasKey(const std::string& key) const;
+
+    /**
+     * Returns all keys stored at the given <code>location</code> in lexicographical order.
+     * See Dictionary::keys for more information.
+     * \param location The, potentially nested, location for which the keys are returned
+     * \return A list of all keys that are stored at the <code>location</code>, which is
+     * empty if the keys cannot be read from the file
+     */
+    std::vector<std::string> keys(const std::string& location = "") const;
+
+    /**
+     * Retrieves the number stored at the, potentially nested, <code>key</code> and
+     * converts it into the numeric type <code>T</code>.
+     * \tparam T The numeric type of the value
+     * \param key The, potentially nested, key of the value
+     * \param value The value that is set if the key exists and stores a number
+     * \return <code>true</code> if the value was retrieved successfully,
+     * <code>false</code> otherwise
+     */
+    template <typename T>
+    bool getValue(const std::string& key, T& value) const;
+
+    /**
+     * Retrieves the string stored at the, potentially nested, <code>key</code>.
+     * \param key The, potentially nested, key of the value
+     * \param value The value that is set if the key exists and stores a string
+     * \return <code>true</code> if the value was retrieved successfully,
+     * <code>false</code> otherwise
+     */
+    bool getValue(const std::string& key, std::string& value) const;
+
+    /**
+     * Reads the level stored at the, potentially nested, <code>key</code> from the file
+     * and adds it to the Dictionary <code>value</code>. The <code>key</code>
+     * <code>""</code> reads the entire file.
+     * \param key The, potentially nested, key of the level
+     * \param value The Dictionary to which the values are added
+     * \return <code>true</code> if the level was read successfully, <code>false</code>
+     * otherwise
+     */
+    bool getValue(const std::string& key, Dictionary& value) const;
+
+private:
+    MappedDictionary(const MappedDictionary& rhs) = delete;
+    MappedDictionary& operator=(const MappedDictionary& rhs) = delete;
+
+    /// A single key-value pair of one level in the file
+    struct Record;
+
+    /// Appends the level <code>dictionary</code> to <code>data</code> and returns the
+    /// offset of its table
+    static uint64_t writeTable(const Dictionary& dictionary, std::vector<char>& data);
+
+    /// Returns the record for the, potentially nested, <code>key</code> or
+    /// <code>nullptr</code> if it does not exist
+    const Record* findRecord(const std::string& key) const;
+
+    /// Returns the record with the non-nested <code>key</code> of the provided
+    /// <code>length</code> in the level that starts at <code>tableOffset</code>
+    const Record* findRecord(uint64_t tableOffset, const char* key, size_t length) const;
+
+    /// Returns the record for the level that starts at <code>tableOffset</code> and the
+    /// number of records in <code>size</code>, or <code>nullptr</code> if the level does
+    /// not lie within the file
+    const Record* table(uint64_t tableOffset, uint64_t& size) const;
+
+    /// A single number stored in the file together with its type
+    struct Number {
+        enum class Type { Integral, UnsignedIntegral, Floating } type;
+        union {
+            long long integral;
+            unsigned long long unsignedIntegral;
+            double floating;
+        };
+    };
+
+    /// Reads the string stored in the record <code>record</code>
+    bool readString(const Record& record, std::string& value) const;
+
+    /// Retrieves the number stored at the, potentially nested, <code>key</code>
+    bool number(const std::string& key, Number& value) const;
+
+    /// Unmaps the file and closes all handles
+    void unmap();
+
+    /// Adds all values in the level that starts at <code>tableOffset</code> to
+    /// <code>dictionary</code>. Nested tables have to start after their parent table
+    bool readTable(uint64_t tableOffset, Dictionary& dictionary) const;
+
+    /// The beginning of the mapped file or <code>nullptr</code> if it is invalid
+    const char* _data;
+    /// The size of the mapped file
+    size_t _size;
+#ifdef WIN32
+    /// The handles of the file and of its mapping
+    void* _file;
+    void* _mapping;
+#endif
+};
+
+template <typename T>
+bool MappedDictionary::getValue(const std::string& key, T& value) const {
+    static_assert(std::is_arithmetic<T>::value, "T has to be a numeric type");
+    Number n;
+    if (!number(key, n))
+        return false;
+    switch (n.type) {
+        case Number::Type::Integral:
+            value = static_cast<T>(n.integral);
+            break;
+        case Number::Type::UnsignedIntegral:
+            value = static_cast<T>(n.unsignedIntegral);
+            break;
+        case Number::Type::Floating:
+            value = static_cast<T>(n.floating);
+            break;
+    }
+    return true;
+}
+
+} // namespace ghoul
+
+#endif // __MAPPEDDICTIONARY_H__
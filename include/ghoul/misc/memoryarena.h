@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MEMORYARENA_H__
+#define __MEMORYARENA_H__
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * A MemoryArena is a monotonic allocator that hands out memory from large blocks that are
+ * requested from the system in bulk. Deallocating memory only updates the statistics of
+ * the arena; the blocks are released together when the MemoryArena is destroyed. This
+ * makes it well suited for data structures that are built once and destroyed as a whole,
+ * such as the Dictionary%s that are created from Lua scripts, as building and destroying
+ * them then only requires a handful of allocations. Allocations that are larger than a
+ * quarter of the block size receive a block of their own. The MemoryArena is usually not
+ * used directly, but through an ArenaAllocator that refers to it. All methods are
+ * thread-safe.
+ */
+class MemoryArena {
+public:
+    /**
+     * Creates a MemoryArena that requests memory from the system in blocks of
+     * <code>blockSize</code> bytes. No memory is requested until the first allocation.
+     * \param blockSize The size of each block in bytes
+     */
+    explicit MemoryArena(size_t blockSize = 64 * 1024);
+
+    /**
+     * Releases all blocks of this MemoryArena. All memory that has been allocated from
+     * this MemoryArena becomes invalid.
+     */
+    ~MemoryArena();
+
+    /**
+     * Returns a pointer to <code>bytes</code> bytes of uninitialized memory that is
+     * aligned to <code>alignment</code>, which has to be a power of two.
+     * \param bytes The number of bytes that are allocated
+     * \param alignment The alignment of the returned memory
+     * \return A pointer to the allocated memory
+     * \throws std::bad_alloc If a new block could not be allocated
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * Marks the <code>bytes</code> bytes at <code>pointer</code>, which must have been
+     * returned by #allocate, as unused. The memory is not reused before the MemoryArena is
+     * destroyed.
+     * \param pointer The pointer to the memory that is no longer used
+     * \param bytes The number of bytes that were allocated at <code>pointer</code>
+     */
+    void deallocate(void* pointer, size_t bytes);
+
+    /**
+     * Returns the number of bytes that have been allocated but not deallocated.
+     * \return The number of bytes that are currently in use
+     */
+    size_t usedBytes() const;
+
+    /**
+     * Returns the highest number of bytes that have been in use at the same time.
+     * \return The highest number of bytes that have been in use at the same time
+     */
+    size_t peakBytes() const;
+
+    /**
+     * Returns the total size of all blocks that have been requested from the system.
+     * \return The total size of all blocks
+     */
+    size_t reservedBytes() const;
+
+    /**
+     * Returns the number of blocks that have been requested from the system.
+     * \return The number of blocks
+     */
+    size_t nBlocks() const;
+
+private:
+    MemoryArena(const MemoryArena& rhs) = delete;
+    MemoryArena& operator=(const MemoryArena& rhs) = delete;
+
+    /// The size of regular blocks
+    const size_t _blockSize;
+    /// All blocks that have been requested so far
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    /// The next free byte in the current block
+    char* _current;
+    /// The end of the current block
+    char* _end;
+
+    size_t _usedBytes;
+    size_t _peakBytes;
+    size_t _reservedBytes;
+
+    /// Protects all other members
+    mutable std::mutex _mutex;
+};
+
+/**
+ * An allocator that satisfies the C++11 allocator requirements and allocates from a
+ * MemoryArena. The ArenaAllocator shares the ownership of its MemoryArena, so that the
+ * MemoryArena stays alive as long as any container allocates from it. A default
+ * constructed ArenaAllocator, or one that is created with a <code>nullptr</code> arena,
+ * uses the global <code>operator new</code> instead.
+ * \tparam T The type of the objects that are allocated
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    /// Creates an ArenaAllocator that allocates from the global <code>operator new</code>
+    ArenaAllocator();
+
+    /**
+     * Creates an ArenaAllocator that allocates from the <code>arena</code>.
+     * \param arena The MemoryArena that is used, or <code>nullptr</code> for the global
+     * <code>operator new</code>
+     */
+    explicit ArenaAllocator(std::shared_ptr<MemoryArena> arena);
+
+    /// Creates an ArenaAllocator for <code>T</code> using the MemoryArena of
+    /// <code>other</code>
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other);
+
+    /// Allocates uninitialized memory for <code>n</code> objects of type <code>T</code>
+    T* allocate(size_t n);
+
+    /// Deallocates the memory for <code>n</code> objects at <code>p</code>
+    void deallocate(T* p, size_t n);
+
+    /// Returns the MemoryArena of this allocator, which might be <code>nullptr</code>
+    const std::shared_ptr<MemoryArena>& arena() const;
+
+private:
+    std::shared_ptr<MemoryArena> _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs);
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs);
+
+} // namespace ghoul
+
+#include "memoryarena.inl"
+
+#endif // __MEMORYARENA_H__
@@ -0,0 +1,73 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+namespace ghoul {
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator() {}
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(std::shared_ptr<MemoryArena> arena)
+    : _arena(std::move(arena))
+{}
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other)
+    : _arena(other.arena())
+{}
+
+template <typename T>
+T* ArenaAllocator<T>::allocate(size_t n) {
+    if (_arena)
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    else
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T* p, size_t n) {
+    if (_arena)
+        _arena->deallocate(p, n * sizeof(T));
+    else
+        ::operator delete(p);
+}
+
+template <typename T>
+const std::shared_ptr<MemoryArena>& ArenaAllocator<T>::arena() const {
+    return _arena;
+}
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace ghoul
@@ -0,0 +1,95 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MPSCQUEUE_H__
+#define __MPSCQUEUE_H__
+
+#include <atomic>
+
+namespace ghoul {
+
+/**
+ * A lock-free, unbounded queue with any number of producers and a single consumer.
+ * Values can be #push%ed from any thread concurrently, while only one thread at a time
+ * may #pop them. Pushing never blocks or waits for another thread: each value is stored
+ * in a separately allocated node that is linked in with a single atomic exchange. Values
+ * pushed by the same thread are popped in the order in which they were pushed. If a
+ * producer has been interrupted in the middle of a #push, #pop reports the queue as
+ * empty until the producer has finished linking its node, even if other values have
+ * been pushed after it. The type <code>T</code> has to be default constructible and
+ * movable.
+ * \tparam T The type of the values that are stored
+ */
+template <typename T>
+class MpscQueue {
+public:
+    /// Creates an empty MpscQueue
+    MpscQueue();
+
+    /// Destroys the MpscQueue and all values that have not been popped
+    ~MpscQueue();
+
+    /**
+     * Adds the <code>value</code> to the end of the queue. This method can be called from
+     * any number of threads concurrently.
+     * \param value The value that is added
+     */
+    void push(T value);
+
+    /**
+     * Removes the value at the front of the queue and moves it into <code>value</code>.
+     * This method must only be called by one thread at a time.
+     * \param value The value that receives the front of the queue if it is not empty
+     * \return <code>true</code> if a value was removed, <code>false</code> if the queue
+     * was empty
+     */
+    bool pop(T& value);
+
+private:
+    /// A single element of the linked list of values
+    struct Node {
+        Node();
+        explicit Node(T value);
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// The most recently pushed node, which is exchanged by the producers
+    std::atomic<Node*> _head;
+
+    /// The node before the front of the queue, which is only used by the consumer. Its
+    /// value has already been popped, or it is the initial, empty node
+    Node* _tail;
+};
+
+} // namespace ghoul
+
+#include "mpscqueue.inl"
+
+#endif // __MPSCQUEUE_H__
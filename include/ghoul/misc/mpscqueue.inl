@@ -0,0 +1,78 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <utility>
+
+namespace ghoul {
+
+template <typename T>
+MpscQueue<T>::Node::Node()
+    : next(nullptr)
+    , value()
+{}
+
+template <typename T>
+MpscQueue<T>::Node::Node(T value)
+    : next(nullptr)
+    , value(std::move(value))
+{}
+
+template <typename T>
+MpscQueue<T>::MpscQueue() {
+    Node* node = new Node;
+    _head.store(node, std::memory_order_relaxed);
+    _tail = node;
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue() {
+    T value;
+    while (pop(value)) {}
+    delete _tail;
+}
+
+template <typename T>
+void MpscQueue<T>::push(T value) {
+    Node* node = new Node(std::move(value));
+    // The exchange orders the producers; the consumer cannot reach the node before the
+    // previous node has been linked to it
+    Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+bool MpscQueue<T>::pop(T& value) {
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+        return false;
+
+    value = std::move(next->value);
+    _tail = next;
+    delete tail;
+    return true;
+}
+
+} // namespace ghoul
@@ -667,6 +667,10 @@ CacheManager* FileSystem::cacheManager() {
 	return _cacheManager;
 }
 
+bool FileSystem::hasCacheManager() const {
+    return _cacheManager != nullptr;
+}
+
 void FileSystem::triggerFilesystemEvents() {
 #ifdef WIN32
 	// Sleeping for 0 milliseconds will trigger any pending asynchronous procedure calls 
@@ -675,6 +679,21 @@ void FileSystem::triggerFilesystemEvents() {
 #if defined(__APPLE__)
     triggerFilesystemEventsInternalApple();
 #endif
+#if !defined(WIN32) && !defined(__APPLE__)
+    dispatchInotifyEvents();
+#endif
+
+    // Events that are queued by the events are left for the next call
+    std::vector<std::function<void()>> events;
+    std::function<void()> event;
+    while (_queuedEvents.pop(event))
+        events.push_back(std::move(event));
+    for (const std::function<void()>& e : events)
+        e();
+}
+
+void FileSystem::queueFilesystemEvent(std::function<void()> event) {
+    _queuedEvents.push(std::move(event));
 }
 
 bool FileSystem::hasToken(const std::string& path, const std::string& token) const {
@@ -26,53 +26,87 @@
 #if !defined(WIN32) && !defined(__APPLE__)
 #include <ghoul/filesystem/filesystem.h>
 
-#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/logging/logmanager.h>
 
 #include <algorithm>
 #include <cassert>
-#include <regex>
-#include <cstdio>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 
-
-#include <dirent.h>
 #include <unistd.h>
-#include <sys/param.h>
-#include <sys/stat.h>
-#include <sys/types.h>
-#include <pwd.h>
-
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/inotify.h>
-#define EVENT_SIZE  ( sizeof (struct inotify_event) )
-#define BUF_LEN     ( 1024 * ( EVENT_SIZE + 16 ) )
+#include <sys/ioctl.h>
 
 using std::string;
 
 namespace {
     const string _loggerCat = "FileSystem";
-	const uint32_t mask = IN_ALL_EVENTS | IN_IGNORED | IN_Q_OVERFLOW | IN_UNMOUNT | IN_ISDIR;
+
+    // IN_IGNORED, IN_Q_OVERFLOW, and IN_UNMOUNT are reported regardless of the mask
+	const uint32_t mask = IN_MODIFY | IN_ATTRIB;
+
+    // Enough space for 16 events with the longest possible names
+    const size_t InitialBufferSize = 16 * (sizeof(inotify_event) + NAME_MAX + 1);
 }
 
 namespace ghoul {
 namespace filesystem {
 
 void FileSystem::initializeInternalLinux() {
-    _inotifyHandle = inotify_init();
-    _keepGoing = true;
-    _t = std::thread(inotifyWatcher);
+    _inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _shutdownHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _epollHandle = epoll_create1(EPOLL_CLOEXEC);
+    if (_inotifyHandle < 0 || _shutdownHandle < 0 || _epollHandle < 0) {
+        LERROR("Could not create the file watcher: " << strerror(errno));
+        return;
+    }
+
+    epoll_event inotifyEvent = {};
+    inotifyEvent.events = EPOLLIN;
+    inotifyEvent.data.fd = _inotifyHandle;
+    epoll_event shutdownEvent = {};
+    shutdownEvent.events = EPOLLIN;
+    shutdownEvent.data.fd = _shutdownHandle;
+    if (epoll_ctl(_epollHandle, EPOLL_CTL_ADD, _inotifyHandle, &inotifyEvent) != 0 ||
+        epoll_ctl(_epollHandle, EPOLL_CTL_ADD, _shutdownHandle, &shutdownEvent) != 0)
+    {
+        LERROR("Could not create the file watcher: " << strerror(errno));
+        return;
+    }
+
+    _inotifyBuffer.resize(InitialBufferSize);
+    _t = std::thread(&FileSystem::inotifyWatcher, this);
 }
 
 void FileSystem::deinitializeInternalLinux() {
-	_keepGoing = false;
-	if (_t.joinable())
-		_t.join();
-	close(_inotifyHandle);
+	if (_t.joinable()) {
+        // Wakes up the watcher thread immediately
+        const uint64_t signal = 1;
+        if (write(_shutdownHandle, &signal, sizeof(signal)) != sizeof(signal))
+            LERROR("Could not stop the file watcher: " << strerror(errno));
+        _t.join();
+    }
+
+    for (int handle : { _epollHandle, _shutdownHandle, _inotifyHandle }) {
+        if (handle >= 0)
+            close(handle);
+    }
 }
 
 void FileSystem::addFileListener(File* file) {
 	assert(file != nullptr);
+    std::lock_guard<std::recursive_mutex> lock(_trackedFilesMutex);
+
 	const std::string filename = file->path();
 	int wd = inotify_add_watch(_inotifyHandle, filename.c_str(), mask);
+    if (wd < 0) {
+        LERROR("Could not track '" << filename << "': " << strerror(errno));
+        return;
+    }
     auto eqRange = _trackedFiles.equal_range(wd);
     for (auto it = eqRange.first; it != eqRange.second; ++it) {
         if (it->second == file) {
@@ -85,99 +119,182 @@ void FileSystem::addFileListener(File* file) {
 
 void FileSystem::removeFileListener(File* file) {
 	assert(file != nullptr);
+    std::lock_guard<std::recursive_mutex> lock(_trackedFilesMutex);
 
-    const std::string filename = file->path();
-    int wd = inotify_add_watch(_inotifyHandle, filename.c_str(), mask);
-    auto eqRange = _trackedFiles.equal_range(wd);
-    for (auto it = eqRange.first; it != eqRange.second; ++it) {
-        if (it->second == file) {
-            _trackedFiles.erase(it);
+    auto it = std::find_if(
+        _trackedFiles.begin(),
+        _trackedFiles.end(),
+        [file](const std::pair<const int, File*>& p) { return p.second == file; }
+    );
+    if (it == _trackedFiles.end()) {
+        LWARNING("Could not find tracked '" << file << "' for path '" <<
+                 file->path() << "'");
+        return;
+    }
+
+    const int wd = it->first;
+    _trackedFiles.erase(it);
+    // The watch is only removed once no other File object tracks the same file
+    if (_trackedFiles.count(wd) == 0)
+        inotify_rm_watch(_inotifyHandle, wd);
+}
+
+void FileSystem::inotifyWatcher() {
+    epoll_event events[2];
+    while (true) {
+        const int nEvents = epoll_wait(_epollHandle, events, 2, -1);
+        if (nEvents < 0) {
+            if (errno == EINTR)
+                continue;
+            LERROR("Error waiting for file events: " << strerror(errno));
             return;
         }
+
+        bool hasInotifyEvents = false;
+        for (int i = 0; i < nEvents; ++i) {
+            if (events[i].data.fd == _shutdownHandle)
+                return;
+            hasInotifyEvents = true;
+        }
+        if (hasInotifyEvents)
+            readInotifyEvents();
     }
-    LWARNING("Could not find tracked '" << file <<"' for path '"<< file->path() << "'");
 }
 
-void FileSystem::inotifyWatcher() {
+void FileSystem::readInotifyEvents() {
+    // Grow the buffer if more events are pending than it can hold
+    int available = 0;
+    if (ioctl(_inotifyHandle, FIONREAD, &available) == 0 &&
+        static_cast<size_t>(available) > _inotifyBuffer.size())
+    {
+        _inotifyBuffer.resize(static_cast<size_t>(available));
+    }
+
+    InotifyEvent previous = { -1, 0 };
+    while (true) {
+        const ssize_t length = read(_inotifyHandle, _inotifyBuffer.data(),
+                                    _inotifyBuffer.size());
+        if (length < 0 && errno == EINTR)
+            continue;
+        // The handle is non-blocking, so all pending events have been read
+        if (length <= 0)
+            return;
 
-	int fd = FileSys._inotifyHandle;
-    char buffer[BUF_LEN];
-    struct timeval tv;
-    tv.tv_sec = 1;
-    tv.tv_usec = 0;
-    fd_set rfds;
-    while(FileSys._keepGoing) {
-        FD_ZERO (&rfds);
-        FD_SET (fd, &rfds);
-        if(select (FD_SETSIZE, &rfds, NULL, NULL, &tv) < 1) continue; 
-        
-        int length = read( fd, buffer, BUF_LEN );
-        if ( length < 0 ) continue;
-        
-        int offset = 0;
+        ssize_t offset = 0;
         while (offset < length) {
-            struct inotify_event *event = reinterpret_cast<inotify_event*>(buffer + offset);
-            switch (event->mask )
-            {
-
-                case IN_MODIFY:
-                case IN_ATTRIB:
-                {
-                    int wd = event->wd;
-                    auto eqRange = FileSys._trackedFiles.equal_range(wd);
-                    for (auto it = eqRange.first; it != eqRange.second; ++it) {
-                        File* fileobject = it->second;
-                        fileobject->_fileChangedCallback(*fileobject);
-                    }
-                    
-                }
-
-                    break;
-
-                case IN_IGNORED:
-                {
-                    int wd = event->wd;
-
-                    auto eqRange = FileSys._trackedFiles.equal_range(wd);
-                    auto it = eqRange.first;
-
-                    // remove tracking of the removed descriptor
-                    ( void ) inotify_rm_watch( fd, wd );
-
-                    // if there are files tracking
-                    if(it != eqRange.second) {
-                        // add new tracking
-                        int new_wd = inotify_add_watch( fd, it->second->path().c_str(), mask);
-
-                        // save all files
-                        std::vector<File*> v;
-                        for (;it != eqRange.second; ++it) {
-                            v.push_back(it->second);
-                        }
-
-                        // erase all previous files and add them again
-                        FileSys._trackedFiles.erase(eqRange.first, eqRange.second);
-                        for(auto f: v) {
-                            FileSys._trackedFiles.emplace(new_wd, f);
-                        }
-                    }
-                    
-                }
-                    //printf ("IN_IGNORED\n");
-                    break;
-                default:
-                    break;
-            }
-            offset += EVENT_SIZE + event->len;
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(
+                _inotifyBuffer.data() + offset
+            );
+            offset += sizeof(inotify_event) + event->len;
+
+            const uint32_t relevant = IN_Q_OVERFLOW | IN_IGNORED | IN_MODIFY | IN_ATTRIB;
+            if ((event->mask & relevant) == 0)
+                continue;
+            // Repeated changes of the same file, as caused by a sequence of writes, are
+            // coalesced here already; all others when they are dispatched
+            const InotifyEvent e = { event->wd, event->mask & relevant };
+            if (e.wd == previous.wd && e.mask == previous.mask)
+                continue;
+            _inotifyEvents.push(e);
+            previous = e;
         }
     }
 }
 
-} // namespace filesystem
-} // namespace ghoul
+void FileSystem::dispatchInotifyEvents() {
+    std::lock_guard<std::recursive_mutex> lock(_trackedFilesMutex);
 
-#endif
+    std::vector<int> changed;
+    bool hasOverflown = false;
+    InotifyEvent event;
+    while (_inotifyEvents.pop(event)) {
+        if (event.mask & IN_Q_OVERFLOW)
+            hasOverflown = true;
+        else if (event.mask & IN_IGNORED) {
+            // The watched file was deleted or replaced, for example when an editor
+            // saves by renaming a new file over the old one
+            const int wd = rewatchTrackedFiles(event.wd);
+            if (wd >= 0)
+                changed.push_back(wd);
+        }
+        else
+            changed.push_back(event.wd);
+    }
+    if (hasOverflown) {
+        LWARNING("File events were lost, rescanning all tracked files");
+        const std::vector<int> descriptors = rescanTrackedFiles();
+        changed.insert(changed.end(), descriptors.begin(), descriptors.end());
+    }
+
+    // Each File is tracked with only one descriptor, so it is notified at most once
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    for (int wd : changed)
+        notifyTrackedFiles(wd);
+}
+
+void FileSystem::notifyTrackedFiles(int wd) {
+    // The callbacks might add or remove listeners, so the files are collected first and
+    // each one is checked to still be tracked before its callback is called
+    std::vector<File*> files;
+    auto eqRange = _trackedFiles.equal_range(wd);
+    for (auto it = eqRange.first; it != eqRange.second; ++it)
+        files.push_back(it->second);
+
+    for (File* file : files) {
+        eqRange = _trackedFiles.equal_range(wd);
+        const bool isTracked = std::any_of(
+            eqRange.first,
+            eqRange.second,
+            [file](const std::pair<const int, File*>& p) { return p.second == file; }
+        );
+        if (isTracked && file->_fileChangedCallback)
+            file->_fileChangedCallback(*file);
+    }
+}
 
+int FileSystem::rewatchTrackedFiles(int wd) {
+    auto eqRange = _trackedFiles.equal_range(wd);
+    if (eqRange.first == eqRange.second)
+        return -1;
 
+    const std::string& path = eqRange.first->second->path();
+    const int newWd = inotify_add_watch(_inotifyHandle, path.c_str(), mask);
+    if (newWd < 0) {
+        LWARNING("Could not track '" << path << "' anymore: " << strerror(errno));
+        return -1;
+    }
+    if (newWd == wd)
+        return wd;
 
+    std::vector<File*> files;
+    for (auto it = eqRange.first; it != eqRange.second; ++it)
+        files.push_back(it->second);
+    _trackedFiles.erase(eqRange.first, eqRange.second);
+    for (File* file : files)
+        _trackedFiles.emplace(newWd, file);
+    return newWd;
+}
 
+std::vector<int> FileSystem::rescanTrackedFiles() {
+    std::vector<int> descriptors;
+    for (auto it = _trackedFiles.begin(); it != _trackedFiles.end();
+         it = _trackedFiles.upper_bound(it->first))
+    {
+        descriptors.push_back(it->first);
+    }
+
+    // Any of the files might have changed or been replaced while the events were lost
+    std::vector<int> result;
+    for (int wd : descriptors) {
+        const int newWd = rewatchTrackedFiles(wd);
+        if (newWd >= 0)
+            result.push_back(newWd);
+    }
+    return result;
+}
+
+} // namespace filesystem
+} // namespace ghoul
+
+#endif
@@ -0,0 +1,269 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "ghoul/lua/configurationwatcher.h"
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/lua/lua_helper.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace {
+    const std::string _loggerCat = "ConfigurationWatcher";
+}
+
+namespace ghoul {
+namespace lua {
+
+struct ConfigurationWatcher::Data : public std::enable_shared_from_this<Data> {
+    /// A single watched configuration file
+    struct Watch {
+        /// The File whose callback schedules the reloads
+        std::shared_ptr<filesystem::File> file;
+        /// The callback to which the new configurations are delivered
+        ReloadCallback callback;
+        /// The most recently loaded configuration
+        std::shared_ptr<const Dictionary> configuration;
+        /// Whether the file has changed since it was last reloaded
+        bool isPending;
+        /// The time at which a pending reload is due
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    Data(std::chrono::milliseconds debounceInterval, bool contiguousArrays)
+        : debounceInterval(debounceInterval)
+        , contiguousArrays(contiguousArrays)
+        , isRunning(true)
+    {}
+
+    /// Loads the file at <code>path</code>, returns <code>nullptr</code> on failure
+    std::shared_ptr<const Dictionary> load(const std::string& path) const {
+        Dictionary dictionary;
+        try {
+            if (!loadDictionaryFromFile(path, dictionary, nullptr, contiguousArrays)) {
+                LERROR("Error loading configuration '" << path << "'");
+                return nullptr;
+            }
+        }
+        catch (const FormattingException& e) {
+            LERROR("Error loading configuration '" << path << "': " << e.what());
+            return nullptr;
+        }
+        return dictionary.freeze();
+    }
+
+    /// Called by the File callbacks, possibly from the thread watching the filesystem
+    void scheduleReload(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = watches.find(path);
+            if (it == watches.end())
+                return;
+            // Every change postpones the reload, so that a burst results in one reload
+            it->second.isPending = true;
+            it->second.deadline = std::chrono::steady_clock::now() + debounceInterval;
+        }
+        condition.notify_one();
+    }
+
+    /// The loop of the background thread, which reloads files whose deadline has passed
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (isRunning) {
+            const std::chrono::steady_clock::time_point now =
+                std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point next =
+                std::chrono::steady_clock::time_point::max();
+            auto due = watches.end();
+            for (auto it = watches.begin(); it != watches.end(); ++it) {
+                if (!it->second.isPending)
+                    continue;
+                if (it->second.deadline <= now) {
+                    due = it;
+                    break;
+                }
+                next = std::min(next, it->second.deadline);
+            }
+
+            if (due == watches.end()) {
+                if (next == std::chrono::steady_clock::time_point::max())
+                    condition.wait(lock);
+                else
+                    condition.wait_until(lock, next);
+                continue;
+            }
+
+            due->second.isPending = false;
+            const std::string path = due->first;
+            const std::shared_ptr<const Dictionary> previous = due->second.configuration;
+            lock.unlock();
+            reload(path, previous);
+            lock.lock();
+        }
+    }
+
+    /// Reloads the file at <code>path</code> and queues the delivery of the result if
+    /// it differs from the <code>previous</code> configuration
+    void reload(const std::string& path, std::shared_ptr<const Dictionary> previous) {
+        std::shared_ptr<const Dictionary> configuration = load(path);
+        if (!configuration)
+            return;
+
+        std::shared_ptr<const Dictionary::ChangeSet> changes =
+            std::make_shared<Dictionary::ChangeSet>(previous->diff(*configuration));
+        if (changes->empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = watches.find(path);
+            // The file might have been unwatched or watched anew in the meantime
+            if (it == watches.end() || it->second.configuration != previous)
+                return;
+            it->second.configuration = configuration;
+        }
+
+        std::weak_ptr<Data> data = shared_from_this();
+        FileSys.queueFilesystemEvent([data, path, configuration, changes]() {
+            std::shared_ptr<Data> d = data.lock();
+            if (d)
+                d->deliver(path, *configuration, *changes);
+        });
+    }
+
+    /// Calls the callback of <code>path</code> if it is still watched
+    void deliver(const std::string& path, const Dictionary& configuration,
+                 const Dictionary::ChangeSet& changes)
+    {
+        ReloadCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = watches.find(path);
+            if (it == watches.end())
+                return;
+            callback = it->second.callback;
+        }
+        if (callback)
+            callback(configuration, changes);
+    }
+
+    const std::chrono::milliseconds debounceInterval;
+    const bool contiguousArrays;
+
+    /// Protects all members below
+    mutable std::mutex mutex;
+    /// Notifies the background thread about new pending reloads and about stopping
+    std::condition_variable condition;
+    /// All watched files, keyed by their absolute path
+    std::map<std::string, Watch> watches;
+    /// Whether the background thread should keep running
+    bool isRunning;
+};
+
+ConfigurationWatcher::ConfigurationWatcher(std::chrono::milliseconds debounceInterval,
+                                           bool contiguousArrays)
+    : _data(std::make_shared<Data>(debounceInterval, contiguousArrays))
+{
+    _worker = std::thread(&Data::run, _data.get());
+}
+
+ConfigurationWatcher::~ConfigurationWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(_data->mutex);
+        _data->isRunning = false;
+    }
+    _data->condition.notify_all();
+    _worker.join();
+
+    // The Files are destroyed outside of the lock as their callbacks acquire it
+    std::map<std::string, Data::Watch> watches;
+    {
+        std::lock_guard<std::mutex> lock(_data->mutex);
+        watches.swap(_data->watches);
+    }
+}
+
+bool ConfigurationWatcher::watch(const std::string& filename, ReloadCallback callback) {
+    const std::string path = absPath(filename);
+    std::shared_ptr<const Dictionary> configuration = _data->load(path);
+    if (!configuration)
+        return false;
+
+    Data* data = _data.get();
+    Data::Watch watch;
+    watch.file = std::make_shared<filesystem::File>(path, true,
+        [data, path](const filesystem::File&) { data->scheduleReload(path); }
+    );
+    watch.callback = callback;
+    watch.configuration = configuration;
+    watch.isPending = false;
+
+    Data::Watch previous;
+    {
+        std::lock_guard<std::mutex> lock(_data->mutex);
+        Data::Watch& w = _data->watches[path];
+        previous = std::move(w);
+        w = std::move(watch);
+    }
+
+    if (callback)
+        callback(*configuration, Dictionary().diff(*configuration));
+    return true;
+}
+
+void ConfigurationWatcher::unwatch(const std::string& filename) {
+    const std::string path = absPath(filename);
+    Data::Watch previous;
+    {
+        std::lock_guard<std::mutex> lock(_data->mutex);
+        auto it = _data->watches.find(path);
+        if (it == _data->watches.end())
+            return;
+        previous = std::move(it->second);
+        _data->watches.erase(it);
+    }
+}
+
+bool ConfigurationWatcher::isWatching(const std::string& filename) const {
+    const std::string path = absPath(filename);
+    std::lock_guard<std::mutex> lock(_data->mutex);
+    return _data->watches.find(path) != _data->watches.end();
+}
+
+std::shared_ptr<const Dictionary> ConfigurationWatcher::configuration(
+                                                        const std::string& filename) const
+{
+    const std::string path = absPath(filename);
+    std::lock_guard<std::mutex> lock(_data->mutex);
+    auto it = _data->watches.find(path);
+    return (it != _data->watches.end()) ? it->second.configuration : nullptr;
+}
+
+} // namespace lua
+} // namespace ghoul
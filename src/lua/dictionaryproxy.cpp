@@ -0,0 +1,368 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "ghoul/lua/dictionaryproxy.h"
+#include "ghoul/lua/ghoul_lua.h"
+
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+    // The name of the metatable that is shared by all proxies
+    const char* MetatableName = "ghoul::lua::DictionaryProxy";
+
+#if LUA_VERSION_NUM < 503
+    // The largest magnitude up to which every integer is exactly representable as a
+    // lua_Number
+    const lua_Number MaxExactInteger = 9007199254740992.0;
+#endif
+
+    /// Returns <code>true</code> if the <code>key</code> is a positive integer that was
+    /// created from the index of a sequence
+    bool isIndex(const std::string& key) {
+        return !key.empty() && key.size() < 10 && key[0] != '0' &&
+            key.find_first_not_of("0123456789") == std::string::npos;
+    }
+}
+
+namespace ghoul {
+namespace lua {
+
+/**
+ * The contents of the userdata of a proxy. Each proxy keeps the root of the snapshot
+ * alive, so that the nested Dictionary it points to remains valid, and stores the values
+ * that have been accessed in its uservalue table, keyed by their string keys.
+ */
+class DictionaryProxy {
+public:
+    DictionaryProxy(std::shared_ptr<const Dictionary> root, const Dictionary* dictionary)
+        : root(std::move(root))
+        , dictionary(dictionary)
+    {}
+
+    /// Pushes a new proxy for the <code>dictionary</code> that is part of
+    /// <code>root</code>
+    static void push(lua_State* L, std::shared_ptr<const Dictionary> root,
+                     const Dictionary* dictionary)
+    {
+        void* storage = lua_newuserdata(L, sizeof(DictionaryProxy));
+        new (storage) DictionaryProxy(std::move(root), dictionary);
+
+        if (luaL_newmetatable(L, MetatableName)) {
+            const luaL_Reg metamethods[] = {
+                { "__index", &DictionaryProxy::index },
+                { "__newindex", &DictionaryProxy::newIndex },
+                { "__len", &DictionaryProxy::length },
+                { "__pairs", &DictionaryProxy::pairs },
+                { "__ipairs", &DictionaryProxy::ipairs },
+                { "__tostring", &DictionaryProxy::toString },
+                { "__gc", &DictionaryProxy::destroy },
+                { nullptr, nullptr }
+            };
+            luaL_setfuncs(L, metamethods, 0);
+            // Prevents scripts from replacing the metamethods with getmetatable
+            lua_pushliteral(L, "DictionaryProxy");
+            lua_setfield(L, -2, "__metatable");
+        }
+        lua_setmetatable(L, -2);
+
+        lua_newtable(L);
+        lua_setuservalue(L, -2);
+    }
+
+    std::shared_ptr<const Dictionary> root;
+    const Dictionary* dictionary;
+
+private:
+    static DictionaryProxy* check(lua_State* L, int index) {
+        return static_cast<DictionaryProxy*>(luaL_checkudata(L, index, MetatableName));
+    }
+
+    /// Pushes the key at <code>index</code> as the string that is used in the
+    /// Dictionary and returns <code>true</code>, or returns <code>false</code> if no
+    /// Dictionary key corresponds to it
+    static bool pushKey(lua_State* L, int index) {
+        switch (lua_type(L, index)) {
+            case LUA_TSTRING:
+                lua_pushvalue(L, index);
+                return true;
+            case LUA_TNUMBER: {
+#if LUA_VERSION_NUM < 503
+                // Lua 5.2 truncates any number in lua_tointegerx, so NaN, fractional,
+                // and out-of-range numbers have to be rejected beforehand
+                const lua_Number n = lua_tonumber(L, index);
+                if (!(std::floor(n) == n && std::abs(n) <= MaxExactInteger))
+                    return false;
+#endif
+                int isInteger = 0;
+                const lua_Integer i = lua_tointegerx(L, index, &isInteger);
+                if (!isInteger)
+                    return false;
+                lua_pushstring(L, std::to_string(static_cast<long long>(i)).c_str());
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    /// Pushes the value for the string key at the absolute <code>keyIndex</code> of the
+    /// proxy at <code>proxyIndex</code>. If it has not been accessed before, it is
+    /// converted from <code>entry</code>, which is searched for if it is
+    /// <code>nullptr</code>, and stored in the uservalue table of the proxy. Tables
+    /// created for contiguous arrays are not stored, as scripts could modify them
+    static void pushEntry(lua_State* L, int proxyIndex, int keyIndex,
+                          const Dictionary::Entry* entry)
+    {
+        lua_getuservalue(L, proxyIndex);
+        lua_pushvalue(L, keyIndex);
+        lua_rawget(L, -2);
+        if (!lua_isnil(L, -1)) {
+            lua_remove(L, -2);
+            return;
+        }
+        lua_pop(L, 1);
+
+        const DictionaryProxy* proxy = check(L, proxyIndex);
+        if (entry == nullptr) {
+            size_t length = 0;
+            const char* key = lua_tolstring(L, keyIndex, &length);
+            entry = proxy->dictionary->findEntry(
+                key, length, DictionaryKey::hash(key, length)
+            );
+            if (entry == nullptr) {
+                lua_pop(L, 1);
+                lua_pushnil(L);
+                return;
+            }
+        }
+
+        pushValue(L, proxy->root, entry->value);
+        if (isArray(entry->value)) {
+            lua_remove(L, -2);
+            return;
+        }
+        lua_pushvalue(L, keyIndex);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+        lua_remove(L, -2);
+    }
+
+    /// Pushes the <code>value</code>, which is part of <code>root</code>
+    static void pushValue(lua_State* L, const std::shared_ptr<const Dictionary>& root,
+                          const Dictionary::Value& value)
+    {
+        switch (value.which()) {
+            case 0:
+                lua_pushinteger(L,
+                    static_cast<lua_Integer>(boost::get<long long>(value)));
+                break;
+            case 1:
+                lua_pushinteger(L,
+                    static_cast<lua_Integer>(boost::get<unsigned long long>(value)));
+                break;
+            case 2:
+                lua_pushnumber(L, boost::get<double>(value));
+                break;
+            case 3: {
+                const std::string& v = boost::get<std::string>(value);
+                lua_pushlstring(L, v.data(), v.size());
+                break;
+            }
+            case 4:
+                push(L, root, &boost::get<Dictionary>(value));
+                break;
+            case 5:
+                pushArray(L, boost::get<std::vector<long long>>(value));
+                break;
+            case 6:
+                pushArray(L, boost::get<std::vector<double>>(value));
+                break;
+            default:
+                lua_pushnil(L);
+                break;
+        }
+    }
+
+    /// Returns <code>true</code> if the <code>value</code> is a contiguous numeric array
+    static bool isArray(const Dictionary::Value& value) {
+        return (boost::get<std::vector<long long>>(&value) != nullptr) ||
+               (boost::get<std::vector<double>>(&value) != nullptr);
+    }
+
+    /// Pushes a contiguous numeric array as a sequence
+    static void pushArray(lua_State* L, const std::vector<long long>& values) {
+        lua_createtable(L, static_cast<int>(values.size()), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            lua_pushinteger(L, static_cast<lua_Integer>(values[i]));
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
+        }
+    }
+
+    static void pushArray(lua_State* L, const std::vector<double>& values) {
+        lua_createtable(L, static_cast<int>(values.size()), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            lua_pushnumber(L, values[i]);
+            lua_rawseti(L, -2, static_cast<int>(i + 1));
+        }
+    }
+
+    /// <code>__index(proxy, key)</code>
+    static int index(lua_State* L) {
+        check(L, 1);
+        if (!pushKey(L, 2)) {
+            lua_pushnil(L);
+            return 1;
+        }
+        pushEntry(L, 1, lua_gettop(L), nullptr);
+        return 1;
+    }
+
+    /// <code>__newindex(proxy, key, value)</code>
+    static int newIndex(lua_State* L) {
+        check(L, 1);
+        return luaL_error(L, "Dictionary proxies are read-only");
+    }
+
+    /// <code>__len(proxy)</code> returns the length of the sequence stored in the
+    /// Dictionary or 0 if it does not store a sequence. As Dictionaries created from Lua
+    /// contain either only indices or only other keys, it is sufficient to test for the
+    /// last index
+    static int length(lua_State* L) {
+        const DictionaryProxy* proxy = check(L, 1);
+        const size_t size = proxy->dictionary->size();
+        const std::string last = std::to_string(size);
+        const bool isSequence = size > 0 && proxy->dictionary->findEntry(
+            last.data(), last.size(), DictionaryKey::hash(last.data(), last.size())
+        ) != nullptr;
+        lua_pushinteger(L, isSequence ? static_cast<lua_Integer>(size) : 0);
+        return 1;
+    }
+
+    /// <code>__pairs(proxy)</code> returns an iterator over the entries in the order in
+    /// which they were added. The position of the iterator is stored in its upvalue
+    static int pairs(lua_State* L) {
+        check(L, 1);
+        lua_pushinteger(L, 0);
+        lua_pushcclosure(L, &DictionaryProxy::next, 1);
+        lua_pushvalue(L, 1);
+        lua_pushnil(L);
+        return 3;
+    }
+
+    static int next(lua_State* L) {
+        const DictionaryProxy* proxy = check(L, 1);
+        const size_t position = static_cast<size_t>(
+            lua_tointeger(L, lua_upvalueindex(1))
+        );
+        const std::shared_ptr<Dictionary::Node>& node = proxy->dictionary->_node;
+        if (!node || position >= node->entries.size())
+            return 0;
+        lua_pushinteger(L, static_cast<lua_Integer>(position + 1));
+        lua_replace(L, lua_upvalueindex(1));
+
+        lua_settop(L, 1);
+        const Dictionary::Entry& entry = node->entries[position];
+        const std::string& key = entry.key();
+        if (isIndex(key)) {
+            lua_pushinteger(L, static_cast<lua_Integer>(std::stoi(key)));
+            lua_pushlstring(L, key.data(), key.size());
+            pushEntry(L, 1, 3, &entry);
+            lua_remove(L, 3);
+        }
+        else {
+            lua_pushlstring(L, key.data(), key.size());
+            pushEntry(L, 1, 2, &entry);
+        }
+        return 2;
+    }
+
+    /// <code>__ipairs(proxy)</code> for Lua versions whose <code>ipairs</code> does not
+    /// respect <code>__index</code>
+    static int ipairs(lua_State* L) {
+        check(L, 1);
+        lua_pushcfunction(L, &DictionaryProxy::nextIndex);
+        lua_pushvalue(L, 1);
+        lua_pushinteger(L, 0);
+        return 3;
+    }
+
+    static int nextIndex(lua_State* L) {
+        const lua_Integer i = luaL_checkinteger(L, 2) + 1;
+        lua_pushinteger(L, i);
+        lua_pushinteger(L, i);
+        lua_gettable(L, 1);
+        return lua_isnil(L, -1) ? 1 : 2;
+    }
+
+    /// <code>__tostring(proxy)</code>
+    static int toString(lua_State* L) {
+        const DictionaryProxy* proxy = check(L, 1);
+        lua_pushfstring(L, "Dictionary: %p", static_cast<const void*>(proxy->dictionary));
+        return 1;
+    }
+
+    /// <code>__gc(proxy)</code>
+    static int destroy(lua_State* L) {
+        check(L, 1)->~DictionaryProxy();
+        return 0;
+    }
+};
+
+void pushDictionaryProxy(lua_State* L, std::shared_ptr<const Dictionary> dictionary) {
+    const Dictionary* d = dictionary.get();
+    DictionaryProxy::push(L, std::move(dictionary), d);
+}
+
+void pushDictionaryProxy(lua_State* L, const Dictionary& dictionary) {
+    pushDictionaryProxy(L, std::make_shared<const Dictionary>(dictionary));
+}
+
+const Dictionary* dictionaryFromProxy(lua_State* L, int index) {
+    const DictionaryProxy* proxy = static_cast<const DictionaryProxy*>(
+        luaL_testudata(L, index, MetatableName)
+    );
+    return proxy ? proxy->dictionary : nullptr;
+}
+
+int dictionaryProxyToTable(lua_State* L) {
+    if (lua_istable(L, 1)) {
+        lua_settop(L, 1);
+        return 1;
+    }
+    const Dictionary* dictionary = dictionaryFromProxy(L, 1);
+    if (dictionary == nullptr)
+        return luaL_argerror(L, 1, "table or Dictionary proxy expected");
+    luaDictionaryToState(L, *dictionary);
+    return 1;
+}
+
+} // namespace lua
+} // namespace ghoul
@@ -26,25 +26,516 @@
 #include "ghoul/lua/lua_helper.h"
 #include "ghoul/lua/ghoul_lua.h"
 
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/luaallocator.h>
+#include <ghoul/lua/luastatepool.h>
+#include <ghoul/misc/buffer.h>
+#include <ghoul/misc/crc32.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
 #include <fstream>
 #include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 using namespace ghoul::logging;
 
 namespace ghoul {
 namespace lua {
 
-static lua_State* _state = nullptr;
-
 FormattingException::FormattingException(const std::string& msg)
     : std::runtime_error(msg) {
 }
 
 namespace {
 
+// The states that are leased by the loading functions if no state is provided
+LuaStatePool& statePool() {
+    static LuaStatePool pool;
+    return pool;
+}
+
+// Identifies the cached bytecode files and the Lua version that created them
+const uint32_t BytecodeMagic = 0x43424C47; // 'GLBC'
+const uint32_t BytecodeVersion = LUA_VERSION_NUM;
+
+// Identifies the cached results of scripts and the version of their format
+const uint32_t ResultMagic = 0x43524C47; // 'GLRC'
+const uint32_t ResultVersion = 2;
+
+// The globals that load other files and are wrapped to record the dependencies
+const char* DependencyFunctions[] = { "dofile", "loadfile", "require" };
+
+// The registry field that points to the list of recorded dependencies while a script is
+// executed and is nil otherwise
+const char* DependencySink = "_ghoul_dependencies";
+
+// Protects the CacheManager, which is not thread-safe
+std::mutex& cacheMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/// Returns the information under which the <code>type</code> of cached file for the
+/// script at the absolute <code>path</code> is stored. The CacheManager only
+/// distinguishes files by their name, so the path is part of the information
+std::string cacheInformation(const std::string& type, const std::string& path) {
+    return type + "|" + path;
+}
+
+int writeBytecode(lua_State*, const void* data, size_t size, void* bytecode) {
+    static_cast<std::string*>(bytecode)->append(static_cast<const char*>(data), size);
+    return 0;
+}
+
+/**
+ * Writes the <code>contents</code> to a temporary file next to <code>path</code> and
+ * renames it to <code>path</code> afterwards, so that concurrent readers of the file
+ * never see a partially written file without having to hold the #cacheMutex.
+ * \return <code>true</code> if the file was written successfully
+ */
+bool writeFileAtomically(const std::string& path, const std::string& contents) {
+    // Concurrent writers of the same path use different temporary files
+    static std::atomic<unsigned int> counter(0);
+    std::ostringstream temporary;
+    temporary << path << '.' << std::this_thread::get_id() << '.' << counter++ << ".tmp";
+    const std::string temporaryPath = temporary.str();
+
+    std::ofstream file(temporaryPath, std::ofstream::binary | std::ofstream::trunc);
+    file.write(contents.data(), contents.size());
+    file.close();
+    if (!file.good()) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        // Not all platforms replace an existing file when renaming
+        std::remove(path.c_str());
+        if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Loads the script at the absolute <code>path</code> onto the stack of the
+ * <code>state</code> like <code>luaL_loadfile</code>. The chunk is compiled from the
+ * bytecode that was cached by a previous call if the source file has not changed since.
+ * Otherwise, the source is compiled and the resulting bytecode is stored in the cache.
+ * Each cached file consists of a header with the #BytecodeMagic, the #BytecodeVersion,
+ * the size and the CRC-32 of the source, followed by the bytecode. If no CacheManager
+ * exists, this function falls back to <code>luaL_loadfile</code>.
+ */
+int loadCachedScript(lua_State* state, const std::string& path) {
+    const static std::string _loggerCat = "lua_loadCachedScript";
+
+    if (!FileSys.hasCacheManager())
+        return luaL_loadfile(state, path.c_str());
+
+    std::ifstream sourceFile(path, std::ifstream::binary);
+    if (!sourceFile.good())
+        return luaL_loadfile(state, path.c_str());
+    std::string source(
+        (std::istreambuf_iterator<char>(sourceFile)),
+        std::istreambuf_iterator<char>()
+    );
+    sourceFile.close();
+    const uint32_t checksum = hashCRC32(source);
+    const uint64_t sourceSize = source.size();
+    const std::string chunkName = "@" + path;
+
+    // Only the CacheManager needs to be protected; the cached file is replaced
+    // atomically, so it can be read and written without holding the lock
+    std::string cachedFile;
+    bool hasCache;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        hasCache = FileSys.cacheManager()->getCachedFile(
+            filesystem::File(path, true),
+            cacheInformation("LuaBytecode", path),
+            cachedFile,
+            true
+        );
+    }
+
+    if (hasCache) {
+        std::ifstream cache(cachedFile, std::ifstream::binary);
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t size = 0;
+        uint32_t crc = 0;
+        cache.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        cache.read(reinterpret_cast<char*>(&version), sizeof(version));
+        cache.read(reinterpret_cast<char*>(&size), sizeof(size));
+        cache.read(reinterpret_cast<char*>(&crc), sizeof(crc));
+        if (cache.good() && magic == BytecodeMagic && version == BytecodeVersion &&
+            size == sourceSize && crc == checksum)
+        {
+            std::string bytecode(
+                (std::istreambuf_iterator<char>(cache)),
+                std::istreambuf_iterator<char>()
+            );
+            int status = luaL_loadbuffer(
+                state, bytecode.data(), bytecode.size(), chunkName.c_str()
+            );
+            if (status == LUA_OK)
+                return status;
+            LWARNING("Cached bytecode for '" << path << "' was invalid");
+            lua_pop(state, 1);
+        }
+    }
+
+    // Like luaL_loadfile, skip a leading '#' line but keep the line numbers intact
+    if (!source.empty() && source[0] == '#')
+        source.erase(0, std::min(source.find('\n'), source.size()));
+
+    int status = luaL_loadbuffer(state, source.data(), source.size(), chunkName.c_str());
+    if (status != LUA_OK || !hasCache)
+        return status;
+
+    std::string cache;
+    cache.append(reinterpret_cast<const char*>(&BytecodeMagic), sizeof(BytecodeMagic));
+    cache.append(
+        reinterpret_cast<const char*>(&BytecodeVersion), sizeof(BytecodeVersion)
+    );
+    cache.append(reinterpret_cast<const char*>(&sourceSize), sizeof(sourceSize));
+    cache.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+#if LUA_VERSION_NUM >= 503
+    lua_dump(state, writeBytecode, &cache, 0);
+#else
+    lua_dump(state, writeBytecode, &cache);
+#endif
+    if (!writeFileAtomically(cachedFile, cache))
+        LWARNING("Could not write bytecode cache file '" << cachedFile << "'");
+    return status;
+}
+
+/// Reads the file at <code>path</code> and computes its size and CRC-32
+bool fileChecksum(const std::string& path, uint64_t& size, uint32_t& checksum) {
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.good())
+        return false;
+    const std::string contents(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>()
+    );
+    size = contents.size();
+    checksum = hashCRC32(contents);
+    return true;
+}
+
+/**
+ * Replaces the wrapped function that is stored in the first upvalue. Before it is called
+ * with all arguments, the file that it is going to load is added to the
+ * <code>std::vector<std::string></code> that the #DependencySink in the registry points
+ * to. For <code>require</code>, the file is found with <code>package.searchpath</code>,
+ * so only modules written in Lua are recorded. If the wrapper outlives the recording,
+ * for example because the script stored it elsewhere, the sink is empty and nothing is
+ * recorded.
+ */
+int recordDependency(lua_State* L) {
+    lua_getfield(L, LUA_REGISTRYINDEX, DependencySink);
+    std::vector<std::string>* dependencies = static_cast<std::vector<std::string>*>(
+        lua_touserdata(L, -1)
+    );
+    lua_pop(L, 1);
+    const bool isRequire = lua_toboolean(L, lua_upvalueindex(2)) != 0;
+
+    if (dependencies != nullptr && lua_type(L, 1) == LUA_TSTRING) {
+        if (isRequire) {
+            lua_getglobal(L, "package");
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "searchpath");
+                lua_pushvalue(L, 1);
+                lua_getfield(L, -3, "path");
+                if (lua_pcall(L, 2, 1, 0) == LUA_OK && lua_isstring(L, -1))
+                    dependencies->push_back(lua_tostring(L, -1));
+            }
+            lua_settop(L, 1);
+        }
+        else
+            dependencies->push_back(lua_tostring(L, 1));
+    }
+
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_insert(L, 1);
+    lua_call(L, lua_gettop(L) - 1, LUA_MULTRET);
+    return lua_gettop(L);
+}
+
+/// Wraps the #DependencyFunctions of the <code>state</code>, so that all files that are
+/// loaded through them are added to the <code>dependencies</code> until
+/// #stopRecordingDependencies is called
+void startRecordingDependencies(lua_State* state, std::vector<std::string>& dependencies)
+{
+    lua_pushlightuserdata(state, &dependencies);
+    lua_setfield(state, LUA_REGISTRYINDEX, DependencySink);
+    for (const char* name : DependencyFunctions) {
+        lua_getglobal(state, name);
+        if (lua_isfunction(state, -1)) {
+            lua_pushboolean(state, std::string(name) == "require");
+            lua_pushcclosure(state, recordDependency, 2);
+            lua_setglobal(state, name);
+        }
+        else
+            lua_pop(state, 1);
+    }
+}
+
+/// Restores the #DependencyFunctions that were wrapped by #startRecordingDependencies
+/// and clears the #DependencySink, so that the dependencies are no longer referenced
+void stopRecordingDependencies(lua_State* state) {
+    lua_pushnil(state);
+    lua_setfield(state, LUA_REGISTRYINDEX, DependencySink);
+    for (const char* name : DependencyFunctions) {
+        lua_getglobal(state, name);
+        if (lua_tocfunction(state, -1) == recordDependency) {
+            lua_getupvalue(state, -1, 1);
+            lua_setglobal(state, name);
+        }
+        lua_pop(state, 1);
+    }
+}
+
+/// Returns the information under which the result of a script is cached
+std::string resultCacheInformation(const std::string& path, bool contiguousArrays) {
+    return cacheInformation(contiguousArrays ? "LuaResultContiguous" : "LuaResult", path);
+}
+
+/**
+ * Adds the cached result of the script at the absolute <code>path</code> to the
+ * <code>dictionary</code>. Each cached result consists of the #ResultMagic, the
+ * #ResultVersion, and the CRC-32 of the payload. The payload contains the paths, sizes,
+ * and CRC-32s of all files the script depended on, the script itself being the first,
+ * followed by the serialized Dictionary. The result is only used if the payload is intact
+ * and none of the dependencies has changed.
+ * \return <code>true</code> if a valid cached result was found and added
+ */
+bool loadCachedResult(const std::string& path, Dictionary& dictionary,
+                      bool contiguousArrays)
+{
+    const static std::string _loggerCat = "lua_loadCachedResult";
+
+    // Only the CacheManager needs to be protected; the cached file is replaced
+    // atomically, so it can be read without holding the lock
+    const filesystem::File file(path, true);
+    const std::string information = resultCacheInformation(path, contiguousArrays);
+    std::string cachedFile;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        filesystem::CacheManager* cacheManager = FileSys.cacheManager();
+        if (!cacheManager->hasCachedFile(file, information))
+            return false;
+        cacheManager->getCachedFile(file, information, cachedFile);
+    }
+
+    std::ifstream cache(cachedFile, std::ifstream::binary);
+    if (!cache.good())
+        return false;
+    const std::string contents(
+        (std::istreambuf_iterator<char>(cache)),
+        std::istreambuf_iterator<char>()
+    );
+    cache.close();
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t crc = 0;
+    const size_t headerSize = sizeof(magic) + sizeof(version) + sizeof(crc);
+    if (contents.size() < headerSize)
+        return false;
+    std::memcpy(&magic, contents.data(), sizeof(magic));
+    std::memcpy(&version, contents.data() + sizeof(magic), sizeof(version));
+    std::memcpy(&crc, contents.data() + sizeof(magic) + sizeof(version), sizeof(crc));
+    if (magic != ResultMagic || version != ResultVersion)
+        return false;
+    const char* payload = contents.data() + headerSize;
+    const size_t payloadSize = contents.size() - headerSize;
+    if (hashCRC32(payload, payloadSize) != crc) {
+        LWARNING("Cached result for '" << path << "' is corrupted");
+        return false;
+    }
+
+    Buffer buffer;
+    buffer.serialize(reinterpret_cast<const Buffer::value_type*>(payload), payloadSize);
+    std::vector<std::string> dependencies;
+    std::vector<uint64_t> sizes;
+    std::vector<uint32_t> checksums;
+    buffer.deserialize(dependencies);
+    buffer.deserialize(sizes);
+    buffer.deserialize(checksums);
+    // The script itself is stored as the first dependency, which guards against cached
+    // files that belong to a different script
+    if (dependencies.empty() || dependencies[0] != absPath(path) ||
+        sizes.size() != dependencies.size() || checksums.size() != dependencies.size())
+    {
+        LDEBUG("Cached result for '" << path << "' belongs to a different script");
+        return false;
+    }
+    for (size_t i = 0; i < dependencies.size(); ++i) {
+        uint64_t size = 0;
+        uint32_t checksum = 0;
+        if (!fileChecksum(dependencies[i], size, checksum) ||
+            size != sizes[i] || checksum != checksums[i])
+        {
+            LDEBUG("Cached result for '" << path << "' is outdated as '" <<
+                   dependencies[i] << "' changed");
+            return false;
+        }
+    }
+
+    // The dictionary is left untouched if the cached values cannot be read
+    if (!buffer.deserialize(dictionary)) {
+        LWARNING("Cached result for '" << path << "' could not be read");
+        return false;
+    }
+    return true;
+}
+
+/// Stores the <code>result</code> of the script at the absolute <code>path</code>
+/// together with its <code>dependencies</code> in the format read by #loadCachedResult
+void storeCachedResult(const std::string& path, std::vector<std::string> dependencies,
+                       const Dictionary& result, bool contiguousArrays)
+{
+    const static std::string _loggerCat = "lua_storeCachedResult";
+
+    // The script itself is the first dependency and every file is only checked once
+    dependencies.insert(dependencies.begin(), path);
+    std::vector<std::string> paths;
+    std::vector<uint64_t> sizes;
+    std::vector<uint32_t> checksums;
+    for (const std::string& dependency : dependencies) {
+        const std::string p = absPath(dependency);
+        if (std::find(paths.begin(), paths.end(), p) != paths.end())
+            continue;
+        uint64_t size = 0;
+        uint32_t checksum = 0;
+        if (!fileChecksum(p, size, checksum)) {
+            LWARNING("Result of '" << path << "' is not cached as dependency '" << p <<
+                     "' could not be read");
+            return;
+        }
+        paths.push_back(p);
+        sizes.push_back(size);
+        checksums.push_back(checksum);
+    }
+
+    Buffer payload;
+    payload.serialize(paths);
+    payload.serialize(sizes);
+    payload.serialize(checksums);
+    payload.serialize(result);
+    const char* payloadData = reinterpret_cast<const char*>(payload.data());
+    const uint32_t crc = hashCRC32(payloadData, payload.size());
+
+    std::string cache;
+    cache.append(reinterpret_cast<const char*>(&ResultMagic), sizeof(ResultMagic));
+    cache.append(reinterpret_cast<const char*>(&ResultVersion), sizeof(ResultVersion));
+    cache.append(reinterpret_cast<const char*>(&crc), sizeof(crc));
+    cache.append(payloadData, payload.size());
+
+    const filesystem::File file(path, true);
+    std::string cachedFile;
+    bool success;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex());
+        success = FileSys.cacheManager()->getCachedFile(
+            file, resultCacheInformation(path, contiguousArrays), cachedFile, true
+        );
+    }
+    if (!success || !writeFileAtomically(cachedFile, cache))
+        LWARNING("Could not write cached result file for '" << path << "'");
+}
+
+/**
+ * Executes the script at the absolute <code>path</code> in the <code>state</code> and
+ * adds the returned table to the <code>dictionary</code>. If <code>cacheResult</code> is
+ * <code>true</code>, the files loaded by the script are recorded and the result is
+ * stored with #storeCachedResult.
+ */
+bool executeDictionaryScript(const std::string& path, Dictionary& dictionary,
+                             lua_State* state, bool contiguousArrays, ScriptCache cache,
+                             bool cacheResult)
+{
+    const static std::string _loggerCat = "lua_loadDictionaryFromFile";
+
+    LDEBUG("Loading dictionary script '" << path << "'");
+    int status = (cache != ScriptCache::None) ?
+        loadCachedScript(state, path) :
+        luaL_loadfile(state, path.c_str());
+    if (status != LUA_OK) {
+        LERROR("Error loading script: '" << lua_tostring(state, -1) << "'");
+        return false;
+    }
+
+    LDEBUG("Executing script");
+    std::vector<std::string> dependencies;
+    if (cacheResult)
+        startRecordingDependencies(state, dependencies);
+    status = lua_pcall(state, 0, LUA_MULTRET, 0);
+    if (cacheResult)
+        stopRecordingDependencies(state);
+    if (status != LUA_OK) {
+        LERROR("Error executing script: " << lua_tostring(state, -1));
+        return false;
+    }
+
+    if (lua_isnil(state, -1)) {
+        LERROR("Error in script: '" << path << "'. Script did not return anything.");
+        return false;
+    }
+
+    if (!lua_istable(state, -1)) {
+        LERROR("Error in script: '" << path << "'. Script did not return a table.");
+        return false;
+    }
+
+    const bool isEmpty = dictionary.empty();
+    luaDictionaryFromState(state, dictionary, contiguousArrays);
+
+    if (cacheResult) {
+        // Only the values returned by the script are cached, not the provided ones
+        if (isEmpty) {
+            storeCachedResult(
+                path, std::move(dependencies), dictionary, contiguousArrays
+            );
+        }
+        else {
+            Dictionary result;
+            luaDictionaryFromState(state, result, contiguousArrays);
+            storeCachedResult(path, std::move(dependencies), result, contiguousArrays);
+        }
+    }
+
+    // Clean up after ourselves by cleaning the stack
+    lua_settop(state, 0);
+
+    return true;
+}
+
+/// Logs the error message at the top of the stack before Lua aborts the application
+int panic(lua_State* state) {
+    const std::string _loggerCat = "lua_panic";
+    LFATAL("Unprotected error in Lua: " << lua_tostring(state, -1));
+    return 0;
+}
+
+/// Opens all standard libraries in the state, so that it can be called protected
+int openLibraries(lua_State* state) {
+    luaL_openlibs(state);
+    return 0;
+}
+
 std::string luaTableToString(lua_State* state, bool& success, int tableLocation = -2) {
     static const int KEY = -2;
     static const int VAL = -1;
@@ -142,86 +633,61 @@ std::string logStack(lua_State* state, LogManager::LogLevel level) {
 bool loadDictionaryFromFile(
     const std::string& filename,
     ghoul::Dictionary& dictionary,
-    lua_State* state
+    lua_State* state,
+    bool contiguousArrays,
+    ScriptCache cache
     )
 {
     const static std::string _loggerCat = "lua_loadDictionaryFromFile";
 
-    if (state == nullptr) {
-        if (_state == nullptr) {
-            LDEBUG("Creating Lua state");
-            _state = luaL_newstate();
-            if (_state == nullptr) {
-                LFATAL("Error creating new Lua state: Memory allocation error");
-                return false;
-            }
-            LDEBUG("Open libraries");
-            luaL_openlibs(_state);
-        }
-        state = _state;
-    }
-
     if (filename.empty()) {
         LERROR("Filename was empty");
         return false;
     }
 
-    if (!FileSys.fileExists(absPath(filename))) {
-        LERROR("File '" << absPath(filename) << "' did not exist");
-        return false;
-    }
-
-    LDEBUG("Loading dictionary script '" << filename << "'");
-    int status = luaL_loadfile(state, absPath(filename).c_str());
-    if (status != LUA_OK) {
-        LERROR("Error loading script: '" << lua_tostring(state, -1) << "'");
+    const std::string path = absPath(filename);
+    if (!FileSys.fileExists(path)) {
+        LERROR("File '" << path << "' did not exist");
         return false;
     }
 
-    LDEBUG("Executing script");
-    if (lua_pcall(state, 0, LUA_MULTRET, 0)) {
-        LERROR("Error executing script: " << lua_tostring(state, -1));
-        return false;
+    const bool cacheResult = (cache == ScriptCache::Result) && FileSys.hasCacheManager();
+    if (cacheResult && loadCachedResult(path, dictionary, contiguousArrays)) {
+        LDEBUG("Loaded cached result of dictionary script '" << filename << "'");
+        return true;
     }
 
-    if (lua_isnil(state, -1)) {
-        LERROR("Error in script: '" << filename << "'. Script did not return anything.");
-        return false;
-    }
-
-    if (!lua_istable(state, -1)) {
-        LERROR("Error in script: '" << filename << "'. Script did not return a table.");
-        return false;
+    if (state == nullptr) {
+        // Each load leases its own state, so that concurrent loads do not interfere
+        LuaStatePool::Lease lease = statePool().acquire();
+        if (!lease)
+            return false;
+        return executeDictionaryScript(
+            path, dictionary, lease.state(), contiguousArrays, cache, cacheResult
+        );
     }
-
-    luaDictionaryFromState(state, dictionary);
-
-    // Clean up after ourselves by cleaning the stack
-    lua_settop(state, 0);
-
-    return true;
+    return executeDictionaryScript(
+        path, dictionary, state, contiguousArrays, cache, cacheResult
+    );
 }
 
 bool loadDictionaryFromString(
     const std::string& script,
     ghoul::Dictionary& dictionary,
-    lua_State* state
+    lua_State* state,
+    bool contiguousArrays
     )
 {
     const static std::string _loggerCat = "lua_loadDictionaryFromString";
 
     if (state == nullptr) {
-        if (_state == nullptr) {
-            LDEBUG("Creating Lua state");
-            _state = luaL_newstate();
-            if (_state == nullptr) {
-                LFATAL("Error creating new Lua state: Memory allocation error");
-                return false;
-            }
-            LDEBUG("Open libraries");
-            luaL_openlibs(_state);
-        }
-        state = _state;
+        // Each load leases its own state, so that concurrent loads do not interfere
+        LuaStatePool::Lease lease = statePool().acquire();
+        if (!lease)
+            return false;
+        return loadDictionaryFromString(
+            script, dictionary, lease.state(), contiguousArrays
+        );
     }
 
     LDEBUG("Loading dictionary script '" << script.substr(0, 12) << "[...]'");
@@ -249,13 +715,63 @@ bool loadDictionaryFromString(
         return false;
     }
 
-    luaDictionaryFromState(state, dictionary);
+    luaDictionaryFromState(state, dictionary, contiguousArrays);
 
     // Clean up after ourselves by cleaning the stack
     lua_settop(state, 0);
 
     return true;
 }
+
+bool loadDictionariesFromFiles(
+    const std::vector<std::string>& filenames,
+    std::vector<ghoul::Dictionary>& dictionaries,
+    bool contiguousArrays,
+    ScriptCache cache
+    )
+{
+    dictionaries.assign(filenames.size(), Dictionary());
+    // Not a std::vector<bool> as the elements are written concurrently
+    std::vector<char> success(filenames.size(), false);
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+    auto load = [&]() {
+        for (size_t i = next++; i < filenames.size(); i = next++) {
+            try {
+                success[i] = loadDictionaryFromFile(
+                    filenames[i],
+                    dictionaries[i],
+                    nullptr,
+                    contiguousArrays,
+                    cache
+                );
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    };
+
+    // The calling thread takes part in the loading
+    const size_t nThreads = std::min<size_t>(
+        filenames.size(),
+        std::max(std::thread::hardware_concurrency(), 1u)
+    );
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nThreads; ++i)
+        threads.emplace_back(load);
+    load();
+    for (std::thread& t : threads)
+        t.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+    return std::all_of(success.begin(), success.end(), [](char s) { return s != 0; });
+}
     
 std::string luaTypeToString(int type) {
     switch (type) {
@@ -284,74 +800,249 @@ std::string luaTypeToString(int type) {
     }
 }
 
-void luaDictionaryFromState(lua_State* state, Dictionary& dict)
-{
-    static const int KEY = -2;
-    static const int VAL = -1;
+/**
+ * Converts the Lua table at the top of the stack directly into the levels of a
+ * Dictionary. Each table is inspected once to determine its size and layout, so that the
+ * level can be reserved up front, sequences can be read with <code>lua_rawgeti</code>
+ * instead of <code>lua_next</code>, and sequences of numbers can be copied into a
+ * contiguous array. Keys are added verbatim, that is, a <code>.</code> in a key does not
+ * create a nested level, and entries of a new level are appended without searching for
+ * an existing key, as the keys of a Lua table are unique.
+ */
+class DictionaryConverter {
+public:
+    DictionaryConverter(lua_State* state, bool contiguousArrays)
+        : _state(state)
+        , _contiguousArrays(contiguousArrays)
+    {}
+
+    /// Adds the entries of the table at the top of the stack to <code>dict</code>
+    void convert(Dictionary& dict) {
+        const Layout layout = inspect();
+        convertTable(dict, layout, dict.empty());
+    }
+
+    /// Pushes a new table with the entries of <code>dict</code> onto the stack
+    static void push(lua_State* state, const Dictionary& dict) {
+        const size_t nEntries = dict._node ? dict._node->entries.size() : 0;
+        lua_createtable(state, 0, static_cast<int>(nEntries));
+        if (nEntries == 0)
+            return;
+
+        for (const Dictionary::Entry& entry : dict._node->entries) {
+            if (!pushValue(state, entry.value)) {
+                LWARNINGC("luaDictionaryToState",
+                          "Skipping key '" << entry.key() << "' of unsupported type");
+                continue;
+            }
+            // Keys that were created from a sequence are converted back into numbers
+            const std::string& key = entry.key();
+            const bool isIndex = !key.empty() && key.size() < 10 && key[0] != '0' &&
+                key.find_first_not_of("0123456789") == std::string::npos;
+            if (isIndex)
+                lua_rawseti(state, -2, std::stoi(key));
+            else {
+                lua_pushlstring(state, key.data(), key.size());
+                lua_insert(state, -2);
+                lua_rawset(state, -3);
+            }
+        }
+    }
 
-    enum class TableType {
-        Undefined = 1,  // 001
-        Map = 3,        // 010
-        Array = 5       // 101
+private:
+    /// The layout of a single Lua table
+    struct Layout {
+        /// The number of entries in the table
+        size_t nEntries;
+        /// The length of the table as reported by <code>lua_rawlen</code>
+        size_t length;
+        /// Whether the table has keys of type number
+        bool hasNumberKeys;
+        /// Whether the table has keys of type string
+        bool hasStringKeys;
+        /// Whether the keys of the table are exactly <code>1</code> to #length
+        bool isSequence;
+        /// Whether all values of the table are numbers
+        bool isNumeric;
     };
 
-    TableType type = TableType::Undefined;
+    /// Determines the layout of the table at the top of the stack
+    Layout inspect() {
+        Layout layout = { 0, lua_rawlen(_state, -1), false, false, true, true };
+        lua_pushnil(_state);
+        while (lua_next(_state, -2) != 0) {
+            const int keyType = lua_type(_state, -2);
+            if (keyType == LUA_TNUMBER) {
+                layout.hasNumberKeys = true;
+                // As there are 'length' entries, 'length' distinct integer keys in the
+                // range [1, length] cover the entire sequence
+                const lua_Number key = lua_tonumber(_state, -2);
+                layout.isSequence = layout.isSequence && key >= 1 &&
+                    key <= static_cast<lua_Number>(layout.length) &&
+                    key == static_cast<lua_Number>(static_cast<size_t>(key));
+            }
+            else {
+                layout.hasStringKeys = layout.hasStringKeys || keyType == LUA_TSTRING;
+                layout.isSequence = false;
+            }
+            layout.isNumeric = layout.isNumeric && lua_type(_state, -1) == LUA_TNUMBER;
+            ++layout.nEntries;
+            lua_pop(_state, 1);
+        }
+        layout.isSequence = layout.isSequence && layout.nEntries == layout.length;
+        return layout;
+    }
 
-    lua_pushnil(state);
-    while (lua_next(state, KEY) != 0) {
-        // get the key name
-        std::string key;
-        const int keyType = lua_type(state, KEY);
-        switch (keyType) {
-            case LUA_TNUMBER:
-                if (type == TableType::Map)
-                    throw FormattingException(
-                          "Dictionary can only contain a pure map or a pure "
-                          "array");
+    /// Adds the entries of the table at the top of the stack with the provided
+    /// <code>layout</code> to <code>dict</code>, which was empty if <code>isNew</code>
+    void convertTable(Dictionary& dict, const Layout& layout, bool isNew) {
+        if (layout.hasNumberKeys && layout.hasStringKeys)
+            throw FormattingException(
+                "Dictionary can only contain a pure map or a pure array"
+            );
 
-                type = TableType::Array;
-                key = std::to_string(lua_tointeger(state, KEY));
-                break;
-            case LUA_TSTRING:
-                if (type == TableType::Array)
-                    throw FormattingException(
-                          "Dictionary can only contain a pure map or a pure "
-                          "array");
-                type = TableType::Map;
-                key = lua_tostring(state, KEY);
-                break;
-            default:
-                LERRORC("luaTableToString", "Missing type: " << keyType);
-                break;
+        // Different number keys can result in the same string, for example 1 and 1.5
+        const bool isUnique = isNew && (layout.isSequence || !layout.hasNumberKeys);
+        dict.reserve(dict.size() + layout.nEntries);
+        if (layout.isSequence) {
+            for (size_t i = 1; i <= layout.length; ++i) {
+                lua_rawgeti(_state, -1, static_cast<int>(i));
+                addValue(dict, std::to_string(i), isUnique);
+                lua_pop(_state, 1);
+            }
+            return;
         }
 
-        // get the value
-        switch (lua_type(state, VAL)) {
-            case LUA_TNUMBER: {
-                double value = lua_tonumber(state, VAL);
-                dict.setValue(key, value);
-            } break;
-            case LUA_TBOOLEAN: {
-                bool value = (lua_toboolean(state, VAL) == 1);
-                dict.setValue(key, value);
-            } break;
+        lua_pushnil(_state);
+        while (lua_next(_state, -2) != 0) {
+            switch (lua_type(_state, -2)) {
+                case LUA_TNUMBER:
+                    addValue(dict, std::to_string(lua_tointeger(_state, -2)), isUnique);
+                    break;
+                case LUA_TSTRING: {
+                    size_t length = 0;
+                    const char* key = lua_tolstring(_state, -2, &length);
+                    addValue(dict, std::string(key, length), isUnique);
+                } break;
+                default:
+                    LERRORC("luaDictionaryFromState",
+                            "Missing type: " << lua_type(_state, -2));
+                    break;
+            }
+            lua_pop(_state, 1);
+        }
+    }
+
+    /// Adds the value at the top of the stack at the <code>key</code> to
+    /// <code>dict</code>. If <code>isUnique</code> is <code>true</code>, the
+    /// <code>key</code> does not exist in <code>dict</code> yet
+    void addValue(Dictionary& dict, std::string key, bool isUnique) {
+        Dictionary::Value value = convertValue(dict);
+        const uint64_t hash = DictionaryKey::hash(key.data(), key.size());
+        if (isUnique)
+            dict.appendValue(std::move(key), hash, std::move(value));
+        else
+            dict.insertValue(std::move(key), hash, std::move(value));
+    }
+
+    /// Converts the value at the top of the stack, which is added to <code>parent</code>
+    Dictionary::Value convertValue(const Dictionary& parent) {
+        switch (lua_type(_state, -1)) {
+            case LUA_TNUMBER:
+                return Dictionary::Value(lua_tonumber(_state, -1));
+            case LUA_TBOOLEAN:
+                // Booleans are stored as integral values, the same way as by setValue
+                return Dictionary::Value(
+                    static_cast<long long>(lua_toboolean(_state, -1) != 0)
+                );
             case LUA_TSTRING: {
-                std::string value = lua_tostring(state, VAL);
-                dict.setValue(key, value);
-            } break;
+                size_t length = 0;
+                const char* value = lua_tolstring(_state, -1, &length);
+                return Dictionary::Value(std::string(value, length));
+            }
             case LUA_TTABLE: {
-                Dictionary d;
-                luaDictionaryFromState(state, d);
-                dict.setValue(key, d);
-            } break;
+                const Layout layout = inspect();
+                if (_contiguousArrays && layout.isSequence && layout.isNumeric &&
+                    layout.length > 0)
+                {
+                    std::vector<double> values(layout.length);
+                    for (size_t i = 0; i < values.size(); ++i) {
+                        lua_rawgeti(_state, -1, static_cast<int>(i + 1));
+                        values[i] = lua_tonumber(_state, -1);
+                        lua_pop(_state, 1);
+                    }
+                    return Dictionary::Value(std::move(values));
+                }
+
+                Dictionary dict(parent.arena());
+                convertTable(dict, layout, true);
+                return Dictionary::Value(std::move(dict));
+            }
             default:
                 throw FormattingException("Unknown type: "
-                                          + std::to_string(lua_type(state, VAL)));
+                                          + std::to_string(lua_type(_state, -1)));
         }
+    }
 
-        // get back up one level
-        lua_pop(state, 1);
+    /// Pushes the <code>value</code> onto the stack and returns <code>true</code>, or
+    /// returns <code>false</code> if the value is stored in a <code>boost::any</code>
+    static bool pushValue(lua_State* state, const Dictionary::Value& value) {
+        switch (value.which()) {
+            case 0:
+                lua_pushinteger(state,
+                    static_cast<lua_Integer>(boost::get<long long>(value)));
+                return true;
+            case 1:
+                lua_pushinteger(state,
+                    static_cast<lua_Integer>(boost::get<unsigned long long>(value)));
+                return true;
+            case 2:
+                lua_pushnumber(state, boost::get<double>(value));
+                return true;
+            case 3: {
+                const std::string& v = boost::get<std::string>(value);
+                lua_pushlstring(state, v.data(), v.size());
+                return true;
+            }
+            case 4:
+                push(state, boost::get<Dictionary>(value));
+                return true;
+            case 5:
+                pushArray(state, boost::get<std::vector<long long>>(value));
+                return true;
+            case 6:
+                pushArray(state, boost::get<std::vector<double>>(value));
+                return true;
+            default:
+                return false;
+        }
     }
+
+    /// Pushes a contiguous numeric array as a sequence
+    template <typename T>
+    static void pushArray(lua_State* state, const std::vector<T>& values) {
+        lua_createtable(state, static_cast<int>(values.size()), 0);
+        for (size_t i = 0; i < values.size(); ++i) {
+            // Integral arrays are pushed as integers, floating point arrays as numbers
+            if (std::is_integral<T>::value)
+                lua_pushinteger(state, static_cast<lua_Integer>(values[i]));
+            else
+                lua_pushnumber(state, static_cast<lua_Number>(values[i]));
+            lua_rawseti(state, -2, static_cast<int>(i + 1));
+        }
+    }
+
+    lua_State* _state;
+    const bool _contiguousArrays;
+};
+
+void luaDictionaryFromState(lua_State* state, Dictionary& dict, bool contiguousArrays)
+{
+    DictionaryConverter(state, contiguousArrays).convert(dict);
+}
+
+void luaDictionaryToState(lua_State* state, const Dictionary& dict) {
+    DictionaryConverter::push(state, dict);
 }
 
 lua_State* createNewLuaState() {
@@ -368,6 +1059,32 @@ lua_State* createNewLuaState() {
     return s;
 }
 
+lua_State* createNewLuaState(lua_Alloc allocator, void* userData) {
+    const std::string _loggerCat = "createNewLuaState";
+    LDEBUG("Creating Lua state");
+    lua_State* s = lua_newstate(allocator, userData);
+    if (s == nullptr) {
+        LFATAL("Error creating new Lua state: Memory allocation error");
+        return nullptr;
+    }
+    lua_atpanic(s, panic);
+
+    // The allocator might not provide enough memory to open all libraries, so this has
+    // to happen in protected mode
+    LDEBUG("Open libraries");
+    lua_pushcfunction(s, openLibraries);
+    if (lua_pcall(s, 0, 0, 0) != LUA_OK) {
+        LFATAL("Error opening libraries: " << lua_tostring(s, -1));
+        lua_close(s);
+        return nullptr;
+    }
+    return s;
+}
+
+lua_State* createNewLuaState(LuaAllocator& allocator) {
+    return createNewLuaState(LuaAllocator::allocate, &allocator);
+}
+
 void destroyLuaState(lua_State* state) {
     lua_close(state);
 }
@@ -375,9 +1092,7 @@ void destroyLuaState(lua_State* state) {
 namespace internal {
 
 void deinitializeGlobalState() {
-    if (_state)
-        lua_close(_state);
-    _state = nullptr;
+    statePool().clear();
 }
 
 } // namespace internal
@@ -0,0 +1,188 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "ghoul/lua/luaallocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace ghoul {
+namespace lua {
+
+namespace {
+    // Returns the size class of blocks with 'bytes' bytes, which might be too large to be
+    // pooled
+    size_t sizeClass(size_t bytes, size_t granularity) {
+        return (bytes - 1) / granularity;
+    }
+}
+
+LuaAllocator::LuaAllocator(size_t memoryLimit)
+    : _current(nullptr)
+    , _end(nullptr)
+    , _statistics()
+    , _memoryLimit(memoryLimit)
+{
+    std::fill(std::begin(_freeBlocks), std::end(_freeBlocks), nullptr);
+}
+
+LuaAllocator::~LuaAllocator() {}
+
+void* LuaAllocator::allocate(void* allocator, void* pointer, size_t oldSize,
+                             size_t newSize)
+{
+    return static_cast<LuaAllocator*>(allocator)->reallocate(pointer, oldSize, newSize);
+}
+
+const LuaAllocator::Statistics& LuaAllocator::statistics() const {
+    return _statistics;
+}
+
+size_t LuaAllocator::memoryLimit() const {
+    return _memoryLimit;
+}
+
+void LuaAllocator::setMemoryLimit(size_t memoryLimit) {
+    _memoryLimit = memoryLimit;
+}
+
+void* LuaAllocator::reallocate(void* pointer, size_t oldSize, size_t newSize) {
+    // For new objects, Lua passes the type of the object rather than a size
+    if (pointer == nullptr)
+        oldSize = 0;
+
+    if (newSize == 0) {
+        if (pointer != nullptr) {
+            const size_t c = sizeClass(oldSize, Granularity);
+            if (c < NSizeClasses)
+                deallocateBlock(pointer, c);
+            else
+                std::free(pointer);
+            _statistics.currentBytes -= oldSize;
+            ++_statistics.nDeallocations;
+        }
+        return nullptr;
+    }
+
+    // Lua expects that shrinking a block never fails, so only growth is limited
+    if (_memoryLimit != 0 && newSize > oldSize &&
+        _statistics.currentBytes + (newSize - oldSize) > _memoryLimit)
+    {
+        ++_statistics.nFailedAllocations;
+        return nullptr;
+    }
+
+    const size_t oldClass = (pointer != nullptr) ?
+        sizeClass(oldSize, Granularity) :
+        NSizeClasses;
+    const size_t newClass = sizeClass(newSize, Granularity);
+
+    // Lua expects that shrinking a block never fails. If no new block can be obtained,
+    // the old one is kept, as it is at least as large as a block of the new size. A heap
+    // block that is kept for a pooled size class is treated as a block of that class from
+    // then on and is thus never returned to the heap
+    const bool isShrinking = (pointer != nullptr) && (newSize <= oldSize);
+
+    void* result = nullptr;
+    if (pointer != nullptr && oldClass == newClass && newClass < NSizeClasses) {
+        // The block is already large enough
+        result = pointer;
+    }
+    else if (oldClass >= NSizeClasses && newClass >= NSizeClasses) {
+        // Both sizes are too large to be pooled, which includes new large blocks
+        result = std::realloc(pointer, newSize);
+        if (result == nullptr) {
+            if (!isShrinking)
+                return nullptr;
+            result = pointer;
+        }
+    }
+    else {
+        // The block moves between a size class and another size class or the heap
+        result = (newClass < NSizeClasses) ?
+            allocateBlock(newClass) :
+            std::malloc(newSize);
+        if (result == nullptr) {
+            if (!isShrinking)
+                return nullptr;
+            result = pointer;
+        }
+        else if (pointer != nullptr) {
+            std::memcpy(result, pointer, std::min(oldSize, newSize));
+            if (oldClass < NSizeClasses)
+                deallocateBlock(pointer, oldClass);
+            else
+                std::free(pointer);
+        }
+    }
+
+    if (pointer == nullptr)
+        ++_statistics.nAllocations;
+    else
+        ++_statistics.nReallocations;
+    _statistics.currentBytes += newSize;
+    _statistics.currentBytes -= oldSize;
+    _statistics.peakBytes = std::max(_statistics.peakBytes, _statistics.currentBytes);
+    return result;
+}
+
+void* LuaAllocator::allocateBlock(size_t sizeClass) {
+    void* block = _freeBlocks[sizeClass];
+    if (block != nullptr) {
+        _freeBlocks[sizeClass] = *static_cast<void**>(block);
+        return block;
+    }
+
+    const size_t size = (sizeClass + 1) * Granularity;
+    if (_current == nullptr || _current + size > _end) {
+        // The remainder of the last chunk is too small and is left unused
+        std::unique_ptr<char[]> chunk(new (std::nothrow) char[ChunkSize]);
+        if (!chunk)
+            return nullptr;
+        try {
+            _chunks.push_back(std::move(chunk));
+        }
+        catch (const std::bad_alloc&) {
+            // Exceptions must not unwind through the C frames of Lua
+            return nullptr;
+        }
+        _current = _chunks.back().get();
+        _end = _current + ChunkSize;
+    }
+    block = _current;
+    _current += size;
+    return block;
+}
+
+void LuaAllocator::deallocateBlock(void* pointer, size_t sizeClass) {
+    *static_cast<void**>(pointer) = _freeBlocks[sizeClass];
+    _freeBlocks[sizeClass] = pointer;
+}
+
+} // namespace lua
+} // namespace ghoul
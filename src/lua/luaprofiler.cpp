@@ -0,0 +1,412 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "ghoul/lua/luaprofiler.h"
+#include "ghoul/lua/ghoul_lua.h"
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // The registry field that stores the LuaProfiler attached to a state
+    const char ProfilerKey = 0;
+
+    // The node that is the root of all call stacks
+    const size_t RootNode = 0;
+
+    double milliseconds(std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+}
+
+namespace ghoul {
+namespace lua {
+
+LuaProfiler::LuaProfiler(int instructionInterval)
+    : _instructionInterval(instructionInterval)
+    , _state(nullptr)
+{
+    ghoul_assert(instructionInterval > 0, "The instruction interval must be positive");
+    reset();
+}
+
+LuaProfiler::~LuaProfiler() {
+    detach();
+}
+
+void LuaProfiler::attach(lua_State* state) {
+    detach();
+    _state = state;
+    lua_pushlightuserdata(_state, this);
+    lua_rawsetp(_state, LUA_REGISTRYINDEX, &ProfilerKey);
+    lua_sethook(
+        _state,
+        hook,
+        LUA_MASKCALL | LUA_MASKRET | LUA_MASKCOUNT,
+        _instructionInterval
+    );
+    _lastSample = HighResClock::now();
+}
+
+void LuaProfiler::detach() {
+    if (_state == nullptr)
+        return;
+
+    lua_sethook(_state, nullptr, 0, 0);
+    lua_pushnil(_state);
+    lua_rawsetp(_state, LUA_REGISTRYINDEX, &ProfilerKey);
+
+    const HighResClock::time_point now = HighResClock::now();
+    for (auto& stack : _stacks) {
+        while (!stack.second.empty())
+            closeFrame(stack.second, now);
+    }
+    _stacks.clear();
+    _state = nullptr;
+}
+
+bool LuaProfiler::isAttached() const {
+    return _state != nullptr;
+}
+
+void LuaProfiler::reset() {
+    // Running functions keep their indices, so their measurements are reset in place
+    for (Function& f : _functions) {
+        f.profile.nCalls = 0;
+        f.profile.inclusiveTime = std::chrono::nanoseconds(0);
+        f.profile.exclusiveTime = std::chrono::nanoseconds(0);
+        f.profile.nInstructions = 0;
+    }
+    for (Node& n : _nodes) {
+        n.exclusiveTime = std::chrono::nanoseconds(0);
+        n.nInstructions = 0;
+    }
+    _lines.clear();
+
+    if (_nodes.empty()) {
+        Node root = { 0, RootNode, {}, std::chrono::nanoseconds(0), 0 };
+        _nodes.push_back(root);
+    }
+}
+
+std::vector<LuaProfiler::FunctionProfile> LuaProfiler::functionProfiles() const {
+    std::vector<FunctionProfile> result;
+    for (const Function& f : _functions) {
+        if (f.profile.nCalls > 0)
+            result.push_back(f.profile);
+    }
+    std::sort(
+        result.begin(),
+        result.end(),
+        [](const FunctionProfile& lhs, const FunctionProfile& rhs) {
+            return lhs.exclusiveTime > rhs.exclusiveTime;
+        }
+    );
+    return result;
+}
+
+std::vector<LuaProfiler::LineProfile> LuaProfiler::lineProfiles() const {
+    std::vector<LineProfile> result;
+    result.reserve(_lines.size());
+    for (const auto& l : _lines)
+        result.push_back(l.second);
+    std::sort(
+        result.begin(),
+        result.end(),
+        [](const LineProfile& lhs, const LineProfile& rhs) {
+            return lhs.nInstructions > rhs.nInstructions;
+        }
+    );
+    return result;
+}
+
+std::string LuaProfiler::flatProfile() const {
+    std::stringstream result;
+    result << "Lua Profile\n";
+    result << std::setw(10) << "Calls" << std::setw(16) << "Inclusive (ms)"
+           << std::setw(16) << "Exclusive (ms)" << std::setw(16) << "Instructions"
+           << "  Function\n";
+    result << std::fixed << std::setprecision(3);
+    for (const FunctionProfile& f : functionProfiles()) {
+        result << std::setw(10) << f.nCalls
+               << std::setw(16) << milliseconds(f.inclusiveTime)
+               << std::setw(16) << milliseconds(f.exclusiveTime)
+               << std::setw(16) << f.nInstructions
+               << "  " << f.name << "\n";
+    }
+    return result.str();
+}
+
+std::string LuaProfiler::collapsedStacks(StackValue value) const {
+    std::stringstream result;
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        if (i == RootNode)
+            continue;
+        const Node& n = _nodes[i];
+        const uint64_t v = (value == StackValue::Time) ?
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                n.exclusiveTime
+            ).count() :
+            n.nInstructions;
+        if (v > 0)
+            result << stackName(i) << " " << v << "\n";
+    }
+    return result.str();
+}
+
+std::string LuaProfiler::logProfile(logging::LogManager::LogLevel level) const {
+    const std::string& profile = flatProfile();
+    LogMgr.logMessage(level, profile);
+    return profile;
+}
+
+void LuaProfiler::hook(lua_State* state, lua_Debug* ar) {
+    lua_rawgetp(state, LUA_REGISTRYINDEX, &ProfilerKey);
+    LuaProfiler* profiler = static_cast<LuaProfiler*>(lua_touserdata(state, -1));
+    lua_pop(state, 1);
+    if (profiler == nullptr)
+        return;
+
+    switch (ar->event) {
+        case LUA_HOOKCALL:
+            profiler->enterFunction(state, ar, false);
+            break;
+        case LUA_HOOKTAILCALL:
+            profiler->enterFunction(state, ar, true);
+            break;
+        case LUA_HOOKRET:
+            profiler->leaveFunction(state, ar);
+            break;
+        case LUA_HOOKCOUNT:
+            profiler->countInstructions(state, ar);
+            break;
+    }
+}
+
+void LuaProfiler::enterFunction(lua_State* state, lua_Debug* ar, bool isTailCall) {
+    const size_t function = functionIndex(state, ar);
+    std::vector<Frame>& stack = _stacks[state];
+    const HighResClock::time_point now = HighResClock::now();
+
+    // A tail call replaces the calling function, which does not return on its own
+    if (isTailCall && !stack.empty())
+        closeFrame(stack, now);
+
+    const size_t parent = stack.empty() ? RootNode : stack.back().node;
+    const Frame frame = {
+        function,
+        childNode(parent, function),
+        now,
+        std::chrono::nanoseconds(0)
+    };
+    stack.push_back(frame);
+
+    Function& f = _functions[function];
+    ++f.profile.nCalls;
+    ++f.nActive;
+}
+
+void LuaProfiler::leaveFunction(lua_State* state, lua_Debug* ar) {
+    std::vector<Frame>& stack = _stacks[state];
+    if (stack.empty()) {
+        // The function was called before the profiler was attached
+        return;
+    }
+
+    // Functions that were left by an error did not return, so all frames above the
+    // returning function are closed as well
+    const size_t function = functionIndex(state, ar);
+    const auto it = std::find_if(
+        stack.rbegin(),
+        stack.rend(),
+        [function](const Frame& f) { return f.function == function; }
+    );
+    if (it == stack.rend())
+        return;
+
+    const size_t nFrames = std::distance(stack.rbegin(), it) + 1;
+    const HighResClock::time_point now = HighResClock::now();
+    for (size_t i = 0; i < nFrames; ++i)
+        closeFrame(stack, now);
+}
+
+void LuaProfiler::countInstructions(lua_State* state, lua_Debug* ar) {
+    const HighResClock::time_point now = HighResClock::now();
+    const std::chrono::nanoseconds elapsed = now - _lastSample;
+    _lastSample = now;
+
+    std::vector<Frame>& stack = _stacks[state];
+    if (stack.empty())
+        return;
+
+    const Frame& frame = stack.back();
+    _functions[frame.function].profile.nInstructions += _instructionInterval;
+    _nodes[frame.node].nInstructions += _instructionInterval;
+
+    lua_getinfo(state, "l", ar);
+    if (ar->currentline < 0)
+        return;
+    const uint64_t key = (static_cast<uint64_t>(frame.function) << 32) |
+                         static_cast<uint32_t>(ar->currentline);
+    auto it = _lines.find(key);
+    if (it == _lines.end()) {
+        LineProfile line = {
+            _functions[frame.function].profile.name,
+            ar->currentline,
+            0,
+            std::chrono::nanoseconds(0)
+        };
+        it = _lines.emplace(key, line).first;
+    }
+    it->second.nInstructions += _instructionInterval;
+    it->second.time += elapsed;
+}
+
+void LuaProfiler::closeFrame(std::vector<Frame>& stack, HighResClock::time_point now) {
+    const Frame frame = stack.back();
+    stack.pop_back();
+
+    const std::chrono::nanoseconds elapsed = now - frame.start;
+    const std::chrono::nanoseconds exclusive = elapsed - frame.childTime;
+    Function& f = _functions[frame.function];
+    f.profile.exclusiveTime += exclusive;
+    _nodes[frame.node].exclusiveTime += exclusive;
+    // For recursive functions, only the outermost call contributes the inclusive time
+    --f.nActive;
+    if (f.nActive == 0)
+        f.profile.inclusiveTime += elapsed;
+
+    if (!stack.empty())
+        stack.back().childTime += elapsed;
+}
+
+size_t LuaProfiler::functionIndex(lua_State* state, lua_Debug* ar) {
+    lua_getinfo(state, "Sf", ar);
+    const bool isC = (ar->what[0] == 'C');
+    const void* cFunction = isC ?
+        reinterpret_cast<const void*>(lua_tocfunction(state, -1)) :
+        nullptr;
+    lua_pop(state, 1);
+
+    // The fast path identifies functions by address. The source of Lua functions is
+    // only compared by address, as it is the entire script for chunks that were loaded
+    // from strings, and the bounded short source guards against a source that was
+    // collected and whose address was reused
+    const uint64_t luaKey = reinterpret_cast<uintptr_t>(ar->source) ^
+                            (static_cast<uint64_t>(ar->linedefined) << 48);
+    if (isC) {
+        auto it = _cFunctions.find(cFunction);
+        if (it != _cFunctions.end())
+            return it->second;
+    }
+    else {
+        auto it = _luaFunctions.find(luaKey);
+        if (it != _luaFunctions.end()) {
+            const LuaFunction& f = it->second;
+            if (f.source == ar->source && f.line == ar->linedefined &&
+                std::strcmp(f.shortSource.c_str(), ar->short_src) == 0)
+            {
+                return f.function;
+            }
+        }
+    }
+
+    // The slow path identifies functions by name, which also merges all closures of the
+    // same function
+    lua_getinfo(state, "n", ar);
+    std::stringstream name;
+    if (ar->what[0] == 'm')
+        name << "main chunk";
+    else if (ar->name != nullptr)
+        name << ar->name;
+    else
+        name << "function";
+    if (!isC)
+        name << " <" << ar->short_src << ":" << ar->linedefined << ">";
+    else
+        name << " [C]";
+    std::string n = name.str();
+    // The collapsed stacks use ';' as a separator
+    std::replace(n.begin(), n.end(), ';', ':');
+
+    size_t index;
+    auto it = _functionsByName.find(n);
+    if (it != _functionsByName.end())
+        index = it->second;
+    else {
+        index = _functions.size();
+        Function f = {
+            {
+                n,
+                0,
+                std::chrono::nanoseconds(0),
+                std::chrono::nanoseconds(0),
+                0
+            },
+            0
+        };
+        _functions.push_back(std::move(f));
+        _functionsByName.emplace(std::move(n), index);
+    }
+
+    if (isC)
+        _cFunctions[cFunction] = index;
+    else
+        _luaFunctions[luaKey] = { ar->source, ar->linedefined, ar->short_src, index };
+    return index;
+}
+
+size_t LuaProfiler::childNode(size_t parent, size_t function) {
+    for (size_t child : _nodes[parent].children) {
+        if (_nodes[child].function == function)
+            return child;
+    }
+    const size_t index = _nodes.size();
+    Node node = { function, parent, {}, std::chrono::nanoseconds(0), 0 };
+    _nodes.push_back(node);
+    _nodes[parent].children.push_back(index);
+    return index;
+}
+
+std::string LuaProfiler::stackName(size_t node) const {
+    std::vector<size_t> path;
+    for (size_t n = node; n != RootNode; n = _nodes[n].parent)
+        path.push_back(n);
+
+    std::string result;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        if (!result.empty())
+            result += ';';
+        result += _functions[_nodes[*it].function].profile.name;
+    }
+    return result;
+}
+
+} // namespace lua
+} // namespace ghoul
@@ -0,0 +1,211 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "ghoul/lua/luastatepool.h"
+#include "ghoul/lua/ghoul_lua.h"
+
+#include <ghoul/lua/lua_helper.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+    const std::string _loggerCat = "LuaStatePool";
+
+    // The registry field that stores a copy of the global table of a new state
+    const char* PristineGlobals = "_ghoul_pristine_globals";
+    // The registry field that stores a copy of the table of loaded modules of a new state
+    const char* PristineModules = "_ghoul_pristine_modules";
+    // The registry field in which Lua keeps the loaded modules, also known as
+    // package.loaded
+    const char* LoadedModules = "_LOADED";
+
+    // Stores a shallow copy of the table at the top of the stack in the registry
+    // 'field' and pops the table
+    void storeCopy(lua_State* state, const char* field) {
+        lua_newtable(state);
+        lua_pushnil(state);
+        while (lua_next(state, -3) != 0) {
+            lua_pushvalue(state, -2);
+            lua_insert(state, -2);
+            lua_rawset(state, -4);
+        }
+        lua_setfield(state, LUA_REGISTRYINDEX, field);
+        lua_pop(state, 1);
+    }
+
+    // Restores the table at the top of the stack to the copy stored in the registry
+    // 'field' by replacing all values that were added or changed by their pristine
+    // values, or nil, and pops the table
+    void restoreCopy(lua_State* state, const char* field) {
+        const int table = lua_gettop(state);
+        lua_getfield(state, LUA_REGISTRYINDEX, field);
+        const int pristine = table + 1;
+
+        // Assigning to existing fields is allowed while traversing a table
+        lua_pushnil(state);
+        while (lua_next(state, table) != 0) {
+            lua_pushvalue(state, -2);
+            lua_rawget(state, pristine);
+            if (!lua_rawequal(state, -1, -2)) {
+                lua_pushvalue(state, -3);
+                lua_insert(state, -2);
+                lua_rawset(state, table);
+            }
+            else
+                lua_pop(state, 1);
+            lua_pop(state, 1);
+        }
+
+        // Restore the values that were removed
+        lua_pushnil(state);
+        while (lua_next(state, pristine) != 0) {
+            lua_pushvalue(state, -2);
+            lua_insert(state, -2);
+            lua_rawset(state, table);
+        }
+        lua_settop(state, table - 1);
+    }
+}
+
+namespace ghoul {
+namespace lua {
+
+LuaStatePool::Lease::Lease(LuaStatePool* pool, lua_State* state)
+    : _pool(pool)
+    , _state(state)
+{}
+
+LuaStatePool::Lease::~Lease() {
+    if (_state)
+        _pool->release(_state);
+}
+
+LuaStatePool::Lease::Lease(Lease&& other)
+    : _pool(other._pool)
+    , _state(other._state)
+{
+    other._state = nullptr;
+}
+
+LuaStatePool::Lease& LuaStatePool::Lease::operator=(Lease&& other) {
+    if (this != &other) {
+        if (_state)
+            _pool->release(_state);
+        _pool = other._pool;
+        _state = other._state;
+        other._state = nullptr;
+    }
+    return *this;
+}
+
+lua_State* LuaStatePool::Lease::state() const {
+    return _state;
+}
+
+LuaStatePool::Lease::operator bool() const {
+    return _state != nullptr;
+}
+
+LuaStatePool::LuaStatePool(size_t maximumIdleStates)
+    : _maximumIdleStates(
+        maximumIdleStates != 0 ?
+        maximumIdleStates :
+        std::max(std::thread::hardware_concurrency(), 1u)
+    )
+{}
+
+LuaStatePool::~LuaStatePool() {
+    clear();
+}
+
+LuaStatePool::Lease LuaStatePool::acquire() {
+    lua_State* state = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_idleStates.empty()) {
+            state = _idleStates.back();
+            _idleStates.pop_back();
+        }
+    }
+    // Creating the state is the expensive part, so it happens outside of the lock
+    if (state == nullptr)
+        state = createState();
+    return Lease(this, state);
+}
+
+size_t LuaStatePool::nIdleStates() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _idleStates.size();
+}
+
+void LuaStatePool::clear() {
+    std::vector<lua_State*> states;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        states.swap(_idleStates);
+    }
+    for (lua_State* s : states)
+        destroyLuaState(s);
+}
+
+lua_State* LuaStatePool::createState() {
+    lua_State* state = createNewLuaState();
+    if (state == nullptr)
+        return nullptr;
+
+    // Remember the globals and the loaded modules as they are after opening the
+    // libraries
+    lua_pushglobaltable(state);
+    storeCopy(state, PristineGlobals);
+    lua_getfield(state, LUA_REGISTRYINDEX, LoadedModules);
+    storeCopy(state, PristineModules);
+    return state;
+}
+
+void LuaStatePool::resetState(lua_State* state) {
+    lua_settop(state, 0);
+    lua_pushglobaltable(state);
+    restoreCopy(state, PristineGlobals);
+    // Modules that were loaded with 'require' would otherwise not be loaded again
+    lua_getfield(state, LUA_REGISTRYINDEX, LoadedModules);
+    restoreCopy(state, PristineModules);
+    lua_gc(state, LUA_GCCOLLECT, 0);
+}
+
+void LuaStatePool::release(lua_State* state) {
+    resetState(state);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_idleStates.size() < _maximumIdleStates) {
+            _idleStates.push_back(state);
+            return;
+        }
+    }
+    destroyLuaState(state);
+}
+
+} // namespace lua
+} // namespace ghoul
@@ -24,6 +24,7 @@
 
 #include <ghoul/misc/buffer.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
 
 #include <lz4/lz4.h>
 
@@ -194,12 +195,13 @@ void Buffer::serialize(const char* s) {
 
 void Buffer::serialize(const value_type* data, size_t size) {
     _data.resize(_data.capacity() + size);
-    std::memcpy(_data.data() + _offsetWrite, &data, size);
+    std::memcpy(_data.data() + _offsetWrite, data, size);
     _offsetWrite += size;
 }
 
 void Buffer::deserialize(value_type* data, size_t size) {
-    std::memcpy(data, &_data + _offsetRead, size);
+    assert(_offsetRead + size <= _data.size());
+    std::memcpy(data, _data.data() + _offsetRead, size);
     _offsetRead += size;
 }
 
@@ -256,6 +258,186 @@ void Buffer::deserialize(std::vector<std::string>& v) {
     }
 }
 
+template<>
+void Buffer::serialize(const Dictionary& v) {
+    typedef Dictionary::SerializedType SerializedType;
+    const long long* integral;
+    const double* floating;
+    size_t size;
+
+    // Values of types that are not handled by the Dictionary's conversions cannot be
+    // serialized and are skipped
+    size_t n = 0;
+    if (v._node) {
+        for (const Dictionary::Entry& e : v._node->entries) {
+            const SerializedType type =
+                Dictionary::serializedType(e.value, integral, floating, size);
+            if (type == SerializedType::Unsupported) {
+                LWARNING("Skipping key '" << e.key() << "' of unsupported type '"
+                         << Dictionary::valueType(e.value).name() << "'");
+            }
+            else
+                ++n;
+        }
+    }
+    serialize(n);
+
+    if (n == 0)
+        return;
+    for (const Dictionary::Entry& e : v._node->entries) {
+        const SerializedType type =
+            Dictionary::serializedType(e.value, integral, floating, size);
+        if (type == SerializedType::Unsupported)
+            continue;
+
+        serialize(e.key());
+        serialize(static_cast<unsigned char>(type));
+        switch (type) {
+            case SerializedType::Integral:
+                serialize(boost::get<long long>(e.value));
+                break;
+            case SerializedType::UnsignedIntegral:
+                serialize(boost::get<unsigned long long>(e.value));
+                break;
+            case SerializedType::Floating:
+                serialize(boost::get<double>(e.value));
+                break;
+            case SerializedType::String:
+                serialize(boost::get<std::string>(e.value));
+                break;
+            case SerializedType::Dictionary:
+                serialize(boost::get<Dictionary>(e.value));
+                break;
+            case SerializedType::IntegralArray:
+                serialize(size);
+                serialize(reinterpret_cast<const value_type*>(integral),
+                          size * sizeof(long long));
+                break;
+            case SerializedType::FloatingArray:
+                serialize(size);
+                serialize(reinterpret_cast<const value_type*>(floating),
+                          size * sizeof(double));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+bool Buffer::deserialize(Dictionary& v) {
+    typedef Dictionary::SerializedType SerializedType;
+
+    struct Pending {
+        std::string key;
+        Dictionary::Value value;
+    };
+
+    size_t n;
+    if (!canRead(sizeof(n)))
+        return false;
+    deserialize(n);
+    // Every value occupies at least its key length and its type
+    if (n > (_offsetWrite - _offsetRead) / (sizeof(size_t) + 1))
+        return false;
+
+    // The values are only added to v once the whole level was read successfully
+    std::vector<Pending> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::string key;
+        unsigned char type;
+        if (!deserializeChecked(key) || !canRead(sizeof(type)))
+            return false;
+        deserialize(type);
+
+        Dictionary::Value value;
+        switch (static_cast<SerializedType>(type)) {
+            case SerializedType::Integral: {
+                long long val;
+                if (!canRead(sizeof(val)))
+                    return false;
+                deserialize(val);
+                value = val;
+            } break;
+            case SerializedType::UnsignedIntegral: {
+                unsigned long long val;
+                if (!canRead(sizeof(val)))
+                    return false;
+                deserialize(val);
+                value = val;
+            } break;
+            case SerializedType::Floating: {
+                double val;
+                if (!canRead(sizeof(val)))
+                    return false;
+                deserialize(val);
+                value = val;
+            } break;
+            case SerializedType::String: {
+                std::string val;
+                if (!deserializeChecked(val))
+                    return false;
+                value = std::move(val);
+            } break;
+            case SerializedType::Dictionary: {
+                Dictionary val;
+                if (!deserialize(val))
+                    return false;
+                value = std::move(val);
+            } break;
+            case SerializedType::IntegralArray: {
+                size_t size;
+                if (!canRead(sizeof(size)))
+                    return false;
+                deserialize(size);
+                if (size > (_offsetWrite - _offsetRead) / sizeof(long long))
+                    return false;
+                std::vector<long long> val(size);
+                deserialize(reinterpret_cast<value_type*>(val.data()),
+                            size * sizeof(long long));
+                value = std::move(val);
+            } break;
+            case SerializedType::FloatingArray: {
+                size_t size;
+                if (!canRead(sizeof(size)))
+                    return false;
+                deserialize(size);
+                if (size > (_offsetWrite - _offsetRead) / sizeof(double))
+                    return false;
+                std::vector<double> val(size);
+                deserialize(reinterpret_cast<value_type*>(val.data()),
+                            size * sizeof(double));
+                value = std::move(val);
+            } break;
+            default:
+                LERROR("Unknown type '" << static_cast<int>(type) << "' for key '"
+                       << key << "'");
+                return false;
+        }
+        values.push_back({ std::move(key), std::move(value) });
+    }
+
+    for (Pending& p : values) {
+        const uint64_t hash = DictionaryKey::hash(p.key.data(), p.key.size());
+        v.insertValue(std::move(p.key), hash, std::move(p.value));
+    }
+    return true;
+}
+
+bool Buffer::canRead(size_t size) const {
+    return _offsetRead <= _offsetWrite && size <= _offsetWrite - _offsetRead;
+}
 
+bool Buffer::deserializeChecked(std::string& v) {
+    size_t size;
+    if (!canRead(sizeof(size)))
+        return false;
+    deserialize(size);
+    if (!canRead(size))
+        return false;
+    v = std::string(reinterpret_cast<char*>(_data.data() + _offsetRead), size);
+    _offsetRead += size;
+    return true;
+}
 
 } // namespace owl
\ No newline at end of file
@@ -29,6 +29,9 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
 
 using std::string;
 
@@ -41,6 +44,48 @@ using std::string;
 namespace {
 const std::string _loggerCat = "Dictionary";
 
+// Up to this number of entries, a level of the Dictionary is searched linearly without
+// maintaining the open-addressing index
+const size_t LinearSearchThreshold = 8;
+
+// The finalizer of the SplitMix64 generator, which distributes the bits of 'value' over
+// the entire result
+uint64_t mixHash(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// Finishes the hash of a level from the combined hashes of its 'nEntries' entries. 0
+// marks a cached hash that has not been computed yet and is never returned, so that
+// levels with equal contents have the same hash whether or not they are allocated
+uint64_t levelHash(uint64_t nEntries, uint64_t entries) {
+    const uint64_t result = mixHash(nEntries + entries);
+    return result != 0 ? result : 1;
+}
+
+// Returns the bit pattern of 'value' such that values that compare equal have the same
+// pattern
+uint64_t floatingBits(double value) {
+    if (value == 0.0)
+        value = 0.0;
+    uint64_t result;
+    std::memcpy(&result, &value, sizeof(uint64_t));
+    return result;
+}
+
+// Determines whether the keys of new entries are stored in the intern table
+std::atomic<bool> KeyInterning(false);
+
+// Returns the copy of 'key' that is stored in the process-wide intern table. The table is
+// never destroyed so that the interned keys outlive any static Dictionary
+const std::string* internKey(std::string key) {
+    static std::mutex mutex;
+    static std::unordered_set<std::string>* keys = new std::unordered_set<std::string>;
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*keys->insert(std::move(key)).first;
+}
+
 typedef long long IntegralType;
 typedef unsigned long long UnsignedIntegralType;
 typedef double FloatingType;
@@ -126,39 +171,42 @@ bool isConvertible(const Dictionary& dict) {
     if (!correctSize)
         return false;
 
-    const std::vector<std::string>& keys = dict.keys();
-    for (size_t i = 0; i < StorageTypeConverter<TargetType>::size; ++i) {
-        const std::string& key = keys[i];
+    bool correctType = true;
+    dict.forEach([&dict, &correctType](const std::string& key, const Dictionary*) {
 #ifdef WIN32
 #pragma warning(push)
     // Suppress the warning C2684 (Redundant test) that occurs if
     // StorageTypeConverter<TargetType>::type == TargetType
 #pragma warning(suppress: 6287)
 #endif // WIN32
-        const bool correctType = dict.hasValue<typename StorageTypeConverter<TargetType>::type>(
-                                       key) || dict.hasValue<TargetType>(key);
+        correctType = correctType &&
+            (dict.hasValue<typename StorageTypeConverter<TargetType>::type>(key) ||
+             dict.hasValue<TargetType>(key));
 #ifdef WIN32
 #pragma warning(pop)
 #endif // WIN32
-        if (!correctType)
-            return false;
-    }
-    return true;
+    });
+    return correctType;
 }
 
 template <typename TargetType>
 void convertGLM(const Dictionary& dict, TargetType& target) {
-    std::vector<std::string>&& keys = dict.keys();
+    // The size of the Dictionary has already been checked by isConvertible
+    std::array<const std::string*, StorageTypeConverter<TargetType>::size> keys;
+    size_t n = 0;
+    dict.forEach([&keys, &n](const std::string& key, const Dictionary*) {
+        keys[n++] = &key;
+    });
     // sort numerically rather than by ASCII value
-    std::sort(keys.begin(), keys.end(), [](const std::string& k1, const std::string& k2) {
+    std::sort(keys.begin(), keys.end(), [](const std::string* k1, const std::string* k2) {
         try {
-            return std::stoi(k1) < std::stoi(k2);
+            return std::stoi(*k1) < std::stoi(*k2);
         } catch (std::invalid_argument&) {
-            return k1 < k2;
+            return *k1 < *k2;
         }
     });
     for (size_t i = 0; i < StorageTypeConverter<TargetType>::size; ++i) {
-        const std::string& key = keys[i];
+        const std::string& key = *keys[i];
         dict.getValue(key, glm::value_ptr(target)[i]);
     }
 }
@@ -167,30 +215,136 @@ template <typename TargetType>
 void convert(const Dictionary& dict, TargetType& target) {
     static_assert(StorageTypeConverter<TargetType>::size == 1,
                   "Wrong function call. StorageType::size > 1");
-    const std::vector<std::string>& keys = dict.keys();
-    for (size_t i = 0; i < StorageTypeConverter<TargetType>::size; ++i) {
-        const std::string& key = keys[i];
+    dict.forEach([&dict, &target](const std::string& key, const Dictionary*) {
         dict.getValue(key, target);
+    });
+}
+
+template <typename TargetType>
+typename std::enable_if<std::is_arithmetic<TargetType>::value, TargetType*>::type
+elementPointer(TargetType& target) {
+    return &target;
+}
+
+template <typename TargetType>
+typename std::enable_if<!std::is_arithmetic<TargetType>::value,
+                        typename TargetType::value_type*>::type
+elementPointer(TargetType& target) {
+    return glm::value_ptr(target);
+}
+
+template <typename TargetType>
+bool isArrayConvertible(const Dictionary& dict, Dictionary::KeyView key) {
+    const size_t size = StorageTypeConverter<TargetType>::size;
+    typedef std::vector<FloatingType> FloatingArray;
+    typedef std::vector<IntegralType> IntegralArray;
+
+    const FloatingArray* const f = dict.valuePtr<FloatingArray>(key);
+    if (f != nullptr)
+        return f->size() == size;
+    const IntegralArray* const i = dict.valuePtr<IntegralArray>(key);
+    return (i != nullptr) && (i->size() == size);
+}
+
+template <typename TargetType, typename SourceType>
+void convertArray(const std::vector<SourceType>& source, TargetType& target) {
+    typedef typename std::remove_pointer<decltype(elementPointer(target))>::type Element;
+    Element* const elements = elementPointer(target);
+    for (size_t i = 0; i < source.size(); ++i)
+        elements[i] = static_cast<Element>(source[i]);
+}
+
+template <typename TargetType>
+bool convertArray(const Dictionary& dict, Dictionary::KeyView key, TargetType& target) {
+    if (!isArrayConvertible<TargetType>(dict, key))
+        return false;
+
+    typedef std::vector<FloatingType> FloatingArray;
+    typedef std::vector<IntegralType> IntegralArray;
+    const FloatingArray* const f = dict.valuePtr<FloatingArray>(key);
+    if (f != nullptr)
+        convertArray(*f, target);
+    else
+        convertArray(*dict.valuePtr<IntegralArray>(key), target);
+    return true;
+}
+
+// The following functions perform the same conversions as the getValue specializations,
+// but on a stored 'value' that has already been found
+
+template <typename Variant, typename TargetType>
+bool convertArrayValue(const Variant& value, TargetType& target) {
+    const size_t size = StorageTypeConverter<TargetType>::size;
+    typedef std::vector<FloatingType> FloatingArray;
+    typedef std::vector<IntegralType> IntegralArray;
+
+    if (const FloatingArray* const f = boost::get<FloatingArray>(&value)) {
+        if (f->size() != size)
+            return false;
+        convertArray(*f, target);
+        return true;
+    }
+    if (const IntegralArray* const i = boost::get<IntegralArray>(&value)) {
+        if (i->size() != size)
+            return false;
+        convertArray(*i, target);
+        return true;
+    }
+    return false;
+}
+
+template <typename Variant, typename TargetType>
+bool convertScalarValue(const Variant& value, TargetType& target) {
+    typedef typename StorageTypeConverter<TargetType>::type StorageType;
+    if (const StorageType* const v = boost::get<StorageType>(&value)) {
+        target = static_cast<TargetType>(*v);
+        return true;
+    }
+    const Dictionary* const dict = boost::get<Dictionary>(&value);
+    if ((dict != nullptr) && isConvertible<TargetType>(*dict)) {
+        convert(*dict, target);
+        return true;
     }
+    return convertArrayValue(value, target);
+}
+
+template <typename Variant, typename TargetType>
+bool convertGLMValue(const Variant& value, TargetType& target) {
+    typedef std::array<typename StorageTypeConverter<TargetType>::type,
+                       StorageTypeConverter<TargetType>::size> StorageType;
+    const boost::any* const any = boost::get<boost::any>(&value);
+    const StorageType* const v = (any != nullptr) ?
+        boost::any_cast<StorageType>(any) :
+        nullptr;
+    if (v != nullptr) {
+        typedef typename TargetType::value_type Element;
+        for (size_t i = 0; i < v->size(); ++i)
+            glm::value_ptr(target)[i] = static_cast<Element>((*v)[i]);
+        return true;
+    }
+    const Dictionary* const dict = boost::get<Dictionary>(&value);
+    if ((dict != nullptr) && isConvertible<TargetType>(*dict)) {
+        convertGLM(*dict, target);
+        return true;
+    }
+    return convertArrayValue(value, target);
 }
 
 // Yes, all those functions could be replaced by a macro (and they were), but they are
 // easier to read (and debug!) this way ---abock
 template <>
-bool Dictionary::hasValue<double>(const std::string& key) const {
+bool Dictionary::hasValue<double>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<double>::type>(key);
     if (val)
     return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<double>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<double>(*dict);
             if (canConvert)
             return true;
         }
-        return false;
+        return isArrayConvertible<double>(*this, key);
     }
 }
 
@@ -198,15 +352,11 @@ template <>
 bool Dictionary::setValue<double>(std::string key, double value, bool 
                                   createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<double>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<double>(const std::string& key, double& value) const {
+bool Dictionary::getValue<double>(KeyView key, double& value) const {
     StorageTypeConverter<double>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<double>::type>(key);
     if (success) {
@@ -215,35 +365,31 @@ bool Dictionary::getValue<double>(const std::string& key, double& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<double>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<double>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<long long>(const std::string& key) const {
+bool Dictionary::hasValue<long long>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<long long>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<long long>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<long long>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<long long>(*this, key);
     }
 }
 
@@ -251,15 +397,11 @@ template <>
 bool Dictionary::setValue<long long>(std::string key, long long value,
                                      bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<long long>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<long long>(const std::string& key, long long& value) const {
+bool Dictionary::getValue<long long>(KeyView key, long long& value) const {
     StorageTypeConverter<long long>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<long long>::type>(key);
     if (success) {
@@ -268,35 +410,31 @@ bool Dictionary::getValue<long long>(const std::string& key, long long& value) c
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<long long>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<long long>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<unsigned long long>(const std::string& key) const {
+bool Dictionary::hasValue<unsigned long long>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<unsigned long long>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned long long>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned long long>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<unsigned long long>(*this, key);
     }
 }
 
@@ -304,15 +442,11 @@ template <>
 bool Dictionary::setValue<unsigned long long>(std::string key, unsigned long long value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<unsigned long long>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<unsigned long long>(const std::string& key,
+bool Dictionary::getValue<unsigned long long>(KeyView key,
                             unsigned long long& value) const
 {
     StorageTypeConverter<unsigned long long>::type v;
@@ -324,35 +458,31 @@ bool Dictionary::getValue<unsigned long long>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned long long>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned long long>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<bool>(const std::string& key) const {
+bool Dictionary::hasValue<bool>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<bool>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<bool>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<bool>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<bool>(*this, key);
     }
 }
 
@@ -360,15 +490,11 @@ template <>
 bool Dictionary::setValue<bool>(std::string key, bool value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<bool>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<bool>(const std::string& key, bool& value) const {
+bool Dictionary::getValue<bool>(KeyView key, bool& value) const {
     StorageTypeConverter<bool>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<bool>::type>(key);
     if (success) {
@@ -377,35 +503,31 @@ bool Dictionary::getValue<bool>(const std::string& key, bool& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<bool>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<bool>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<char>(const std::string& key) const {
+bool Dictionary::hasValue<char>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<char>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<char>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<char>(*this, key);
     }
 }
 
@@ -413,15 +535,11 @@ template <>
 bool Dictionary::setValue<char>(std::string key, char value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<char>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<char>(const std::string& key, char& value) const {
+bool Dictionary::getValue<char>(KeyView key, char& value) const {
     StorageTypeConverter<char>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<char>::type>(key);
     if (success) {
@@ -430,35 +548,31 @@ bool Dictionary::getValue<char>(const std::string& key, char& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<char>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<signed char>(const std::string& key) const {
+bool Dictionary::hasValue<signed char>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<signed char>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<signed char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<signed char>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<signed char>(*this, key);
     }
 }
 
@@ -466,15 +580,11 @@ template <>
 bool Dictionary::setValue<signed char>(std::string key, signed char value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<signed char>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<signed char>(const std::string& key, signed char& value) const {
+bool Dictionary::getValue<signed char>(KeyView key, signed char& value) const {
     StorageTypeConverter<signed char>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<signed char>::type>(key);
     if (success) {
@@ -483,35 +593,31 @@ bool Dictionary::getValue<signed char>(const std::string& key, signed char& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<signed char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<signed char>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<unsigned char>(const std::string& key) const {
+bool Dictionary::hasValue<unsigned char>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<unsigned char>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned char>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<unsigned char>(*this, key);
     }
 }
 
@@ -519,15 +625,11 @@ template <>
 bool Dictionary::setValue<unsigned char>(std::string key, unsigned char value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<unsigned char>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<unsigned char>(const std::string& key,
+bool Dictionary::getValue<unsigned char>(KeyView key,
                                          unsigned char& value) const
 {
     StorageTypeConverter<unsigned char>::type v;
@@ -538,35 +640,31 @@ bool Dictionary::getValue<unsigned char>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned char>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned char>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<wchar_t>(const std::string& key) const {
+bool Dictionary::hasValue<wchar_t>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<wchar_t>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<wchar_t>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<wchar_t>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<wchar_t>(*this, key);
     }
 }
 
@@ -574,15 +672,11 @@ template <>
 bool Dictionary::setValue<wchar_t>(std::string key, wchar_t value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<wchar_t>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<wchar_t>(const std::string& key, wchar_t& value) const {
+bool Dictionary::getValue<wchar_t>(KeyView key, wchar_t& value) const {
     StorageTypeConverter<wchar_t>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<wchar_t>::type>(key);
     if (success) {
@@ -591,35 +685,31 @@ bool Dictionary::getValue<wchar_t>(const std::string& key, wchar_t& value) const
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<wchar_t>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<wchar_t>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<short>(const std::string& key) const {
+bool Dictionary::hasValue<short>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<short>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<short>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<short>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<short>(*this, key);
     }
 }
 
@@ -627,15 +717,11 @@ template <>
 bool Dictionary::setValue<short>(std::string key, short value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<short>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<short>(const std::string& key, short& value) const {
+bool Dictionary::getValue<short>(KeyView key, short& value) const {
     StorageTypeConverter<short>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<short>::type>(key);
     if (success) {
@@ -644,35 +730,31 @@ bool Dictionary::getValue<short>(const std::string& key, short& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<short>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<short>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<unsigned short>(const std::string& key) const {
+bool Dictionary::hasValue<unsigned short>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<unsigned short>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned short>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned short>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<unsigned short>(*this, key);
     }
 }
 
@@ -680,15 +762,11 @@ template <>
 bool Dictionary::setValue<unsigned short>(std::string key, unsigned short value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<unsigned short>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<unsigned short>(const std::string& key, 
+bool Dictionary::getValue<unsigned short>(KeyView key, 
                                           unsigned short& value) const
 {
     StorageTypeConverter<unsigned short>::type v;
@@ -699,49 +777,42 @@ bool Dictionary::getValue<unsigned short>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned short>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned short>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<int>(const std::string& key) const {
+bool Dictionary::hasValue<int>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<int>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<int>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<int>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<int>(*this, key);
     }
 }
 
 template <>
-bool Dictionary::setValue<int>(std::string key, int value, bool createIntermediate) {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<int>::type(value),
-        createIntermediate
-    );
+bool Dictionary::setValue<int>(std::string key, int value, bool createIntermediate)
+{
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<int>(const std::string& key, int& value) const {
+bool Dictionary::getValue<int>(KeyView key, int& value) const {
     StorageTypeConverter<int>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<int>::type>(key);
     if (success) {
@@ -750,35 +821,31 @@ bool Dictionary::getValue<int>(const std::string& key, int& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<int>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<int>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<unsigned int>(const std::string& key) const {
+bool Dictionary::hasValue<unsigned int>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<unsigned int>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned int>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned int>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<unsigned int>(*this, key);
     }
 }
 
@@ -786,15 +853,11 @@ template <>
 bool Dictionary::setValue<unsigned int>(std::string key, unsigned int value,
                                 bool createIntermediate)
 {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<unsigned int>::type(value),
-        createIntermediate
-    );
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<unsigned int>(const std::string& key,
+bool Dictionary::getValue<unsigned int>(KeyView key,
                                         unsigned int& value) const
 {
     StorageTypeConverter<unsigned int>::type v;
@@ -805,49 +868,42 @@ bool Dictionary::getValue<unsigned int>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<unsigned int>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<unsigned int>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<float>(const std::string& key) const {
+bool Dictionary::hasValue<float>(KeyView key) const {
     const bool val = hasValueHelper<StorageTypeConverter<float>::type>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<float>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<float>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<float>(*this, key);
     }
 }
 
 template <>
-bool Dictionary::setValue<float>(std::string key, float value, bool createIntermediate) {
-    return setValueHelper(
-        std::move(key),
-        StorageTypeConverter<float>::type(value),
-        createIntermediate
-    );
+bool Dictionary::setValue<float>(std::string key, float value, bool createIntermediate)
+{
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<float>(const std::string& key, float& value) const {
+bool Dictionary::getValue<float>(KeyView key, float& value) const {
     StorageTypeConverter<float>::type v;
     const bool success = hasValueHelper<StorageTypeConverter<float>::type>(key);
     if (success) {
@@ -856,37 +912,33 @@ bool Dictionary::getValue<float>(const std::string& key, float& value) const {
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<float>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<float>(*dict);
             if (canConvert) {
-                convert(dict, value);
+                convert(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::vec2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::vec2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec2>::type,
                                         StorageTypeConverter<glm::vec2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::vec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::vec2>(*this, key);
     }
 }
 
@@ -894,15 +946,11 @@ template <>
 bool Dictionary::setValue<glm::vec2>(std::string key, glm::vec2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::vec2::value_type,
-        StorageTypeConverter<glm::vec2>::type,
-        StorageTypeConverter<glm::vec2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::vec2>(const std::string& key, glm::vec2& value) const {
+bool Dictionary::getValue<glm::vec2>(KeyView key, glm::vec2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec2>::type,
                                         StorageTypeConverter<glm::vec2>::size>>(key);
@@ -914,37 +962,33 @@ bool Dictionary::getValue<glm::vec2>(const std::string& key, glm::vec2& value) c
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::vec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dvec2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dvec2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec2>::type,
                                         StorageTypeConverter<glm::dvec2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dvec2>(*this, key);
     }
 }
 
@@ -952,15 +996,11 @@ template <>
 bool Dictionary::setValue<glm::dvec2>(std::string key, glm::dvec2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dvec2::value_type,
-        StorageTypeConverter<glm::dvec2>::type,
-        StorageTypeConverter<glm::dvec2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dvec2>(const std::string& key, glm::dvec2& value) const {
+bool Dictionary::getValue<glm::dvec2>(KeyView key, glm::dvec2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec2>::type,
                                         StorageTypeConverter<glm::dvec2>::size>>(key);
@@ -972,37 +1012,33 @@ bool Dictionary::getValue<glm::dvec2>(const std::string& key, glm::dvec2& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::ivec2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::ivec2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec2>::type,
                                         StorageTypeConverter<glm::ivec2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::ivec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::ivec2>(*this, key);
     }
 }
 
@@ -1010,15 +1046,11 @@ template <>
 bool Dictionary::setValue<glm::ivec2>(std::string key, glm::ivec2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::ivec2::value_type,
-        StorageTypeConverter<glm::ivec2>::type,
-        StorageTypeConverter<glm::ivec2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::ivec2>(const std::string& key, glm::ivec2& value) const {
+bool Dictionary::getValue<glm::ivec2>(KeyView key, glm::ivec2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec2>::type,
                                         StorageTypeConverter<glm::ivec2>::size>>(key);
@@ -1030,37 +1062,33 @@ bool Dictionary::getValue<glm::ivec2>(const std::string& key, glm::ivec2& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::ivec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::uvec2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::uvec2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec2>::type,
                                         StorageTypeConverter<glm::uvec2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::uvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::uvec2>(*this, key);
     }
 }
 
@@ -1068,15 +1096,11 @@ template <>
 bool Dictionary::setValue<glm::uvec2>(std::string key, glm::uvec2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::uvec2::value_type,
-        StorageTypeConverter<glm::uvec2>::type,
-        StorageTypeConverter<glm::uvec2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::uvec2>(const std::string& key, glm::uvec2& value) const {
+bool Dictionary::getValue<glm::uvec2>(KeyView key, glm::uvec2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec2>::type,
                                         StorageTypeConverter<glm::uvec2>::size>>(key);
@@ -1088,37 +1112,33 @@ bool Dictionary::getValue<glm::uvec2>(const std::string& key, glm::uvec2& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::uvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::bvec2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::bvec2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec2>::type,
                                         StorageTypeConverter<glm::bvec2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::bvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::bvec2>(*this, key);
     }
 }
 
@@ -1126,15 +1146,11 @@ template <>
 bool Dictionary::setValue<glm::bvec2>(std::string key, glm::bvec2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::bvec2::value_type,
-        StorageTypeConverter<glm::bvec2>::type,
-        StorageTypeConverter<glm::bvec2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::bvec2>(const std::string& key, glm::bvec2& value) const {
+bool Dictionary::getValue<glm::bvec2>(KeyView key, glm::bvec2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec2>::type,
                                         StorageTypeConverter<glm::bvec2>::size>>(key);
@@ -1146,37 +1162,33 @@ bool Dictionary::getValue<glm::bvec2>(const std::string& key, glm::bvec2& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::bvec2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::vec3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::vec3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec3>::type,
                                         StorageTypeConverter<glm::vec3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::vec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::vec3>(*this, key);
     }
 }
 
@@ -1184,15 +1196,11 @@ template <>
 bool Dictionary::setValue<glm::vec3>(std::string key, glm::vec3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::vec3::value_type,
-        StorageTypeConverter<glm::vec3>::type,
-        StorageTypeConverter<glm::vec3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::vec3>(const std::string& key, glm::vec3& value) const {
+bool Dictionary::getValue<glm::vec3>(KeyView key, glm::vec3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec3>::type,
                                         StorageTypeConverter<glm::vec3>::size>>(key);
@@ -1204,37 +1212,33 @@ bool Dictionary::getValue<glm::vec3>(const std::string& key, glm::vec3& value) c
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::vec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dvec3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dvec3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec3>::type,
                                         StorageTypeConverter<glm::dvec3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dvec3>(*this, key);
     }
 }
 
@@ -1242,15 +1246,11 @@ template <>
 bool Dictionary::setValue<glm::dvec3>(std::string key, glm::dvec3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dvec3::value_type,
-        StorageTypeConverter<glm::dvec3>::type,
-        StorageTypeConverter<glm::dvec3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dvec3>(const std::string& key, glm::dvec3& value) const {
+bool Dictionary::getValue<glm::dvec3>(KeyView key, glm::dvec3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec3>::type,
                                         StorageTypeConverter<glm::dvec3>::size>>(key);
@@ -1262,37 +1262,33 @@ bool Dictionary::getValue<glm::dvec3>(const std::string& key, glm::dvec3& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::ivec3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::ivec3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec3>::type,
                                         StorageTypeConverter<glm::ivec3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::ivec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::ivec3>(*this, key);
     }
 }
 
@@ -1300,15 +1296,11 @@ template <>
 bool Dictionary::setValue<glm::ivec3>(std::string key, glm::ivec3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::ivec3::value_type,
-        StorageTypeConverter<glm::ivec3>::type,
-        StorageTypeConverter<glm::ivec3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::ivec3>(const std::string& key, glm::ivec3& value) const {
+bool Dictionary::getValue<glm::ivec3>(KeyView key, glm::ivec3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec3>::type,
                                         StorageTypeConverter<glm::ivec3>::size>>(key);
@@ -1320,37 +1312,33 @@ bool Dictionary::getValue<glm::ivec3>(const std::string& key, glm::ivec3& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::ivec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::uvec3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::uvec3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec3>::type,
                                         StorageTypeConverter<glm::uvec3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::uvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::uvec3>(*this, key);
     }
 }
 
@@ -1358,15 +1346,11 @@ template <>
 bool Dictionary::setValue<glm::uvec3>(std::string key, glm::uvec3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::uvec3::value_type,
-        StorageTypeConverter<glm::uvec3>::type,
-        StorageTypeConverter<glm::uvec3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::uvec3>(const std::string& key, glm::uvec3& value) const {
+bool Dictionary::getValue<glm::uvec3>(KeyView key, glm::uvec3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec3>::type,
                                         StorageTypeConverter<glm::uvec3>::size>>(key);
@@ -1378,37 +1362,33 @@ bool Dictionary::getValue<glm::uvec3>(const std::string& key, glm::uvec3& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::uvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::bvec3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::bvec3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec3>::type,
                                         StorageTypeConverter<glm::bvec3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::bvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::bvec3>(*this, key);
     }
 }
 
@@ -1416,15 +1396,11 @@ template <>
 bool Dictionary::setValue<glm::bvec3>(std::string key, glm::bvec3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::bvec3::value_type,
-        StorageTypeConverter<glm::bvec3>::type,
-        StorageTypeConverter<glm::bvec3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::bvec3>(const std::string& key, glm::bvec3& value) const {
+bool Dictionary::getValue<glm::bvec3>(KeyView key, glm::bvec3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec3>::type,
                                         StorageTypeConverter<glm::bvec3>::size>>(key);
@@ -1436,52 +1412,45 @@ bool Dictionary::getValue<glm::bvec3>(const std::string& key, glm::bvec3& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::bvec3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::vec4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::vec4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec4>::type,
                                         StorageTypeConverter<glm::vec4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::vec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::vec4>(*this, key);
     }
 }
 
 template <>
 bool Dictionary::setValue<glm::vec4>(std::string key, glm::vec4 value,
-                                bool createIntermediate) {
-    auto v = createArray<
-        glm::vec4::value_type,
-        StorageTypeConverter<glm::vec4>::type,
-        StorageTypeConverter<glm::vec4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+                                bool createIntermediate)
+{
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::vec4>(const std::string& key, glm::vec4& value) const {
+bool Dictionary::getValue<glm::vec4>(KeyView key, glm::vec4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::vec4>::type,
                                         StorageTypeConverter<glm::vec4>::size>>(key);
@@ -1492,52 +1461,45 @@ bool Dictionary::getValue<glm::vec4>(const std::string& key, glm::vec4& value) c
         value = glm::make_vec4(v.data());
         return success;
     } else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::vec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::vec4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dvec4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dvec4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec4>::type,
                                         StorageTypeConverter<glm::dvec4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dvec4>(*this, key);
     }
 }
 
 template <>
 bool Dictionary::setValue<glm::dvec4>(std::string key, glm::dvec4 value,
-                                bool createIntermediate) {
-    auto v = createArray<
-        glm::dvec4::value_type,
-        StorageTypeConverter<glm::dvec4>::type,
-        StorageTypeConverter<glm::dvec4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+                                bool createIntermediate)
+{
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dvec4>(const std::string& key, glm::dvec4& value) const {
+bool Dictionary::getValue<glm::dvec4>(KeyView key, glm::dvec4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::dvec4>::type,
                                         StorageTypeConverter<glm::dvec4>::size>>(key);
@@ -1549,37 +1511,33 @@ bool Dictionary::getValue<glm::dvec4>(const std::string& key, glm::dvec4& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dvec4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::ivec4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::ivec4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec4>::type,
                                         StorageTypeConverter<glm::ivec4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::ivec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::ivec4>(*this, key);
     }
 }
 
@@ -1587,15 +1545,11 @@ template <>
 bool Dictionary::setValue<glm::ivec4>(std::string key, glm::ivec4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::ivec4::value_type,
-        StorageTypeConverter<glm::ivec4>::type,
-        StorageTypeConverter<glm::ivec4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::ivec4>(const std::string& key, glm::ivec4& value) const {
+bool Dictionary::getValue<glm::ivec4>(KeyView key, glm::ivec4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::ivec4>::type,
                                         StorageTypeConverter<glm::ivec4>::size>>(key);
@@ -1607,37 +1561,33 @@ bool Dictionary::getValue<glm::ivec4>(const std::string& key, glm::ivec4& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::ivec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::ivec4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::uvec4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::uvec4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec4>::type,
                                         StorageTypeConverter<glm::uvec4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::uvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::uvec4>(*this, key);
     }
 }
 
@@ -1645,15 +1595,11 @@ template <>
 bool Dictionary::setValue<glm::uvec4>(std::string key, glm::uvec4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::uvec4::value_type,
-        StorageTypeConverter<glm::uvec4>::type,
-        StorageTypeConverter<glm::uvec4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::uvec4>(const std::string& key, glm::uvec4& value) const {
+bool Dictionary::getValue<glm::uvec4>(KeyView key, glm::uvec4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::uvec4>::type,
                                         StorageTypeConverter<glm::uvec4>::size>>(key);
@@ -1665,37 +1611,33 @@ bool Dictionary::getValue<glm::uvec4>(const std::string& key, glm::uvec4& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::uvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::uvec4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::bvec4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::bvec4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec4>::type,
                                         StorageTypeConverter<glm::bvec4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::bvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::bvec4>(*this, key);
     }
 }
 
@@ -1703,15 +1645,11 @@ template <>
 bool Dictionary::setValue<glm::bvec4>(std::string key, glm::bvec4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::bvec4::value_type,
-        StorageTypeConverter<glm::bvec4>::type,
-        StorageTypeConverter<glm::bvec4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::bvec4>(const std::string& key, glm::bvec4& value) const {
+bool Dictionary::getValue<glm::bvec4>(KeyView key, glm::bvec4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::bvec4>::type,
                                         StorageTypeConverter<glm::bvec4>::size>>(key);
@@ -1723,37 +1661,33 @@ bool Dictionary::getValue<glm::bvec4>(const std::string& key, glm::bvec4& value)
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::bvec4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::bvec4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat2x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat2x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x2>::type,
                                         StorageTypeConverter<glm::mat2x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat2x2>(*this, key);
     }
 }
 
@@ -1761,15 +1695,11 @@ template <>
 bool Dictionary::setValue<glm::mat2x2>(std::string key, glm::mat2x2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat2x2::value_type,
-        StorageTypeConverter<glm::mat2x2>::type,
-        StorageTypeConverter<glm::mat2x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat2x2>(const std::string& key, glm::mat2x2& value) const {
+bool Dictionary::getValue<glm::mat2x2>(KeyView key, glm::mat2x2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x2>::type,
                                         StorageTypeConverter<glm::mat2x2>::size>>(key);
@@ -1780,37 +1710,33 @@ bool Dictionary::getValue<glm::mat2x2>(const std::string& key, glm::mat2x2& valu
         value = glm::make_mat2x2(v.data());
         return success;
     } else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat2x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat2x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x3>::type,
                                         StorageTypeConverter<glm::mat2x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat2x3>(*this, key);
     }
 }
 
@@ -1818,15 +1744,11 @@ template <>
 bool Dictionary::setValue<glm::mat2x3>(std::string key, glm::mat2x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat2x3::value_type,
-        StorageTypeConverter<glm::mat2x3>::type,
-        StorageTypeConverter<glm::mat2x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat2x3>(const std::string& key, glm::mat2x3& value) const {
+bool Dictionary::getValue<glm::mat2x3>(KeyView key, glm::mat2x3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x3>::type,
                                         StorageTypeConverter<glm::mat2x3>::size>>(key);
@@ -1838,37 +1760,33 @@ bool Dictionary::getValue<glm::mat2x3>(const std::string& key, glm::mat2x3& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat2x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat2x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x4>::type,
                                         StorageTypeConverter<glm::mat2x4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat2x4>(*this, key);
     }
 }
 
@@ -1876,15 +1794,11 @@ template <>
 bool Dictionary::setValue<glm::mat2x4>(std::string key, glm::mat2x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat2x4::value_type,
-        StorageTypeConverter<glm::mat2x4>::type,
-        StorageTypeConverter<glm::mat2x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat2x4>(const std::string& key, glm::mat2x4& value) const {
+bool Dictionary::getValue<glm::mat2x4>(KeyView key, glm::mat2x4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat2x4>::type,
                                         StorageTypeConverter<glm::mat2x4>::size>>(key);
@@ -1896,37 +1810,33 @@ bool Dictionary::getValue<glm::mat2x4>(const std::string& key, glm::mat2x4& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat2x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat2x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat3x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat3x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x2>::type,
                                         StorageTypeConverter<glm::mat3x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat3x2>(*this, key);
     }
 }
 
@@ -1934,15 +1844,11 @@ template <>
 bool Dictionary::setValue<glm::mat3x2>(std::string key, glm::mat3x2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat3x2::value_type,
-        StorageTypeConverter<glm::mat3x2>::type,
-        StorageTypeConverter<glm::mat3x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat3x2>(const std::string& key, glm::mat3x2& value) const {
+bool Dictionary::getValue<glm::mat3x2>(KeyView key, glm::mat3x2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x2>::type,
                                         StorageTypeConverter<glm::mat3x2>::size>>(key);
@@ -1954,37 +1860,33 @@ bool Dictionary::getValue<glm::mat3x2>(const std::string& key, glm::mat3x2& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat3x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat3x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x3>::type,
                                         StorageTypeConverter<glm::mat3x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat3x3>(*this, key);
     }
 }
 
@@ -1992,15 +1894,11 @@ template <>
 bool Dictionary::setValue<glm::mat3x3>(std::string key, glm::mat3x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat3x3::value_type,
-        StorageTypeConverter<glm::mat3x3>::type,
-        StorageTypeConverter<glm::mat3x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat3x3>(const std::string& key, glm::mat3x3& value) const {
+bool Dictionary::getValue<glm::mat3x3>(KeyView key, glm::mat3x3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x3>::type,
                                         StorageTypeConverter<glm::mat3x3>::size>>(key);
@@ -2012,37 +1910,33 @@ bool Dictionary::getValue<glm::mat3x3>(const std::string& key, glm::mat3x3& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat3x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat3x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x4>::type,
                                         StorageTypeConverter<glm::mat3x4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat3x4>(*this, key);
     }
 }
 
@@ -2050,15 +1944,11 @@ template <>
 bool Dictionary::setValue<glm::mat3x4>(std::string key, glm::mat3x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat3x4::value_type,
-        StorageTypeConverter<glm::mat3x4>::type,
-        StorageTypeConverter<glm::mat3x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat3x4>(const std::string& key, glm::mat3x4& value) const {
+bool Dictionary::getValue<glm::mat3x4>(KeyView key, glm::mat3x4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat3x4>::type,
                                         StorageTypeConverter<glm::mat3x4>::size>>(key);
@@ -2070,37 +1960,33 @@ bool Dictionary::getValue<glm::mat3x4>(const std::string& key, glm::mat3x4& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat3x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat3x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat4x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat4x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x2>::type,
                                         StorageTypeConverter<glm::mat4x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat4x2>(*this, key);
     }
 }
 
@@ -2108,15 +1994,11 @@ template <>
 bool Dictionary::setValue<glm::mat4x2>(std::string key, glm::mat4x2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat4x2::value_type,
-        StorageTypeConverter<glm::mat4x2>::type,
-        StorageTypeConverter<glm::mat4x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat4x2>(const std::string& key, glm::mat4x2& value) const {
+bool Dictionary::getValue<glm::mat4x2>(KeyView key, glm::mat4x2& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x2>::type,
                                         StorageTypeConverter<glm::mat4x2>::size>>(key);
@@ -2128,37 +2010,33 @@ bool Dictionary::getValue<glm::mat4x2>(const std::string& key, glm::mat4x2& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat4x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat4x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x3>::type,
                                         StorageTypeConverter<glm::mat4x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat4x3>(*this, key);
     }
 }
 
@@ -2166,15 +2044,11 @@ template <>
 bool Dictionary::setValue<glm::mat4x3>(std::string key, glm::mat4x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat4x3::value_type,
-        StorageTypeConverter<glm::mat4x3>::type,
-        StorageTypeConverter<glm::mat4x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat4x3>(const std::string& key, glm::mat4x3& value) const {
+bool Dictionary::getValue<glm::mat4x3>(KeyView key, glm::mat4x3& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x3>::type,
                                         StorageTypeConverter<glm::mat4x3>::size>>(key);
@@ -2186,37 +2060,33 @@ bool Dictionary::getValue<glm::mat4x3>(const std::string& key, glm::mat4x3& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::mat4x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::mat4x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x4>::type,
                                         StorageTypeConverter<glm::mat4x4>::size>> (key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::mat4x4>(*this, key);
     }
 }
 
@@ -2224,15 +2094,11 @@ template <>
 bool Dictionary::setValue<glm::mat4x4>(std::string key, glm::mat4x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::mat4x4::value_type,
-        StorageTypeConverter<glm::mat4x4>::type,
-        StorageTypeConverter<glm::mat4x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::mat4x4>(const std::string& key, glm::mat4x4& value) const {
+bool Dictionary::getValue<glm::mat4x4>(KeyView key, glm::mat4x4& value) const {
     bool success
             = hasValueHelper<std::array<StorageTypeConverter<glm::mat4x4>::type,
                                         StorageTypeConverter<glm::mat4x4>::size>>(key);
@@ -2244,37 +2110,33 @@ bool Dictionary::getValue<glm::mat4x4>(const std::string& key, glm::mat4x4& valu
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::mat4x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::mat4x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat2x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat2x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat2x2>::type,
                                         StorageTypeConverter<glm::dmat2x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat2x2>(*this, key);
     }
 }
 
@@ -2282,15 +2144,11 @@ template <>
 bool Dictionary::setValue<glm::dmat2x2>(std::string key, glm::dmat2x2 value,
                                         bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat2x2::value_type,
-        StorageTypeConverter<glm::dmat2x2>::type,
-        StorageTypeConverter<glm::dmat2x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat2x2>(const std::string& key,
+bool Dictionary::getValue<glm::dmat2x2>(KeyView key,
                                         glm::dmat2x2& value) const
 {
     bool success
@@ -2304,37 +2162,33 @@ bool Dictionary::getValue<glm::dmat2x2>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat2x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat2x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat2x3>::type,
                                         StorageTypeConverter<glm::dmat2x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat2x3>(*this, key);
     }
 }
 
@@ -2342,15 +2196,11 @@ template <>
 bool Dictionary::setValue<glm::dmat2x3>(std::string key, glm::dmat2x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat2x3::value_type,
-        StorageTypeConverter<glm::dmat2x3>::type,
-        StorageTypeConverter<glm::dmat2x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat2x3>(const std::string& key,
+bool Dictionary::getValue<glm::dmat2x3>(KeyView key,
                                         glm::dmat2x3& value) const
 {
     bool success
@@ -2364,37 +2214,33 @@ bool Dictionary::getValue<glm::dmat2x3>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat2x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat2x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat2x4>::type,
                                         StorageTypeConverter<glm::dmat2x4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat2x4>(*this, key);
     }
 }
 
@@ -2402,15 +2248,11 @@ template <>
 bool Dictionary::setValue<glm::dmat2x4>(std::string key, glm::dmat2x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat2x4::value_type,
-        StorageTypeConverter<glm::dmat2x4>::type,
-        StorageTypeConverter<glm::dmat2x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat2x4>(const std::string& key,
+bool Dictionary::getValue<glm::dmat2x4>(KeyView key,
                                         glm::dmat2x4& value) const
 {
     bool success
@@ -2424,37 +2266,33 @@ bool Dictionary::getValue<glm::dmat2x4>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat2x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat2x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat3x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat3x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat3x2>::type,
                                         StorageTypeConverter<glm::dmat3x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat3x2>(*this, key);
     }
 }
 
@@ -2462,15 +2300,11 @@ template <>
 bool Dictionary::setValue<glm::dmat3x2>(std::string key, glm::dmat3x2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat3x2::value_type,
-        StorageTypeConverter<glm::dmat3x2>::type,
-        StorageTypeConverter<glm::dmat3x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat3x2>(const std::string& key,
+bool Dictionary::getValue<glm::dmat3x2>(KeyView key,
                                         glm::dmat3x2& value) const
 {
     bool success
@@ -2484,37 +2318,33 @@ bool Dictionary::getValue<glm::dmat3x2>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat3x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat3x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat3x3>::type,
                                         StorageTypeConverter<glm::dmat3x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat3x3>(*this, key);
     }
 }
 
@@ -2522,15 +2352,11 @@ template <>
 bool Dictionary::setValue<glm::dmat3x3>(std::string key, glm::dmat3x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat3x3::value_type,
-        StorageTypeConverter<glm::dmat3x3>::type,
-        StorageTypeConverter<glm::dmat3x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat3x3>(const std::string& key,
+bool Dictionary::getValue<glm::dmat3x3>(KeyView key,
                                         glm::dmat3x3& value) const
 {
     bool success
@@ -2544,37 +2370,33 @@ bool Dictionary::getValue<glm::dmat3x3>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat3x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat3x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat3x4>::type,
                                         StorageTypeConverter<glm::dmat3x4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat3x4>(*this, key);
     }
 }
 
@@ -2582,15 +2404,11 @@ template <>
 bool Dictionary::setValue<glm::dmat3x4>(std::string key, glm::dmat3x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat3x4::value_type,
-        StorageTypeConverter<glm::dmat3x4>::type,
-        StorageTypeConverter<glm::dmat3x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat3x4>(const std::string& key,
+bool Dictionary::getValue<glm::dmat3x4>(KeyView key,
                                         glm::dmat3x4& value) const
 {
     bool success
@@ -2604,37 +2422,33 @@ bool Dictionary::getValue<glm::dmat3x4>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat3x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat3x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat4x2>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat4x2>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat4x2>::type,
                                         StorageTypeConverter<glm::dmat4x2>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x2>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat4x2>(*this, key);
     }
 }
 
@@ -2642,15 +2456,11 @@ template <>
 bool Dictionary::setValue<glm::dmat4x2>(std::string key, glm::dmat4x2 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat4x2::value_type,
-        StorageTypeConverter<glm::dmat4x2>::type,
-        StorageTypeConverter<glm::dmat4x2>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat4x2>(const std::string& key,
+bool Dictionary::getValue<glm::dmat4x2>(KeyView key,
                                         glm::dmat4x2& value) const
 {
     bool success
@@ -2664,37 +2474,33 @@ bool Dictionary::getValue<glm::dmat4x2>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x2>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x2>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat4x3>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat4x3>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat4x3>::type,
                                         StorageTypeConverter<glm::dmat4x3>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x3>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat4x3>(*this, key);
     }
 }
 
@@ -2702,15 +2508,11 @@ template <>
 bool Dictionary::setValue<glm::dmat4x3>(std::string key, glm::dmat4x3 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat4x3::value_type,
-        StorageTypeConverter<glm::dmat4x3>::type,
-        StorageTypeConverter<glm::dmat4x3>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat4x3>(const std::string& key,
+bool Dictionary::getValue<glm::dmat4x3>(KeyView key,
                                         glm::dmat4x3& value) const
 {
     bool success
@@ -2724,37 +2526,33 @@ bool Dictionary::getValue<glm::dmat4x3>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x3>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x3>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::hasValue<glm::dmat4x4>(const std::string& key) const {
+bool Dictionary::hasValue<glm::dmat4x4>(KeyView key) const {
     const bool val
             = hasValueHelper<std::array<StorageTypeConverter<glm::dmat4x4>::type,
                                         StorageTypeConverter<glm::dmat4x4>::size>>(key);
     if (val)
         return true;
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x4>(*dict);
             if (canConvert)
                 return true;
         }
-        return false;
+        return isArrayConvertible<glm::dmat4x4>(*this, key);
     }
 }
 
@@ -2762,15 +2560,11 @@ template <>
 bool Dictionary::setValue<glm::dmat4x4>(std::string key, glm::dmat4x4 value,
                                 bool createIntermediate)
 {
-    auto v = createArray<
-        glm::dmat4x4::value_type,
-        StorageTypeConverter<glm::dmat4x4>::type,
-        StorageTypeConverter<glm::dmat4x4>::size>(glm::value_ptr(value));
-    return setValueHelper(std::move(key), std::move(v), createIntermediate);
+    return setValueInternal(std::move(key), storageValue(value), createIntermediate);
 }
 
 template <>
-bool Dictionary::getValue<glm::dmat4x4>(const std::string& key,
+bool Dictionary::getValue<glm::dmat4x4>(KeyView key,
                                         glm::dmat4x4& value) const
 {
     bool success
@@ -2784,22 +2578,20 @@ bool Dictionary::getValue<glm::dmat4x4>(const std::string& key,
         return success;
     }
     else {
-        const bool hasDictionary = hasValueHelper<Dictionary>(key);
-        if (hasDictionary) {
-            Dictionary dict;
-            getValueHelper<Dictionary>(key, dict);
-            const bool canConvert = isConvertible<glm::dmat4x4>(dict);
+        const Dictionary* const dict = valuePtr<Dictionary>(key);
+        if (dict != nullptr) {
+            const bool canConvert = isConvertible<glm::dmat4x4>(*dict);
             if (canConvert) {
-                convertGLM(dict, value);
+                convertGLM(*dict, value);
                 return true;
             }
         }
     }
-    return false;
+    return convertArray(*this, key, value);
 }
 
 template <>
-bool Dictionary::getValue<Dictionary>(const std::string& key, Dictionary& value) const {
+bool Dictionary::getValue<Dictionary>(KeyView key, Dictionary& value) const {
     if (&value == this) {
         LERROR(
               "The argument in the 'getValue' methods cannot be the same Dictionary as "
@@ -2809,6 +2601,126 @@ bool Dictionary::getValue<Dictionary>(const std::string& key, Dictionary& value)
     return getValueHelper(key, value);
 }
 
+#define DEF_STORAGE_VALUE(TYPE)                                                          \
+    template <>                                                                          \
+    Dictionary::Value Dictionary::storageValue<TYPE>(TYPE value) {                       \
+        return makeValue(StorageTypeConverter<TYPE>::type(value));                       \
+    }
+
+#define DEF_STORAGE_ARRAY_VALUE(TYPE)                                                    \
+    template <>                                                                          \
+    Dictionary::Value Dictionary::storageValue<TYPE>(TYPE value) {                       \
+        return makeValue(createArray<                                                    \
+            TYPE::value_type,                                                            \
+            StorageTypeConverter<TYPE>::type,                                            \
+            StorageTypeConverter<TYPE>::size>(glm::value_ptr(value)));                   \
+    }
+
+DEF_STORAGE_VALUE(double)
+DEF_STORAGE_VALUE(long long)
+DEF_STORAGE_VALUE(unsigned long long)
+DEF_STORAGE_VALUE(bool)
+DEF_STORAGE_VALUE(char)
+DEF_STORAGE_VALUE(signed char)
+DEF_STORAGE_VALUE(unsigned char)
+DEF_STORAGE_VALUE(wchar_t)
+DEF_STORAGE_VALUE(short)
+DEF_STORAGE_VALUE(unsigned short)
+DEF_STORAGE_VALUE(int)
+DEF_STORAGE_VALUE(unsigned int)
+DEF_STORAGE_VALUE(float)
+DEF_STORAGE_ARRAY_VALUE(glm::vec2)
+DEF_STORAGE_ARRAY_VALUE(glm::dvec2)
+DEF_STORAGE_ARRAY_VALUE(glm::ivec2)
+DEF_STORAGE_ARRAY_VALUE(glm::uvec2)
+DEF_STORAGE_ARRAY_VALUE(glm::bvec2)
+DEF_STORAGE_ARRAY_VALUE(glm::vec3)
+DEF_STORAGE_ARRAY_VALUE(glm::dvec3)
+DEF_STORAGE_ARRAY_VALUE(glm::ivec3)
+DEF_STORAGE_ARRAY_VALUE(glm::uvec3)
+DEF_STORAGE_ARRAY_VALUE(glm::bvec3)
+DEF_STORAGE_ARRAY_VALUE(glm::vec4)
+DEF_STORAGE_ARRAY_VALUE(glm::dvec4)
+DEF_STORAGE_ARRAY_VALUE(glm::ivec4)
+DEF_STORAGE_ARRAY_VALUE(glm::uvec4)
+DEF_STORAGE_ARRAY_VALUE(glm::bvec4)
+DEF_STORAGE_ARRAY_VALUE(glm::mat2x2)
+DEF_STORAGE_ARRAY_VALUE(glm::mat2x3)
+DEF_STORAGE_ARRAY_VALUE(glm::mat2x4)
+DEF_STORAGE_ARRAY_VALUE(glm::mat3x2)
+DEF_STORAGE_ARRAY_VALUE(glm::mat3x3)
+DEF_STORAGE_ARRAY_VALUE(glm::mat3x4)
+DEF_STORAGE_ARRAY_VALUE(glm::mat4x2)
+DEF_STORAGE_ARRAY_VALUE(glm::mat4x3)
+DEF_STORAGE_ARRAY_VALUE(glm::mat4x4)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat2x2)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat2x3)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat2x4)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat3x2)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat3x3)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat3x4)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat4x2)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat4x3)
+DEF_STORAGE_ARRAY_VALUE(glm::dmat4x4)
+
+#undef DEF_STORAGE_ARRAY_VALUE
+#undef DEF_STORAGE_VALUE
+
+#define DEF_CONVERT_VALUE(TYPE, HELPER)                                                  \
+    template <>                                                                          \
+    bool Dictionary::convertValue<TYPE>(const Value& value, TYPE& result) {              \
+        return HELPER(value, result);                                                    \
+    }
+
+DEF_CONVERT_VALUE(bool, convertScalarValue)
+DEF_CONVERT_VALUE(char, convertScalarValue)
+DEF_CONVERT_VALUE(signed char, convertScalarValue)
+DEF_CONVERT_VALUE(unsigned char, convertScalarValue)
+DEF_CONVERT_VALUE(wchar_t, convertScalarValue)
+DEF_CONVERT_VALUE(short, convertScalarValue)
+DEF_CONVERT_VALUE(unsigned short, convertScalarValue)
+DEF_CONVERT_VALUE(int, convertScalarValue)
+DEF_CONVERT_VALUE(unsigned int, convertScalarValue)
+DEF_CONVERT_VALUE(long long, convertScalarValue)
+DEF_CONVERT_VALUE(unsigned long long, convertScalarValue)
+DEF_CONVERT_VALUE(float, convertScalarValue)
+DEF_CONVERT_VALUE(double, convertScalarValue)
+DEF_CONVERT_VALUE(glm::vec2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dvec2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::ivec2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::uvec2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::bvec2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::vec3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dvec3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::ivec3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::uvec3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::bvec3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::vec4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dvec4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::ivec4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::uvec4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::bvec4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat2x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat2x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat2x4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat3x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat3x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat3x4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat4x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat4x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::mat4x4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat2x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat2x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat2x4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat3x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat3x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat3x4, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat4x2, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat4x3, convertGLMValue)
+DEF_CONVERT_VALUE(glm::dmat4x4, convertGLMValue)
+
+#undef DEF_CONVERT_VALUE
+
 #ifdef WIN32
 #pragma warning ( default : 4800 )
 #endif
@@ -2818,69 +2730,992 @@ Dictionary::Dictionary(std::initializer_list<std::pair<std::string, boost::any>>
         setValueAnyHelper(std::move(p.first), std::move(p.second));
 }
 
-std::vector<string> Dictionary::keys(const string& location) const {
-    if (location.empty()) {
-        std::vector<string> result;
-        result.reserve(size());
-        for (const auto& it : *this)
-            result.push_back(it.first);
-        return result;
+Dictionary::Dictionary(std::shared_ptr<MemoryArena> arena) {
+    // The arena is only remembered by the allocator of the node, so an empty node has to
+    // be created eagerly
+    if (arena) {
+        const ArenaAllocator<Node> allocator(std::move(arena));
+        _node = std::allocate_shared<Node>(allocator, allocator);
+    }
+}
+
+std::vector<string> Dictionary::keys(KeyView location) const {
+    const Dictionary* dict = this;
+    if (!location.empty()) {
+        const Value* const v = resolveValue(location, false);
+        if (v == nullptr) {
+            LERROR("Key '" << location << "' was not found in dictionary");
+            return std::vector<string>();
+        }
+        dict = boost::get<Dictionary>(v);
+        if (dict == nullptr) {
+            LERROR("Error converting key '" << location << "' to type 'Dictionary', was '"
+                                            << valueType(*v).name() << "'");
+            return std::vector<string>();
+        }
     }
 
-    std::string first;
-    std::string rest;
-    splitKey(location, first, rest);
+    std::vector<string> result;
+    result.reserve(dict->size());
+    dict->forEach([&result](const string& key, const Dictionary*) {
+        result.push_back(key);
+    });
+    // The entries are stored in insertion order, but the keys have always been returned
+    // in lexicographical order
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool Dictionary::hasKey(KeyView key) const {
+    return resolveValue(key, false) != nullptr;
+}
+
+bool Dictionary::hasKey(const DictionaryKey& key) const {
+    return resolveValue(key, false) != nullptr;
+}
 
-    auto keyIt = find(first);
-    if (keyIt == cend()) {
-        LERROR("Key '" << first << "' was not found in dictionary");
-        return std::vector<string>();
+const Dictionary& Dictionary::subDictionary(KeyView key) const {
+    static const Dictionary EmptyDictionary;
+
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
+        return EmptyDictionary;
+
+    const Dictionary* const dict = boost::get<Dictionary>(v);
+    if (dict == nullptr) {
+        LERROR("Wrong type of key '" << key << "': Expected '"
+               << typeid(Dictionary).name() << "', got '" << valueType(*v).name()
+               << "'");
+        return EmptyDictionary;
     }
+    return *dict;
+}
 
-    const Dictionary* const dict = boost::any_cast<Dictionary>(&(keyIt->second));
-    if (!dict) {
-        LERROR("Error converting key '" << first << "' to type 'Dictionary', was '"
-                                        << keyIt->second.type().name() << "'");
-        return std::vector<string>();
+const Dictionary& Dictionary::subDictionary(const DictionaryKey& key) const {
+    static const Dictionary EmptyDictionary;
+
+    const Value* const v = resolveValue(key, true);
+    if (v == nullptr)
+        return EmptyDictionary;
+
+    const Dictionary* const dict = boost::get<Dictionary>(v);
+    if (dict == nullptr) {
+        LERROR("Wrong type of key '" << key.key() << "': Expected '"
+               << typeid(Dictionary).name() << "', got '" << valueType(*v).name()
+               << "'");
+        return EmptyDictionary;
     }
-    // proper tail-recursion
-    return dict->keys(rest);
+    return *dict;
 }
 
-bool Dictionary::hasKey(const string& key) const {
-    auto it = find(key);
-    if (it != cend())
-        return true;
+size_t Dictionary::size() const {
+    return _node ? _node->entries.size() : 0;
+}
 
-    std::string first;
-    std::string rest;
-    splitKey(key, first, rest);
+void Dictionary::reserve(size_t nEntries) {
+    detach();
+    _node->entries.reserve(nEntries);
+}
 
-    auto keyIt = find(first);
-    if (keyIt == cend())
+void Dictionary::clear() {
+    // Other Dictionaries might still share the node, so it cannot be cleared in place
+    *this = Dictionary(arena());
+}
+
+bool Dictionary::empty() const {
+    return size() == 0;
+}
+
+bool Dictionary::removeKey(KeyView key) {
+    const uint64_t hash = DictionaryKey::hash(key.data(), key.size());
+    const Dictionary* self = this;
+    const Entry* e = self->findEntry(key.data(), key.size(), hash);
+    if (e == nullptr)
         return false;
 
-    const Dictionary* const dict = boost::any_cast<Dictionary>(&(keyIt->second));
-    if (!dict)
+    const size_t position = e - _node->entries.data();
+    detach();
+    eraseEntry(position);
+    return true;
+}
+
+Dictionary Dictionary::extractSubDictionary(KeyView key) {
+    Dictionary result;
+    takeValue(key, result);
+    return result;
+}
+
+void Dictionary::setKeyInterningEnabled(bool enabled) {
+    KeyInterning.store(enabled, std::memory_order_relaxed);
+}
+
+bool Dictionary::isKeyInterningEnabled() {
+    return KeyInterning.load(std::memory_order_relaxed);
+}
+
+Dictionary::MemoryUsage Dictionary::memoryUsage() const {
+    MemoryUsage usage;
+    std::unordered_set<const Node*> visited;
+    accumulateMemoryUsage(usage, visited, false);
+    return usage;
+}
+
+void Dictionary::accumulateMemoryUsage(MemoryUsage& usage,
+                                       std::unordered_set<const Node*>& visited,
+                                       bool isShared) const
+{
+    if (!_node)
+        return;
+
+    const Node& node = *_node;
+    size_t bytes = sizeof(Node) + node.entries.capacity() * sizeof(Entry) +
+                   node.index.capacity() * sizeof(uint32_t);
+    for (const Entry& e : node.entries) {
+        if (e.internedKey == nullptr)
+            bytes += e.ownKey.capacity();
+        if (const string* s = boost::get<string>(&e.value))
+            bytes += s->capacity();
+        else if (const std::vector<IntegralType>* a =
+                    boost::get<std::vector<IntegralType>>(&e.value))
+        {
+            bytes += a->capacity() * sizeof(IntegralType);
+        }
+        else if (const std::vector<FloatingType>* a =
+                    boost::get<std::vector<FloatingType>>(&e.value))
+        {
+            bytes += a->capacity() * sizeof(FloatingType);
+        }
+    }
+
+    // Everything below a shared node is shared, too
+    isShared = isShared || (_node.use_count() > 1);
+    usage.logicalBytes += bytes;
+    const bool isNew = visited.insert(&node).second;
+    if (isNew) {
+        ++usage.nNodes;
+        usage.bytes += bytes;
+        if (isShared)
+            usage.sharedBytes += bytes;
+    }
+
+    // The nested Dictionaries have to be visited even if this node was visited before
+    // to compute the logical size
+    for (const Entry& e : node.entries) {
+        if (const Dictionary* d = boost::get<Dictionary>(&e.value))
+            d->accumulateMemoryUsage(usage, visited, isShared);
+    }
+}
+
+std::shared_ptr<const Dictionary> Dictionary::freeze() const {
+    std::unordered_map<const Node*, std::shared_ptr<Node>> nodes;
+    return std::make_shared<const Dictionary>(compactedCopy(nodes));
+}
+
+Dictionary Dictionary::compactedCopy(
+                    std::unordered_map<const Node*, std::shared_ptr<Node>>& nodes) const
+{
+    Dictionary result;
+    if (!_node)
+        return result;
+
+    auto it = nodes.find(_node.get());
+    if (it != nodes.end()) {
+        result._node = it->second;
+        return result;
+    }
+
+    result._node = std::make_shared<Node>();
+    Node::Entries& entries = result._node->entries;
+    entries.reserve(_node->entries.size());
+    for (const Entry& e : _node->entries) {
+        const Dictionary* const dict = boost::get<Dictionary>(&(e.value));
+        if (dict != nullptr)
+            entries.push_back({
+                e.ownKey, e.internedKey, e.hash, Value(dict->compactedCopy(nodes))
+            });
+        else
+            entries.push_back(e);
+    }
+    if (entries.size() > LinearSearchThreshold)
+        result.rebuildIndex();
+
+    result._node->hasUnsupportedValues.store(
+        _node->hasUnsupportedValues.load(std::memory_order_relaxed),
+        std::memory_order_relaxed
+    );
+    result._node->hash.store(
+        _node->hash.load(std::memory_order_acquire),
+        std::memory_order_release
+    );
+    nodes[_node.get()] = result._node;
+    return result;
+}
+
+Dictionary::ChangeSet Dictionary::diff(const Dictionary& other) const {
+    ChangeSet result;
+    std::vector<string> path;
+    diff(other, path, result);
+    return result;
+}
+
+void Dictionary::diff(const Dictionary& other, std::vector<string>& path,
+                      ChangeSet& result) const
+{
+    // Levels that are shared need not be compared; this includes two empty levels.
+    // Unshared levels with the same contents are found by their cached hashes, unless
+    // they contain values whose contents are not part of the hash
+    if (_node == other._node)
+        return;
+    if (hash() == other.hash() && !hasUnsupportedValues() &&
+        !other.hasUnsupportedValues())
+    {
+        return;
+    }
+
+    // The changes are identified by their segments so that keys which contain a '.'
+    // are not split into separate levels
+    const auto addChange = [&path, &result](Change::Type type, const Entry& e) {
+        path.push_back(e.key());
+        DictionaryKey key(path);
+        path.pop_back();
+        if (type != Change::Type::Removed) {
+            const size_t last = key.nSegments() - 1;
+            result.values.resolveParent(key, true)->insertValue(
+                key.segment(last), key.segmentHash(last), e.value
+            );
+        }
+        string k = key.key();
+        result.changes.push_back({ type, std::move(k), std::move(key) });
+    };
+
+    if (_node) {
+        for (const Entry& e : _node->entries) {
+            if (other.findEntry(e.key().data(), e.key().size(), e.hash) == nullptr)
+                addChange(Change::Type::Removed, e);
+        }
+    }
+
+    if (!other._node)
+        return;
+    for (const Entry& e : other._node->entries) {
+        const Entry* const mine = findEntry(e.key().data(), e.key().size(), e.hash);
+        if (mine == nullptr) {
+            addChange(Change::Type::Added, e);
+            continue;
+        }
+
+        const Dictionary* const lhs = boost::get<Dictionary>(&(mine->value));
+        const Dictionary* const rhs = boost::get<Dictionary>(&(e.value));
+        if (lhs != nullptr && rhs != nullptr) {
+            path.push_back(e.key());
+            lhs->diff(*rhs, path, result);
+            path.pop_back();
+        }
+        else if (!isEqual(mine->value, e.value))
+            addChange(Change::Type::Modified, e);
+    }
+}
+
+bool Dictionary::isEqual(const Value& lhs, const Value& rhs) {
+    const IntegralType* lhsIntegral;
+    const FloatingType* lhsFloating;
+    size_t lhsSize;
+    const SerializedType type = serializedType(lhs, lhsIntegral, lhsFloating, lhsSize);
+
+    const IntegralType* rhsIntegral;
+    const FloatingType* rhsFloating;
+    size_t rhsSize;
+    if (serializedType(rhs, rhsIntegral, rhsFloating, rhsSize) != type)
         return false;
-    return dict->hasKey(rest);
+
+    switch (type) {
+        case SerializedType::Integral:
+            return boost::get<IntegralType>(lhs) == boost::get<IntegralType>(rhs);
+        case SerializedType::UnsignedIntegral:
+            return boost::get<UnsignedIntegralType>(lhs) ==
+                   boost::get<UnsignedIntegralType>(rhs);
+        case SerializedType::Floating:
+            return boost::get<FloatingType>(lhs) == boost::get<FloatingType>(rhs);
+        case SerializedType::String:
+            return boost::get<string>(lhs) == boost::get<string>(rhs);
+        case SerializedType::IntegralArray:
+            return (lhsSize == rhsSize) &&
+                   std::equal(lhsIntegral, lhsIntegral + lhsSize, rhsIntegral);
+        case SerializedType::FloatingArray:
+            return (lhsSize == rhsSize) &&
+                   std::equal(lhsFloating, lhsFloating + lhsSize, rhsFloating);
+        default:
+            // Nested Dictionaries are compared by #diff, other types cannot be compared
+            return false;
+    }
 }
 
-size_t Dictionary::size() const {
-    return std::map<std::string, boost::any>::size();
+bool Dictionary::apply(const ChangeSet& changes) {
+    bool success = true;
+    for (const Change& c : changes.changes) {
+        const DictionaryKey& key = c.path;
+        const size_t last = key.nSegments() - 1;
+        if (c.type == Change::Type::Removed) {
+            Dictionary* const parent = resolveParent(key, false);
+            success &= (parent != nullptr) && parent->removeKey(key.segment(last));
+        }
+        else {
+            const Dictionary* const values = changes.values.resolveParent(key, false);
+            const Entry* const entry = (values != nullptr) ?
+                values->findEntry(
+                    key.segment(last).data(), key.segment(last).size(),
+                    key.segmentHash(last)
+                ) :
+                nullptr;
+            Dictionary* const parent = resolveParent(key, true);
+            if (entry == nullptr || parent == nullptr) {
+                success = false;
+                continue;
+            }
+            parent->insertValue(key.segment(last), key.segmentHash(last), entry->value);
+        }
+    }
+    return success;
 }
 
-void Dictionary::clear() {
-    return std::map<std::string, boost::any>::clear();
+namespace {
+// Wildcards in query patterns
+const string WildcardKey = "*";
+const string WildcardLevels = "**";
+
+// Adds the state for 'segment' of 'pattern' to 'states' or sets 'isMatch' if the whole
+// pattern has been matched. As '**' can match no level at all, the following segment
+// is added, too
+template <typename State>
+void addQueryState(const std::vector<DictionaryKey>& patterns, uint32_t pattern,
+                   uint32_t segment, std::vector<State>& states, bool& isMatch)
+{
+    const DictionaryKey& key = patterns[pattern];
+    if (segment == key.nSegments()) {
+        isMatch = true;
+        return;
+    }
+    const auto sameState = [pattern, segment](const State& s) {
+        return s.pattern == pattern && s.segment == segment;
+    };
+    if (std::none_of(states.begin(), states.end(), sameState))
+        states.push_back({ pattern, segment });
+    if (key.segment(segment) == WildcardLevels)
+        addQueryState(patterns, pattern, segment + 1, states, isMatch);
 }
+} // namespace
 
-bool Dictionary::empty() const {
-    return std::map<std::string, boost::any>::empty();
+void Dictionary::query(const string& pattern, std::vector<Match>& result) const {
+    query(std::vector<string>(1, pattern), result);
+}
+
+void Dictionary::query(const std::vector<string>& patterns,
+                       std::vector<Match>& result) const
+{
+    std::vector<DictionaryKey> keys;
+    keys.reserve(patterns.size());
+    for (const string& p : patterns)
+        keys.emplace_back(p);
+
+    std::vector<QueryState> states;
+    bool isMatch = false;
+    for (uint32_t i = 0; i < keys.size(); ++i)
+        addQueryState(keys, i, 0, states, isMatch);
+    query(keys, states, "", result);
+}
+
+void Dictionary::query(const std::vector<DictionaryKey>& patterns,
+                       const std::vector<QueryState>& states, const string& prefix,
+                       std::vector<Match>& result) const
+{
+    if (!_node || states.empty())
+        return;
+
+    const bool hasWildcard = std::any_of(states.begin(), states.end(),
+        [&patterns](const QueryState& s) {
+            const string& segment = patterns[s.pattern].segment(s.segment);
+            return segment == WildcardKey || segment == WildcardLevels;
+        }
+    );
+
+    // Without wildcards, only the entries named in the patterns have to be visited
+    std::vector<const Entry*> candidates;
+    if (hasWildcard) {
+        candidates.reserve(_node->entries.size());
+        for (const Entry& e : _node->entries)
+            candidates.push_back(&e);
+    }
+    else {
+        for (const QueryState& s : states) {
+            const DictionaryKey& key = patterns[s.pattern];
+            const string& segment = key.segment(s.segment);
+            const Entry* e = findEntry(
+                segment.data(), segment.size(), key.segmentHash(s.segment)
+            );
+            const bool isNew = std::find(candidates.begin(), candidates.end(), e) ==
+                               candidates.end();
+            if (e != nullptr && isNew)
+                candidates.push_back(e);
+        }
+    }
+
+    std::vector<QueryState> next;
+    for (const Entry* e : candidates) {
+        next.clear();
+        bool isMatch = false;
+        for (const QueryState& s : states) {
+            const DictionaryKey& key = patterns[s.pattern];
+            const string& segment = key.segment(s.segment);
+            if (segment == WildcardLevels) {
+                // '**' consumes this entry and can either continue in the nested levels
+                // or end here, which are exactly the states that it is expanded into
+                addQueryState(patterns, s.pattern, s.segment, next, isMatch);
+            }
+            else if (segment == WildcardKey ||
+                     (key.segmentHash(s.segment) == e->hash && segment == e->key()))
+            {
+                addQueryState(patterns, s.pattern, s.segment + 1, next, isMatch);
+            }
+        }
+
+        if (isMatch) {
+            Match m;
+            m.key = prefix + e->key();
+            m.parent = this;
+            m._value = &(e->value);
+            result.push_back(std::move(m));
+        }
+
+        const Dictionary* const dict = boost::get<Dictionary>(&(e->value));
+        if (dict != nullptr && !next.empty())
+            dict->query(patterns, next, prefix + e->key() + '.', result);
+    }
+}
+
+bool Dictionary::ChangeSet::affects(const string& key) const {
+    // Returns true if 'parent' is equal to 'child' or one of its parents
+    auto isParent = [](const string& parent, const string& child) {
+        return parent.empty() ||
+            ((child.compare(0, parent.size(), parent) == 0) &&
+             (child.size() == parent.size() || child[parent.size()] == '.'));
+    };
+
+    for (const Change& c : changes) {
+        if (isParent(c.key, key) || isParent(key, c.key))
+            return true;
+    }
+    return false;
+}
+
+bool Dictionary::ChangeSet::empty() const {
+    return changes.empty();
+}
+
+std::shared_ptr<MemoryArena> Dictionary::arena() const {
+    return _node ? _node->entries.get_allocator().arena() : nullptr;
 }
 
-bool Dictionary::removeKey(const std::string& key) {
-    std::map<std::string, boost::any>::size_type res = erase(key);
-    return (res == 1);
+void Dictionary::detach() {
+    if (!_node)
+        _node = std::make_shared<Node>();
+    else if (_node.use_count() > 1) {
+        // Copying the node copies the entries of this level only; the nested
+        // Dictionaries are copied by sharing their nodes. The copy is allocated from the
+        // same arena as the original
+        const ArenaAllocator<Node> allocator(_node->entries.get_allocator());
+        _node = std::allocate_shared<Node>(allocator, *_node);
+    }
+    // Every modification passes through here for each level along its key, so only the
+    // hashes on the path to the modified value are invalidated
+    _node->hash.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Dictionary::hash() const {
+    if (!_node)
+        return levelHash(0, 0);
+
+    uint64_t result = _node->hash.load(std::memory_order_acquire);
+    if (result != 0)
+        return result;
+
+    // The entry hashes are combined with a commutative operation so that the order in
+    // which keys were added does not matter
+    uint64_t entries = 0;
+    bool hasUnsupported = false;
+    for (const Entry& e : _node->entries) {
+        entries += mixHash(e.hash ^ mixHash(hashValue(e.value)));
+        // The hash of nested levels has just been computed by hashValue
+        const Dictionary* const dict = boost::get<Dictionary>(&(e.value));
+        if (dict != nullptr)
+            hasUnsupported |= dict->hasUnsupportedValues();
+        else {
+            const IntegralType* integral;
+            const FloatingType* floating;
+            size_t size;
+            hasUnsupported |= (serializedType(e.value, integral, floating, size) ==
+                               SerializedType::Unsupported);
+        }
+    }
+    result = levelHash(_node->entries.size(), entries);
+
+    // Concurrent callers compute the same values, so there is no need to synchronize
+    // beyond publishing the flag together with the hash
+    _node->hasUnsupportedValues.store(hasUnsupported, std::memory_order_relaxed);
+    _node->hash.store(result, std::memory_order_release);
+    return result;
+}
+
+bool Dictionary::hasUnsupportedValues() const {
+    if (!_node)
+        return false;
+    // The flag is computed together with the cached hash
+    hash();
+    return _node->hasUnsupportedValues.load(std::memory_order_relaxed);
+}
+
+uint64_t Dictionary::hashValue(const Value& value) {
+    const IntegralType* integral;
+    const FloatingType* floating;
+    size_t size;
+    const SerializedType type = serializedType(value, integral, floating, size);
+
+    uint64_t result = static_cast<uint64_t>(type);
+    switch (type) {
+        case SerializedType::Integral:
+            result ^= static_cast<uint64_t>(boost::get<IntegralType>(value));
+            return mixHash(result);
+        case SerializedType::UnsignedIntegral:
+            return mixHash(result ^ boost::get<UnsignedIntegralType>(value));
+        case SerializedType::Floating:
+            return mixHash(result ^ floatingBits(boost::get<FloatingType>(value)));
+        case SerializedType::String: {
+            const string& s = boost::get<string>(value);
+            return mixHash(result ^ DictionaryKey::hash(s.data(), s.size()));
+        }
+        case SerializedType::Dictionary:
+            return mixHash(result ^ boost::get<Dictionary>(value).hash());
+        case SerializedType::IntegralArray:
+            result = mixHash(result ^ size);
+            for (size_t i = 0; i < size; ++i)
+                result = mixHash(result ^ static_cast<uint64_t>(integral[i]));
+            return result;
+        case SerializedType::FloatingArray:
+            result = mixHash(result ^ size);
+            for (size_t i = 0; i < size; ++i)
+                result = mixHash(result ^ floatingBits(floating[i]));
+            return result;
+        default: {
+            // The contents of unsupported types are unknown, but their type is not
+            const char* name = valueType(value).name();
+            return mixHash(result ^ DictionaryKey::hash(name, std::strlen(name)));
+        }
+    }
+}
+
+const Dictionary::Entry* Dictionary::findEntry(const char* key, size_t length,
+                                               uint64_t hash) const
+{
+    if (!_node)
+        return nullptr;
+
+    const Node::Entries& entries = _node->entries;
+    const Node::Index& index = _node->index;
+    if (index.empty()) {
+        for (const Entry& e : entries) {
+            if (e.matches(key, length, hash))
+                return &e;
+        }
+        return nullptr;
+    }
+
+    const size_t mask = index.size() - 1;
+    for (size_t i = hash & mask; index[i] != 0; i = (i + 1) & mask) {
+        const Entry& e = entries[index[i] - 1];
+        if (e.matches(key, length, hash))
+            return &e;
+    }
+    return nullptr;
+}
+
+Dictionary::Entry* Dictionary::findEntry(const char* key, size_t length, uint64_t hash) {
+    // The returned entry might be modified, so this level cannot be shared anymore
+    detach();
+    const Dictionary* self = this;
+    return const_cast<Entry*>(self->findEntry(key, length, hash));
+}
+
+Dictionary::Value& Dictionary::insertValue(string key, uint64_t hash, Value value) {
+    Entry* e = findEntry(key.data(), key.size(), hash);
+    if (e != nullptr) {
+        e->value = std::move(value);
+        return e->value;
+    }
+    return appendValue(std::move(key), hash, std::move(value));
+}
+
+Dictionary::Value& Dictionary::appendValue(string key, uint64_t hash, Value value) {
+    Node::Entries& entries = _node->entries;
+    Node::Index& index = _node->index;
+    if (KeyInterning.load(std::memory_order_relaxed)) {
+        const string* const interned = internKey(std::move(key));
+        entries.push_back({ string(), interned, hash, std::move(value) });
+    }
+    else
+        entries.push_back({ std::move(key), nullptr, hash, std::move(value) });
+    if (entries.size() > LinearSearchThreshold) {
+        // Keep the load factor of the index at or below 0.5
+        if (index.size() < 2 * entries.size())
+            rebuildIndex();
+        else {
+            const size_t mask = index.size() - 1;
+            size_t i = hash & mask;
+            while (index[i] != 0)
+                i = (i + 1) & mask;
+            index[i] = static_cast<uint32_t>(entries.size());
+        }
+    }
+    return entries.back().value;
+}
+
+void Dictionary::rebuildIndex() {
+    const Node::Entries& entries = _node->entries;
+    Node::Index& index = _node->index;
+
+    size_t capacity = 16;
+    while (capacity < 4 * entries.size())
+        capacity *= 2;
+
+    index.assign(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (size_t p = 0; p < entries.size(); ++p) {
+        size_t i = entries[p].hash & mask;
+        while (index[i] != 0)
+            i = (i + 1) & mask;
+        index[i] = static_cast<uint32_t>(p + 1);
+    }
+}
+
+const Dictionary::Value* Dictionary::resolveValue(KeyView key,
+                                                  bool logErrors) const
+{
+    const Dictionary* dict = this;
+    const char* begin = key.data();
+    const char* const end = begin + key.size();
+    while (true) {
+        // If we can find the (rest of the) key directly, we can return it immediately
+        const size_t length = end - begin;
+        const Entry* e = dict->findEntry(
+            begin, length, DictionaryKey::hash(begin, length)
+        );
+        if (e != nullptr)
+            return &e->value;
+
+        const char* const separator = std::find(begin, end, '.');
+        const size_t firstLength = separator - begin;
+        if (separator != end)
+            e = dict->findEntry(
+                begin, firstLength, DictionaryKey::hash(begin, firstLength)
+            );
+
+        if (e == nullptr) {
+#ifdef GHL_DEBUG
+            if (logErrors) {
+                LERROR("Could not find key '" << string(begin, firstLength)
+                                              << "' in Dictionary");
+            }
+#endif
+            return nullptr;
+        }
+
+        // See if it is actually a Dictionary at this location
+        dict = boost::get<Dictionary>(&(e->value));
+        if (dict == nullptr) {
+            if (logErrors) {
+                LERROR("Error converting key '" << e->key() << "' to type 'Dictionary', "
+                       "was '" << valueType(e->value).name() << "'");
+            }
+            return nullptr;
+        }
+        begin = separator + 1;
+    }
+}
+
+bool Dictionary::extractValue(KeyView key, Value& value) {
+    Dictionary* dict = this;
+    const char* begin = key.data();
+    const char* const end = begin + key.size();
+    while (true) {
+        // The same precedence as in 'resolveValue': the (rest of the) key first
+        const size_t length = end - begin;
+        const Dictionary* const level = dict;
+        const Entry* const e = level->findEntry(
+            begin, length, DictionaryKey::hash(begin, length)
+        );
+        if (e != nullptr) {
+            const size_t position = e - dict->_node->entries.data();
+            dict->detach();
+            value = std::move(dict->_node->entries[position].value);
+            dict->eraseEntry(position);
+            return true;
+        }
+
+        const char* const separator = std::find(begin, end, '.');
+        if (separator == end)
+            return false;
+        const size_t firstLength = separator - begin;
+        Entry* const parent = dict->findEntry(
+            begin, firstLength, DictionaryKey::hash(begin, firstLength)
+        );
+        if (parent == nullptr)
+            return false;
+        dict = boost::get<Dictionary>(&(parent->value));
+        if (dict == nullptr)
+            return false;
+        begin = separator + 1;
+    }
+}
+
+void Dictionary::eraseEntry(size_t position) {
+    Node::Entries& entries = _node->entries;
+    entries.erase(entries.begin() + position);
+    if (entries.size() > LinearSearchThreshold)
+        rebuildIndex();
+    else
+        _node->index.clear();
+}
+
+const Dictionary* Dictionary::resolveParent(const DictionaryKey& key,
+                                            bool logErrors) const
+{
+    const Dictionary* dict = this;
+    for (size_t i = 0; i < key.nSegments() - 1; ++i) {
+        const string& segment = key.segment(i);
+        const Entry* const e = dict->findEntry(
+            segment.data(), segment.size(), key.segmentHash(i)
+        );
+        if (e == nullptr) {
+#ifdef GHL_DEBUG
+            if (logErrors)
+                LERROR("Could not find key '" << segment << "' in Dictionary");
+#endif
+            return nullptr;
+        }
+
+        dict = boost::get<Dictionary>(&(e->value));
+        if (dict == nullptr) {
+            if (logErrors) {
+                LERROR("Error converting key '" << segment << "' to type 'Dictionary', "
+                       "was '" << valueType(e->value).name() << "'");
+            }
+            return nullptr;
+        }
+    }
+    return dict;
+}
+
+const Dictionary::Value* Dictionary::resolveValue(const DictionaryKey& key,
+                                                  bool logErrors) const
+{
+    const Dictionary* const dict = resolveParent(key, logErrors);
+    if (dict == nullptr)
+        return nullptr;
+
+    const size_t last = key.nSegments() - 1;
+    const string& segment = key.segment(last);
+    const Entry* const e = dict->findEntry(
+        segment.data(), segment.size(), key.segmentHash(last)
+    );
+    if (e == nullptr) {
+#ifdef GHL_DEBUG
+        if (logErrors)
+            LERROR("Could not find key '" << segment << "' in Dictionary");
+#endif
+        return nullptr;
+    }
+    return &(e->value);
+}
+
+Dictionary* Dictionary::resolveParent(const DictionaryKey& key, bool createIntermediate) {
+    Dictionary* dict = this;
+    for (size_t i = 0; i < key.nSegments() - 1; ++i) {
+        const string& segment = key.segment(i);
+        Value* v = nullptr;
+        Entry* const e = dict->findEntry(
+            segment.data(), segment.size(), key.segmentHash(i)
+        );
+        if (e != nullptr)
+            v = &(e->value);
+        else {
+            if (createIntermediate) {
+                v = &(dict->insertValue(
+                    segment, key.segmentHash(i), Value(Dictionary(dict->arena()))
+                ));
+            }
+            else {
+                LERROR("Key '" << segment << "' was not found in dictionary");
+                return nullptr;
+            }
+        }
+
+        dict = boost::get<Dictionary>(v);
+        if (dict == nullptr) {
+            LERROR("Error converting key '" << segment << "' to type 'Dictionary', was '"
+                   << valueType(*v).name() << "'");
+            return nullptr;
+        }
+    }
+    return dict;
+}
+
+bool Dictionary::setValueInternal(string key, Value value, bool createIntermediate) {
+    Dictionary* dict = this;
+    string::size_type begin = 0;
+    while (true) {
+        const string::size_type separator = key.find('.', begin);
+        if (separator == string::npos) {
+            // if no rest exists, we can just insert the value
+            if (begin != 0)
+                key.erase(0, begin);
+            const uint64_t hash = DictionaryKey::hash(key.data(), key.size());
+            dict->insertValue(std::move(key), hash, std::move(value));
+            return true;
+        }
+
+        // if we get to this point, the 'key' did contain a nested key so we have to
+        // find the correct Dictionary (or create it if it doesn't exist)
+        const char* const first = key.data() + begin;
+        const size_t firstLength = separator - begin;
+        const uint64_t hash = DictionaryKey::hash(first, firstLength);
+        Value* v = nullptr;
+        Entry* const e = dict->findEntry(first, firstLength, hash);
+        if (e != nullptr)
+            v = &(e->value);
+        else {
+            if (createIntermediate) {
+                v = &(dict->insertValue(
+                    key.substr(begin, firstLength),
+                    hash,
+                    Value(Dictionary(dict->arena()))
+                ));
+            }
+            else {
+                LERROR("Key '" << key.substr(begin, firstLength)
+                               << "' was not found in dictionary");
+                return false;
+            }
+        }
+
+        // See if it is actually a Dictionary at this location
+        dict = boost::get<Dictionary>(v);
+        if (dict == nullptr) {
+            LERROR("Error converting key '" << key.substr(begin, firstLength)
+                   << "' to type 'Dictionary', was '" << valueType(*v).name() << "'");
+            return false;
+        }
+        begin = separator + 1;
+    }
+}
+
+template <>
+Dictionary::Value Dictionary::makeValue<boost::any>(boost::any value) {
+    // Values that were passed through the initializer_list constructor arrive wrapped in
+    // a boost::any and have to be moved into the inline storage if possible
+    const std::type_info& type = value.type();
+    if (type == typeid(IntegralType))
+        return Value(boost::any_cast<IntegralType>(value));
+    else if (type == typeid(UnsignedIntegralType))
+        return Value(boost::any_cast<UnsignedIntegralType>(value));
+    else if (type == typeid(FloatingType))
+        return Value(boost::any_cast<FloatingType>(value));
+    else if (type == typeid(std::string))
+        return Value(std::move(*boost::any_cast<std::string>(&value)));
+    else if (type == typeid(Dictionary))
+        return Value(std::move(*boost::any_cast<Dictionary>(&value)));
+    else if (type == typeid(std::vector<IntegralType>))
+        return Value(std::move(*boost::any_cast<std::vector<IntegralType>>(&value)));
+    else if (type == typeid(std::vector<FloatingType>))
+        return Value(std::move(*boost::any_cast<std::vector<FloatingType>>(&value)));
+    else
+        return Value(std::move(value));
+}
+
+const std::type_info& Dictionary::valueType(const Value& value) {
+    const boost::any* const any = boost::get<boost::any>(&value);
+    return (any != nullptr) ? any->type() : value.type();
+}
+
+namespace {
+template <size_t N>
+bool fixedSizeArray(const boost::any& any, const IntegralType*& integral,
+                    const FloatingType*& floating, size_t& size)
+{
+    typedef std::array<FloatingType, N> FloatingArray;
+    typedef std::array<IntegralType, N> IntegralArray;
+    typedef std::array<UnsignedIntegralType, N> UnsignedIntegralArray;
+
+    if (const FloatingArray* a = boost::any_cast<FloatingArray>(&any))
+        floating = a->data();
+    else if (const IntegralArray* a = boost::any_cast<IntegralArray>(&any))
+        integral = a->data();
+    else if (const UnsignedIntegralArray* a =
+                 boost::any_cast<UnsignedIntegralArray>(&any))
+    {
+        integral = reinterpret_cast<const IntegralType*>(a->data());
+    }
+    else
+        return false;
+    size = N;
+    return true;
+}
+} // namespace
+
+Dictionary::SerializedType Dictionary::serializedType(const Value& value,
+                                                      const IntegralType*& integral,
+                                                      const FloatingType*& floating,
+                                                      size_t& size)
+{
+    integral = nullptr;
+    floating = nullptr;
+    size = 0;
+    if (boost::get<IntegralType>(&value))
+        return SerializedType::Integral;
+    if (boost::get<UnsignedIntegralType>(&value))
+        return SerializedType::UnsignedIntegral;
+    if (boost::get<FloatingType>(&value))
+        return SerializedType::Floating;
+    if (boost::get<std::string>(&value))
+        return SerializedType::String;
+    if (boost::get<Dictionary>(&value))
+        return SerializedType::Dictionary;
+    typedef std::vector<IntegralType> IntegralArray;
+    typedef std::vector<FloatingType> FloatingArray;
+    if (const IntegralArray* a = boost::get<IntegralArray>(&value)) {
+        integral = a->data();
+        size = a->size();
+        return SerializedType::IntegralArray;
+    }
+    if (const FloatingArray* a = boost::get<FloatingArray>(&value)) {
+        floating = a->data();
+        size = a->size();
+        return SerializedType::FloatingArray;
+    }
+
+    // The glm types are stored as fixed-size arrays of their StorageType
+    const boost::any& any = boost::get<boost::any>(value);
+    const bool isArray =
+        fixedSizeArray<2>(any, integral, floating, size) ||
+        fixedSizeArray<3>(any, integral, floating, size) ||
+        fixedSizeArray<4>(any, integral, floating, size) ||
+        fixedSizeArray<6>(any, integral, floating, size) ||
+        fixedSizeArray<8>(any, integral, floating, size) ||
+        fixedSizeArray<9>(any, integral, floating, size) ||
+        fixedSizeArray<12>(any, integral, floating, size) ||
+        fixedSizeArray<16>(any, integral, floating, size);
+    if (!isArray)
+        return SerializedType::Unsupported;
+    return (integral != nullptr) ?
+        SerializedType::IntegralArray :
+        SerializedType::FloatingArray;
 }
 
 bool Dictionary::splitKey(const string& key, string& first, string& rest) const {
@@ -0,0 +1,96 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/dictionarykey.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace ghoul {
+
+DictionaryKey::DictionaryKey(std::string key)
+    : _key(std::move(key))
+{
+    const size_t nSegments = std::count(_key.begin(), _key.end(), '.') + 1;
+    _segments.reserve(nSegments);
+    _hashes.reserve(nSegments);
+
+    std::string::size_type begin = 0;
+    while (true) {
+        const std::string::size_type separator = _key.find('.', begin);
+        const std::string::size_type end =
+            (separator == std::string::npos) ? _key.size() : separator;
+        _segments.push_back(_key.substr(begin, end - begin));
+        _hashes.push_back(hash(_key.data() + begin, end - begin));
+        if (separator == std::string::npos)
+            break;
+        begin = separator + 1;
+    }
+}
+
+DictionaryKey::DictionaryKey(std::vector<std::string> segments)
+    : _segments(std::move(segments))
+{
+    ghoul_assert(!_segments.empty(), "Key must have at least one segment");
+
+    _hashes.reserve(_segments.size());
+    for (const std::string& segment : _segments) {
+        if (!_hashes.empty())
+            _key += '.';
+        _key += segment;
+        _hashes.push_back(hash(segment.data(), segment.size()));
+    }
+}
+
+const std::string& DictionaryKey::key() const {
+    return _key;
+}
+
+size_t DictionaryKey::nSegments() const {
+    return _segments.size();
+}
+
+const std::string& DictionaryKey::segment(size_t index) const {
+    ghoul_assert(index < _segments.size(), "Index out of range");
+    return _segments[index];
+}
+
+uint64_t DictionaryKey::segmentHash(size_t index) const {
+    ghoul_assert(index < _hashes.size(), "Index out of range");
+    return _hashes[index];
+}
+
+uint64_t DictionaryKey::hash(const char* key, size_t length) {
+    // 64 bit FNV-1a hash
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace ghoul
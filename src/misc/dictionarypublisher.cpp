@@ -0,0 +1,48 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/dictionarypublisher.h>
+
+namespace ghoul {
+
+DictionaryPublisher::DictionaryPublisher(Snapshot snapshot)
+    : _snapshot(std::move(snapshot))
+{}
+
+void DictionaryPublisher::publish(Snapshot snapshot) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _snapshot.swap(snapshot);
+    }
+    // 'snapshot' now holds the previous snapshot, which might be destroyed here if no
+    // reader uses it anymore, outside of the lock
+}
+
+DictionaryPublisher::Snapshot DictionaryPublisher::acquire() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _snapshot;
+}
+
+} // namespace ghoul
@@ -0,0 +1,588 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/mappeddictionary.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/crc32.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ghoul {
+
+namespace {
+    const std::string _loggerCat = "MappedDictionary";
+
+    const char Magic[8] = { 'G', 'H', 'O', 'U', 'L', 'D', 'C', 'T' };
+    const uint32_t Version = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        // CRC-32 of all bytes following the header
+        uint32_t checksum;
+        uint64_t fileSize;
+        uint64_t rootOffset;
+    };
+    static_assert(sizeof(Header) == 32, "Unexpected padding in the header");
+
+    // All tables and payloads start at multiples of 8 bytes in the file
+    const size_t Alignment = 8;
+
+    size_t align(std::vector<char>& data) {
+        data.resize((data.size() + Alignment - 1) & ~(Alignment - 1));
+        return data.size();
+    }
+
+    size_t append(std::vector<char>& data, const void* value, size_t size) {
+        const size_t offset = data.size();
+        const char* v = static_cast<const char*>(value);
+        data.insert(data.end(), v, v + size);
+        return offset;
+    }
+
+    bool isAligned(uint64_t offset) {
+        return (offset & (Alignment - 1)) == 0;
+    }
+} // namespace
+
+struct MappedDictionary::Record {
+    /// The offset of the key's characters from the beginning of the file
+    uint64_t keyOffset;
+    /// The number of characters in the key
+    uint32_t keyLength;
+    /// The Dictionary::SerializedType of the value
+    uint32_t type;
+    /// The number itself or the offset of the value's data for all other types
+    uint64_t value;
+};
+
+bool MappedDictionary::write(const Dictionary& dictionary, const std::string& filename) {
+    std::vector<char> data(sizeof(Header));
+    const uint64_t rootOffset = writeTable(dictionary, data);
+
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.checksum = hashCRC32(data.data() + sizeof(Header),
+                                data.size() - sizeof(Header));
+    header.fileSize = data.size();
+    header.rootOffset = rootOffset;
+    std::memcpy(data.data(), &header, sizeof(Header));
+
+    std::ofstream file(filename, std::ofstream::binary | std::ofstream::trunc);
+    if (!file.good()) {
+        LERROR("Could not open file '" << filename << "' for writing");
+        return false;
+    }
+    file.write(data.data(), data.size());
+    if (!file.good()) {
+        LERROR("Error writing file '" << filename << "'");
+        return false;
+    }
+    return true;
+}
+
+uint64_t MappedDictionary::writeTable(const Dictionary& dictionary,
+                                      std::vector<char>& data)
+{
+    typedef Dictionary::SerializedType SerializedType;
+    static_assert(sizeof(Record) == 24, "Unexpected padding in the record");
+
+    const long long* integral;
+    const double* floating;
+    size_t size;
+
+    std::vector<const Dictionary::Entry*> entries;
+    if (dictionary._node) {
+        for (const Dictionary::Entry& e : dictionary._node->entries) {
+            if (Dictionary::serializedType(e.value, integral, floating, size) ==
+                SerializedType::Unsupported)
+            {
+                LWARNING("Skipping key '" << e.key() << "' of unsupported type '"
+                         << Dictionary::valueType(e.value).name() << "'");
+            }
+            else
+                entries.push_back(&e);
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+        [](const Dictionary::Entry* lhs, const Dictionary::Entry* rhs) {
+            return lhs->key() < rhs->key();
+        }
+    );
+
+    const size_t tableOffset = align(data);
+    const uint64_t n = entries.size();
+    append(data, &n, sizeof(uint64_t));
+    data.resize(data.size() + n * sizeof(Record));
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Dictionary::Entry& e = *entries[i];
+        const SerializedType type =
+            Dictionary::serializedType(e.value, integral, floating, size);
+
+        Record record;
+        record.keyOffset = append(data, e.key().data(), e.key().size());
+        record.keyLength = static_cast<uint32_t>(e.key().size());
+        record.type = static_cast<uint32_t>(type);
+        record.value = 0;
+        switch (type) {
+            case SerializedType::Integral:
+                std::memcpy(&record.value, &boost::get<long long>(e.value),
+                            sizeof(uint64_t));
+                break;
+            case SerializedType::UnsignedIntegral:
+                record.value = boost::get<unsigned long long>(e.value);
+                break;
+            case SerializedType::Floating:
+                std::memcpy(&record.value, &boost::get<double>(e.value),
+                            sizeof(uint64_t));
+                break;
+            case SerializedType::String: {
+                const std::string& s = boost::get<std::string>(e.value);
+                const uint64_t length = s.size();
+                record.value = align(data);
+                append(data, &length, sizeof(uint64_t));
+                append(data, s.data(), s.size());
+            } break;
+            case SerializedType::Dictionary:
+                record.value = writeTable(boost::get<Dictionary>(e.value), data);
+                break;
+            case SerializedType::IntegralArray:
+            case SerializedType::FloatingArray: {
+                const uint64_t count = size;
+                record.value = align(data);
+                append(data, &count, sizeof(uint64_t));
+                if (integral)
+                    append(data, integral, size * sizeof(long long));
+                else
+                    append(data, floating, size * sizeof(double));
+            } break;
+            default:
+                break;
+        }
+
+        const size_t recordOffset = tableOffset + sizeof(uint64_t) + i * sizeof(Record);
+        std::memcpy(data.data() + recordOffset, &record, sizeof(Record));
+    }
+    return tableOffset;
+}
+
+MappedDictionary::MappedDictionary(const std::string& filename, bool verifyChecksum)
+    : _data(nullptr)
+    , _size(0)
+#ifdef WIN32
+    , _file(nullptr)
+    , _mapping(nullptr)
+#endif
+{
+#ifdef WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        LERROR("Could not open file '" << filename << "'");
+        return;
+    }
+    _file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        LERROR("Could not determine the size of file '" << filename << "'");
+        CloseHandle(file);
+        _file = nullptr;
+        return;
+    }
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        LERROR("Could not map file '" << filename << "'");
+        CloseHandle(file);
+        _file = nullptr;
+        return;
+    }
+    _mapping = mapping;
+    _data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr) {
+        LERROR("Could not map file '" << filename << "'");
+        CloseHandle(mapping);
+        CloseHandle(file);
+        _mapping = nullptr;
+        _file = nullptr;
+        return;
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+#else
+    const int file = open(filename.c_str(), O_RDONLY);
+    if (file == -1) {
+        LERROR("Could not open file '" << filename << "'");
+        return;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        LERROR("Could not determine the size of file '" << filename << "'");
+        ::close(file);
+        return;
+    }
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping stays valid after the file descriptor is closed
+    ::close(file);
+    if (data == MAP_FAILED) {
+        LERROR("Could not map file '" << filename << "': " << strerror(errno));
+        return;
+    }
+    _data = static_cast<const char*>(data);
+    _size = static_cast<size_t>(status.st_size);
+#endif
+
+    bool isValid = _size >= sizeof(Header);
+    if (isValid) {
+        Header header;
+        std::memcpy(&header, _data, sizeof(Header));
+        uint64_t nEntries;
+        isValid = (std::memcmp(header.magic, Magic, sizeof(Magic)) == 0) &&
+                  (header.version == Version) &&
+                  (header.fileSize == _size) &&
+                  (table(header.rootOffset, nEntries) != nullptr);
+    }
+    if (!isValid)
+        LERROR("File '" << filename << "' is not a valid Dictionary file");
+    else if (verifyChecksum && !this->verifyChecksum()) {
+        LERROR("Checksum of file '" << filename << "' does not match");
+        isValid = false;
+    }
+
+    if (!isValid)
+        unmap();
+}
+
+MappedDictionary::~MappedDictionary() {
+    unmap();
+}
+
+void MappedDictionary::unmap() {
+#ifdef WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(_mapping);
+    if (_file)
+        CloseHandle(_file);
+    _mapping = nullptr;
+    _file = nullptr;
+#else
+    if (_data)
+        munmap(const_cast<char*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
+bool MappedDictionary::isValid() const {
+    return _data != nullptr;
+}
+
+bool MappedDictionary::verifyChecksum() const {
+    if (!isValid())
+        return false;
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+    const unsigned int checksum = hashCRC32(_data + sizeof(Header),
+                                            _size - sizeof(Header));
+    return checksum == header.checksum;
+}
+
+bool MappedDictionary::hasKey(const std::string& key) const {
+    return findRecord(key) != nullptr;
+}
+
+std::vector<std::string> MappedDictionary::keys(const std::string& location) const {
+    std::vector<std::string> result;
+    if (!isValid())
+        return result;
+
+    uint64_t tableOffset;
+    if (location.empty()) {
+        Header header;
+        std::memcpy(&header, _data, sizeof(Header));
+        tableOffset = header.rootOffset;
+    }
+    else {
+        const Record* r = findRecord(location);
+        if (r == nullptr) {
+            LERROR("Key '" << location << "' did not exist");
+            return result;
+        }
+        if (r->type != static_cast<uint32_t>(Dictionary::SerializedType::Dictionary)) {
+            LERROR("Key '" << location << "' was not a Dictionary");
+            return result;
+        }
+        tableOffset = r->value;
+    }
+
+    uint64_t n;
+    const Record* records = table(tableOffset, n);
+    if (records == nullptr)
+        return result;
+    result.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        const Record& r = records[i];
+        if (r.keyOffset > _size || r.keyLength > _size - r.keyOffset) {
+            LERROR("Keys at '" << location << "' could not be read");
+            return std::vector<std::string>();
+        }
+        result.emplace_back(_data + r.keyOffset, r.keyLength);
+    }
+    return result;
+}
+
+bool MappedDictionary::getValue(const std::string& key, std::string& value) const {
+    const Record* r = findRecord(key);
+    if (r == nullptr ||
+        r->type != static_cast<uint32_t>(Dictionary::SerializedType::String))
+    {
+        return false;
+    }
+
+    return readString(*r, value);
+}
+
+bool MappedDictionary::getValue(const std::string& key, Dictionary& value) const {
+    if (!isValid())
+        return false;
+    if (key.empty()) {
+        Header header;
+        std::memcpy(&header, _data, sizeof(Header));
+        return readTable(header.rootOffset, value);
+    }
+
+    const Record* r = findRecord(key);
+    if (r == nullptr ||
+        r->type != static_cast<uint32_t>(Dictionary::SerializedType::Dictionary))
+    {
+        return false;
+    }
+    return readTable(r->value, value);
+}
+
+bool MappedDictionary::readString(const Record& record, std::string& value) const {
+    if (!isAligned(record.value) || record.value > _size - sizeof(uint64_t))
+        return false;
+    uint64_t length;
+    std::memcpy(&length, _data + record.value, sizeof(uint64_t));
+    if (length > _size - record.value - sizeof(uint64_t))
+        return false;
+    value.assign(_data + record.value + sizeof(uint64_t), length);
+    return true;
+}
+
+bool MappedDictionary::number(const std::string& key, Number& value) const {
+    typedef Dictionary::SerializedType SerializedType;
+    const Record* r = findRecord(key);
+    if (r == nullptr)
+        return false;
+
+    switch (static_cast<SerializedType>(r->type)) {
+        case SerializedType::Integral:
+            value.type = Number::Type::Integral;
+            std::memcpy(&value.integral, &r->value, sizeof(uint64_t));
+            return true;
+        case SerializedType::UnsignedIntegral:
+            value.type = Number::Type::UnsignedIntegral;
+            value.unsignedIntegral = r->value;
+            return true;
+        case SerializedType::Floating:
+            value.type = Number::Type::Floating;
+            std::memcpy(&value.floating, &r->value, sizeof(uint64_t));
+            return true;
+        default:
+            return false;
+    }
+}
+
+const MappedDictionary::Record* MappedDictionary::findRecord(const std::string& key) const
+{
+    if (!isValid())
+        return nullptr;
+
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+    uint64_t tableOffset = header.rootOffset;
+
+    // Follow the nested key one level at a time; only the tables along the path are
+    // touched
+    std::string::size_type begin = 0;
+    while (true) {
+        const std::string::size_type end = key.find('.', begin);
+        const size_t length = (end == std::string::npos) ?
+            key.size() - begin :
+            end - begin;
+        const Record* r = findRecord(tableOffset, key.data() + begin, length);
+        if (r == nullptr || end == std::string::npos)
+            return r;
+        if (r->type != static_cast<uint32_t>(Dictionary::SerializedType::Dictionary))
+            return nullptr;
+        tableOffset = r->value;
+        begin = end + 1;
+    }
+}
+
+const MappedDictionary::Record* MappedDictionary::findRecord(uint64_t tableOffset,
+                                                             const char* key,
+                                                             size_t length) const
+{
+    uint64_t n;
+    const Record* records = table(tableOffset, n);
+    if (records == nullptr)
+        return nullptr;
+
+    // Binary search in the sorted records of this level, comparing the keys in the
+    // same order as std::string does
+    uint64_t low = 0;
+    uint64_t high = n;
+    while (low < high) {
+        const uint64_t mid = low + (high - low) / 2;
+        const Record& r = records[mid];
+        if (r.keyOffset > _size || r.keyLength > _size - r.keyOffset)
+            return nullptr;
+
+        int cmp = std::char_traits<char>::compare(
+            _data + r.keyOffset, key, std::min<size_t>(r.keyLength, length)
+        );
+        if (cmp == 0)
+            cmp = (r.keyLength < length) ? -1 : ((r.keyLength > length) ? 1 : 0);
+
+        if (cmp == 0)
+            return &r;
+        else if (cmp < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return nullptr;
+}
+
+const MappedDictionary::Record* MappedDictionary::table(uint64_t tableOffset,
+                                                        uint64_t& size) const
+{
+    if (!isAligned(tableOffset) || tableOffset < sizeof(Header) ||
+        tableOffset > _size - sizeof(uint64_t))
+    {
+        return nullptr;
+    }
+    std::memcpy(&size, _data + tableOffset, sizeof(uint64_t));
+    const uint64_t available = _size - tableOffset - sizeof(uint64_t);
+    if (size > available / sizeof(Record))
+        return nullptr;
+    return reinterpret_cast<const Record*>(_data + tableOffset + sizeof(uint64_t));
+}
+
+bool MappedDictionary::readTable(uint64_t tableOffset, Dictionary& dictionary) const {
+    typedef Dictionary::SerializedType SerializedType;
+
+    uint64_t n;
+    const Record* records = table(tableOffset, n);
+    if (records == nullptr)
+        return false;
+
+    for (uint64_t i = 0; i < n; ++i) {
+        const Record& r = records[i];
+        if (r.keyOffset > _size || r.keyLength > _size - r.keyOffset)
+            return false;
+        std::string key(_data + r.keyOffset, r.keyLength);
+
+        Dictionary::Value value;
+        switch (static_cast<SerializedType>(r.type)) {
+            case SerializedType::Integral: {
+                long long v;
+                std::memcpy(&v, &r.value, sizeof(uint64_t));
+                value = v;
+            } break;
+            case SerializedType::UnsignedIntegral:
+                value = static_cast<unsigned long long>(r.value);
+                break;
+            case SerializedType::Floating: {
+                double v;
+                std::memcpy(&v, &r.value, sizeof(uint64_t));
+                value = v;
+            } break;
+            case SerializedType::String: {
+                std::string v;
+                if (!readString(r, v))
+                    return false;
+                value = std::move(v);
+            } break;
+            case SerializedType::Dictionary: {
+                // The tables of nested levels are always written after their parent,
+                // so an offset that points backwards would create a cycle
+                if (r.value <= tableOffset)
+                    return false;
+                Dictionary v;
+                if (!readTable(r.value, v))
+                    return false;
+                value = std::move(v);
+            } break;
+            case SerializedType::IntegralArray:
+            case SerializedType::FloatingArray: {
+                if (!isAligned(r.value) || r.value > _size - sizeof(uint64_t))
+                    return false;
+                uint64_t count;
+                std::memcpy(&count, _data + r.value, sizeof(uint64_t));
+                const uint64_t available = _size - r.value - sizeof(uint64_t);
+                if (count > available / sizeof(uint64_t))
+                    return false;
+                const char* begin = _data + r.value + sizeof(uint64_t);
+                if (r.type == static_cast<uint32_t>(SerializedType::IntegralArray)) {
+                    std::vector<long long> v(count);
+                    std::memcpy(v.data(), begin, count * sizeof(long long));
+                    value = std::move(v);
+                }
+                else {
+                    std::vector<double> v(count);
+                    std::memcpy(v.data(), begin, count * sizeof(double));
+                    value = std::move(v);
+                }
+            } break;
+            default:
+                LERROR("Unknown type '" << r.type << "' for key '" << key << "'");
+                return false;
+        }
+        const uint64_t hash = DictionaryKey::hash(key.data(), key.size());
+        dictionary.insertValue(std::move(key), hash, std::move(value));
+    }
+    return true;
+}
+
+} // namespace ghoul
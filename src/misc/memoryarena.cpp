@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/memoryarena.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace ghoul {
+
+MemoryArena::MemoryArena(size_t blockSize)
+    : _blockSize(blockSize)
+    , _current(nullptr)
+    , _end(nullptr)
+    , _usedBytes(0)
+    , _peakBytes(0)
+    , _reservedBytes(0)
+{}
+
+MemoryArena::~MemoryArena() {}
+
+void* MemoryArena::allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uintptr_t p = reinterpret_cast<uintptr_t>(_current);
+    p = (p + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (_current == nullptr || p + bytes > reinterpret_cast<uintptr_t>(_end)) {
+        if (bytes + alignment > _blockSize / 4) {
+            // Large allocations get a block of their own so that the remainder of the
+            // current block is not wasted
+            std::unique_ptr<char[]> block(new char[bytes + alignment]);
+            p = reinterpret_cast<uintptr_t>(block.get());
+            p = (p + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            _reservedBytes += bytes + alignment;
+            _blocks.push_back(std::move(block));
+        }
+        else {
+            _blocks.emplace_back(new char[_blockSize]);
+            _current = _blocks.back().get();
+            _end = _current + _blockSize;
+            _reservedBytes += _blockSize;
+            p = reinterpret_cast<uintptr_t>(_current);
+            p = (p + alignment - 1) & ~(uintptr_t(alignment) - 1);
+            _current = reinterpret_cast<char*>(p + bytes);
+        }
+    }
+    else
+        _current = reinterpret_cast<char*>(p + bytes);
+
+    _usedBytes += bytes;
+    _peakBytes = std::max(_peakBytes, _usedBytes);
+    return reinterpret_cast<void*>(p);
+}
+
+void MemoryArena::deallocate(void*, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _usedBytes -= bytes;
+}
+
+size_t MemoryArena::usedBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usedBytes;
+}
+
+size_t MemoryArena::peakBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _peakBytes;
+}
+
+size_t MemoryArena::reservedBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reservedBytes;
+}
+
+size_t MemoryArena::nBlocks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _blocks.size();
+}
+
+} // namespace ghoul
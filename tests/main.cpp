@@ -38,8 +38,9 @@
 #include "tests/test_buffer.inl"
 #include "tests/test_luatodictionary.inl"
 #include "tests/test_commandlineparser.inl"
-//#include "tests/test_dictionary.inl"  Disabled until "Bus error" crash is fixed ---abock
+#include "tests/test_dictionary.inl"
 #include "tests/test_filesystem.inl"
+#include "tests/test_mpscqueue.inl"
 
 using namespace ghoul::cmdparser;
 using namespace ghoul::filesystem;
@@ -24,6 +24,8 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/buffer.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/glm.h>
 
 TEST(Buffer, String) {
     
@@ -269,3 +271,59 @@ TEST(Buffer, Vector) {
     
 }
 
+TEST(Buffer, Dictionary) {
+    ghoul::Dictionary d1 = { { "a", 1 }, { "b", 2.5 }, { "c", std::string("string") } };
+    d1.setValue("d.e", glm::dvec3(1.0, 2.0, 3.0), true);
+    d1.setValue("d.f", glm::uvec2(4u, 5u));
+
+    ghoul::Buffer buffer;
+    buffer.serialize(d1);
+    buffer.serialize(42);
+
+    ghoul::Dictionary d2;
+    int i;
+    buffer.deserialize(d2);
+    buffer.deserialize(i);
+
+    EXPECT_EQ(42, i);
+    EXPECT_EQ(d1.keys(), d2.keys());
+    int a;
+    EXPECT_TRUE(d2.getValue("a", a));
+    EXPECT_EQ(1, a);
+    double b;
+    EXPECT_TRUE(d2.getValue("b", b));
+    EXPECT_EQ(2.5, b);
+    std::string c;
+    EXPECT_TRUE(d2.getValue("c", c));
+    EXPECT_EQ("string", c);
+    glm::dvec3 e;
+    EXPECT_TRUE(d2.getValue("d.e", e));
+    EXPECT_EQ(glm::dvec3(1.0, 2.0, 3.0), e);
+    glm::uvec2 f;
+    EXPECT_TRUE(d2.getValue("d.f", f));
+    EXPECT_EQ(glm::uvec2(4u, 5u), f);
+}
+
+TEST(Buffer, DictionaryTruncated) {
+    ghoul::Dictionary d1 = { { "a", 1 }, { "b", 2.5 }, { "c", std::string("string") } };
+    d1.setValue("d.e", glm::dvec3(1.0, 2.0, 3.0), true);
+    d1.setValue("d.f", glm::uvec2(4u, 5u));
+
+    ghoul::Buffer buffer;
+    buffer.serialize(d1);
+
+    // A truncated Buffer is rejected and leaves the Dictionary untouched
+    for (size_t size = 0; size < buffer.size(); ++size) {
+        ghoul::Buffer truncated;
+        truncated.serialize(buffer.data(), size);
+        ghoul::Dictionary d2 = { { "x", 1 } };
+        EXPECT_FALSE(truncated.deserialize(d2)) << size;
+        EXPECT_EQ(std::vector<std::string>{ "x" }, d2.keys()) << size;
+    }
+
+    ghoul::Buffer complete;
+    complete.serialize(buffer.data(), buffer.size());
+    ghoul::Dictionary d2 = { { "x", 1 } };
+    EXPECT_TRUE(complete.deserialize(d2));
+    EXPECT_EQ(5u, d2.size());
+}
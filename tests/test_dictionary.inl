@@ -24,7 +24,11 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/dictionarypublisher.h>
+#include <ghoul/misc/dictionaryschema.h>
+#include <ghoul/misc/mappeddictionary.h>
 #include <ghoul/glm.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -320,6 +324,70 @@ TEST_F(DictionaryTest, TimingTest) {
 	FINISH_TIMER(getValueNumber1000a750, logFile);
 }
 
+TEST_F(DictionaryTest, StorageTimingTest) {
+    std::ofstream logFile("DictionaryStorageTest.timing");
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 20000; ++i)
+        keys.push_back("Key" + std::to_string(i));
+
+    START_TIMER(setValue20000Keys, logFile, 5);
+    for (const std::string& k : keys)
+        _d->setValue(k, 1.0);
+    FINISH_TIMER(setValue20000Keys, logFile);
+
+    START_TIMER(setValue100000ArrayKeys, logFile, 5);
+    for (int i = 1; i <= 100000; ++i)
+        _d->setValue(std::to_string(i), double(i));
+    FINISH_TIMER(setValue100000ArrayKeys, logFile);
+
+    ghoul::Dictionary d20000;
+    for (const std::string& k : keys)
+        d20000.setValue(k, 1.0);
+
+    double value;
+    START_TIMER_PREPARE(getValue20000Keys, logFile, 5, { *_d = d20000; });
+    for (const std::string& k : keys)
+        _d->getValue(k, value);
+    FINISH_TIMER(getValue20000Keys, logFile);
+
+    START_TIMER_PREPARE(hasKey20000Keys, logFile, 5, { *_d = d20000; });
+    for (const std::string& k : keys)
+        _d->hasKey(k);
+    FINISH_TIMER(hasKey20000Keys, logFile);
+
+    START_TIMER_PREPARE(getValueNested100000, logFile, 5,
+    { _d->setValue("Renderable.Geometry.Radius", 5.0, true); });
+    for (int i = 0; i < 100000; ++i)
+        _d->getValue("Renderable.Geometry.Radius", value);
+    FINISH_TIMER(getValueNested100000, logFile);
+
+    const ghoul::DictionaryKey radiusKey("Renderable.Geometry.Radius");
+    START_TIMER_PREPARE(getValueNestedKey100000, logFile, 5,
+    { _d->setValue("Renderable.Geometry.Radius", 5.0, true); });
+    for (int i = 0; i < 100000; ++i)
+        _d->getValue(radiusKey, value);
+    FINISH_TIMER(getValueNestedKey100000, logFile);
+
+    START_TIMER(copy20000Keys, logFile, 5);
+    ghoul::Dictionary copy = d20000;
+    FINISH_TIMER(copy20000Keys, logFile);
+
+    // 100 levels of 200 keys each, of which only one level is rehashed
+    ghoul::Dictionary nested20000;
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 200; ++j) {
+            const std::string k = "a" + std::to_string(i) + ".b" + std::to_string(j);
+            nested20000.setValue(k, 1.0, true);
+        }
+    }
+    START_TIMER_PREPARE(rehash20000KeysAfterChange, logFile, 5,
+    { *_d = nested20000; _d->hash(); });
+    _d->setValue("a50.b100", 2.0);
+    _d->hash();
+    FINISH_TIMER(rehash20000KeysAfterChange, logFile);
+}
+
 #endif // GHL_TIMING_TESTS
 
 TEST_F(DictionaryTest, EmptyTest) {
@@ -333,6 +401,799 @@ TEST_F(DictionaryTest, ClearTest) {
     EXPECT_EQ(0, _d->size());
 }
 
+TEST_F(DictionaryTest, ManyKeys) {
+    // Enough keys to use the index instead of the linear search
+    for (int i = 0; i < 1000; ++i)
+        _d->setValue("a" + std::to_string(i), i);
+    EXPECT_EQ(1000, _d->size());
+
+    for (int i = 0; i < 1000; ++i) {
+        int value;
+        const bool success = _d->getValue("a" + std::to_string(i), value);
+        ASSERT_EQ(true, success) << "success 'a" << i << "'";
+        ASSERT_EQ(i, value) << "value 'a" << i << "'";
+    }
+
+    int value;
+    _d->setValue("a500", 1);
+    EXPECT_EQ(1000, _d->size());
+    _d->getValue("a500", value);
+    EXPECT_EQ(1, value);
+
+    for (int i = 0; i < 1000; i += 2)
+        EXPECT_EQ(true, _d->removeKey("a" + std::to_string(i)));
+    EXPECT_EQ(500, _d->size());
+    EXPECT_EQ(false, _d->hasKey("a0"));
+    EXPECT_EQ(true, _d->hasKey("a1"));
+    EXPECT_EQ(false, _d->removeKey("a0"));
+    _d->getValue("a999", value);
+    EXPECT_EQ(999, value);
+}
+
+TEST_F(DictionaryTest, KeysAreSorted) {
+    _d->setValue("c", 1);
+    _d->setValue("a", 1);
+    _d->setValue("b", 1);
+    const std::vector<std::string> keys = _d->keys();
+    ASSERT_EQ(3, keys.size());
+    EXPECT_EQ("a", keys[0]);
+    EXPECT_EQ("b", keys[1]);
+    EXPECT_EQ("c", keys[2]);
+}
+
+TEST_F(DictionaryTest, DictionaryKey) {
+    const ghoul::DictionaryKey key("a.b.c");
+    ASSERT_EQ(3, key.nSegments());
+    EXPECT_EQ("a.b.c", key.key());
+    EXPECT_EQ("b", key.segment(1));
+
+    EXPECT_FALSE(_d->hasKey(key));
+    EXPECT_FALSE(_d->setValue(key, 1));
+    EXPECT_TRUE(_d->setValue(key, 1, true));
+    EXPECT_TRUE(_d->hasKey(key));
+    EXPECT_TRUE(_d->hasKey("a.b.c"));
+    EXPECT_TRUE(_d->hasKeyAndValue<int>(key));
+    EXPECT_FALSE(_d->hasValue<std::string>(key));
+
+    int value = 0;
+    EXPECT_TRUE(_d->getValue(key, value));
+    EXPECT_EQ(1, value);
+
+    // Conversions are applied the same way as for std::string keys
+    EXPECT_TRUE(_d->setValue(key, glm::vec3(1.f, 2.f, 3.f)));
+    glm::dvec3 vec;
+    EXPECT_TRUE(_d->getValue(key, vec));
+    EXPECT_EQ(glm::dvec3(1.0, 2.0, 3.0), vec);
+
+    const ghoul::DictionaryKey partial("a.b");
+    EXPECT_TRUE(_d->hasValue<ghoul::Dictionary>(partial));
+    const ghoul::DictionaryKey nonExisting("a.d.c");
+    EXPECT_FALSE(_d->hasKey(nonExisting));
+    EXPECT_FALSE(_d->getValue(nonExisting, value));
+
+    // Segments that contain separators are used literally, including the last one
+    const ghoul::DictionaryKey verbatim(std::vector<std::string>{ "L", "a.b" });
+    EXPECT_TRUE(_d->setValue(verbatim, 2, true));
+    EXPECT_TRUE(_d->hasKey(verbatim));
+    EXPECT_FALSE(_d->hasKey("L.a"));
+    EXPECT_TRUE(_d->hasKeyAndValue<int>(verbatim));
+    EXPECT_TRUE(_d->getValue(verbatim, value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(2, _d->value<int>(verbatim));
+    ASSERT_NE(nullptr, _d->valuePtr<long long>(verbatim));
+    EXPECT_EQ(2, *_d->valuePtr<long long>(verbatim));
+    EXPECT_EQ(std::vector<std::string>{ "a.b" }, _d->subDictionary("L").keys());
+    EXPECT_TRUE(_d->setValue(verbatim, glm::vec3(1.f, 2.f, 3.f)));
+    EXPECT_TRUE(_d->getValue(verbatim, vec));
+    EXPECT_EQ(glm::dvec3(1.0, 2.0, 3.0), vec);
+}
+
+TEST_F(DictionaryTest, ValuePtr) {
+    _d->setValue("a", 1);
+    _d->setValue("b", std::string("foo"));
+    _d->setValue("c.d", 2.0, true);
+
+    // Values are stored in their storage type, so no conversion takes place
+    EXPECT_EQ(nullptr, _d->valuePtr<int>("a"));
+    ASSERT_NE(nullptr, _d->valuePtr<long long>("a"));
+    EXPECT_EQ(1, *_d->valuePtr<long long>("a"));
+    ASSERT_NE(nullptr, _d->valuePtr<std::string>("b"));
+    EXPECT_EQ("foo", *_d->valuePtr<std::string>("b"));
+    ASSERT_NE(nullptr, _d->valuePtr<double>("c.d"));
+    EXPECT_EQ(2.0, *_d->valuePtr<double>(ghoul::DictionaryKey("c.d")));
+    EXPECT_EQ(nullptr, _d->valuePtr<double>("c.e"));
+    EXPECT_EQ(nullptr, _d->valuePtr<std::string>("a"));
+}
+
+TEST_F(DictionaryTest, SubDictionary) {
+    _d->setValue("a.b.c", 1, true);
+    _d->setValue("d", 1);
+
+    const ghoul::Dictionary& b = _d->subDictionary("a.b");
+    EXPECT_EQ(_d->valuePtr<ghoul::Dictionary>("a.b"), &b);
+    EXPECT_TRUE(b.hasKey("c"));
+    EXPECT_EQ(&b, &(_d->subDictionary(ghoul::DictionaryKey("a.b"))));
+    EXPECT_TRUE(_d->subDictionary("d").empty());
+    EXPECT_TRUE(_d->subDictionary("e").empty());
+}
+
+TEST_F(DictionaryTest, ForEach) {
+    _d->setValue("c", 1);
+    _d->setValue("a.b", 1, true);
+    _d->setValue("b", 1);
+
+    std::vector<std::string> keys;
+    int nDictionaries = 0;
+    _d->forEach([&](const std::string& key, const ghoul::Dictionary* dictionary) {
+        keys.push_back(key);
+        if (dictionary != nullptr) {
+            ++nDictionaries;
+            EXPECT_TRUE(dictionary->hasKey("b"));
+        }
+    });
+    // Entries are visited in insertion order
+    ASSERT_EQ(3, keys.size());
+    EXPECT_EQ("c", keys[0]);
+    EXPECT_EQ("a", keys[1]);
+    EXPECT_EQ("b", keys[2]);
+    EXPECT_EQ(1, nDictionaries);
+}
+
+TEST_F(DictionaryTest, ContiguousArrays) {
+    _d->setValue("f", std::vector<double>{ 1.0, 2.0, 3.0 });
+    _d->setValue("i", std::vector<long long>{ 1, 2, 3, 4 });
+    _d->setValue("d.1", 1.0, true);
+    _d->setValue("d.2", 2.0);
+
+    ASSERT_NE(nullptr, _d->valuePtr<std::vector<double>>("f"));
+    EXPECT_EQ(3, _d->valuePtr<std::vector<double>>("f")->size());
+
+    // Arrays are converted into the types with the correct number of values
+    EXPECT_TRUE(_d->hasValue<glm::vec3>("f"));
+    EXPECT_FALSE(_d->hasValue<glm::vec4>("f"));
+    EXPECT_TRUE(_d->hasValue<glm::ivec4>("i"));
+    EXPECT_TRUE(_d->hasValue<glm::mat2x2>("i"));
+    glm::dvec3 vec;
+    EXPECT_TRUE(_d->getValue("f", vec));
+    EXPECT_EQ(glm::dvec3(1.0, 2.0, 3.0), vec);
+    glm::mat2x2 mat;
+    EXPECT_TRUE(_d->getValue("i", mat));
+    EXPECT_EQ(glm::mat2x2(1.f, 2.f, 3.f, 4.f), mat);
+
+    std::vector<float> floats;
+    EXPECT_TRUE(_d->getArray("f", floats));
+    EXPECT_EQ(std::vector<float>({ 1.f, 2.f, 3.f }), floats);
+    std::vector<int> ints;
+    EXPECT_TRUE(_d->getArray("i", ints));
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4 }), ints);
+    EXPECT_TRUE(_d->getArray("d", ints));
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), ints);
+
+    ghoul::Dictionary d = { { "a", std::vector<double>{ 1.0, 2.0 } } };
+    EXPECT_NE(nullptr, d.valuePtr<std::vector<double>>("a"));
+}
+
+TEST_F(DictionaryTest, CopyOnWrite) {
+    _d->setValue("a.b.c", 1, true);
+    _d->setValue("x.y", 2, true);
+
+    ghoul::Dictionary copy = *_d;
+    const ghoul::Dictionary::MemoryUsage shared = copy.memoryUsage();
+    EXPECT_EQ(4, shared.nNodes);
+    EXPECT_EQ(shared.bytes, shared.sharedBytes);
+    EXPECT_EQ(shared.bytes, shared.logicalBytes);
+
+    EXPECT_TRUE(copy.setValue("a.b.c", 3));
+    EXPECT_TRUE(copy.setValue("a.d", 4));
+    int value;
+    EXPECT_TRUE(_d->getValue("a.b.c", value));
+    EXPECT_EQ(1, value);
+    EXPECT_FALSE(_d->hasKey("a.d"));
+    EXPECT_TRUE(copy.getValue("a.b.c", value));
+    EXPECT_EQ(3, value);
+
+    // Only the path to the modified values was copied, 'x' is still shared
+    const ghoul::Dictionary::MemoryUsage modified = copy.memoryUsage();
+    EXPECT_EQ(4, modified.nNodes);
+    EXPECT_GT(modified.sharedBytes, 0);
+    EXPECT_LT(modified.sharedBytes, modified.bytes);
+
+    // The same Dictionary stored twice is only counted once
+    ghoul::Dictionary twice;
+    twice.setValue("a", *_d);
+    twice.setValue("b", *_d);
+    const ghoul::Dictionary::MemoryUsage u = twice.memoryUsage();
+    EXPECT_LT(u.bytes, u.logicalBytes);
+
+    copy.removeKey("x");
+    EXPECT_TRUE(_d->hasKey("x.y"));
+}
+
+TEST_F(DictionaryTest, Freeze) {
+    for (int i = 0; i < 20; ++i)
+        _d->setValue("a." + std::to_string(i), i, true);
+    _d->setValue("b", _d->subDictionary("a"));
+
+    std::shared_ptr<const ghoul::Dictionary> snapshot = _d->freeze();
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ(2, snapshot->size());
+    int value;
+    EXPECT_TRUE(snapshot->getValue("a.19", value));
+    EXPECT_EQ(19, value);
+    // Shared levels stay shared in the snapshot
+    const ghoul::Dictionary::MemoryUsage usage = snapshot->memoryUsage();
+    EXPECT_EQ(2, usage.nNodes);
+    EXPECT_LE(usage.bytes, _d->memoryUsage().bytes);
+
+    _d->setValue("a.19", 20);
+    _d->clear();
+    EXPECT_TRUE(snapshot->getValue("b.19", value));
+    EXPECT_EQ(19, value);
+
+    ghoul::DictionaryPublisher publisher;
+    EXPECT_EQ(nullptr, publisher.acquire());
+    publisher.publish(snapshot);
+    std::shared_ptr<const ghoul::Dictionary> acquired = publisher.acquire();
+    EXPECT_EQ(snapshot, acquired);
+    publisher.publish(ghoul::Dictionary().freeze());
+    EXPECT_TRUE(publisher.acquire()->empty());
+    EXPECT_TRUE(acquired->hasKey("a.0"));
+}
+
+TEST_F(DictionaryTest, MappedDictionary) {
+    _d->setValue("int", 1);
+    _d->setValue("uint", 2u);
+    _d->setValue("double", 3.5);
+    _d->setValue("string", std::string("value"));
+    _d->setValue("vec3", glm::vec3(1.f, 2.f, 3.f));
+    _d->setValue("ivec2", glm::ivec2(4, 5));
+    for (int i = 0; i < 50; ++i)
+        _d->setValue("nested.level." + std::to_string(i), i, true);
+    _d->setValue("unsupported", std::vector<int>(2));
+
+    ASSERT_TRUE(ghoul::MappedDictionary::write(*_d, "dictionary.bin"));
+    ghoul::MappedDictionary m("dictionary.bin", true);
+    ASSERT_TRUE(m.isValid());
+
+    EXPECT_TRUE(m.hasKey("nested.level.49"));
+    EXPECT_FALSE(m.hasKey("nested.level.50"));
+    EXPECT_FALSE(m.hasKey("unsupported"));
+    EXPECT_FALSE(m.hasKey("int.a"));
+
+    int i;
+    EXPECT_TRUE(m.getValue("int", i));
+    EXPECT_EQ(1, i);
+    unsigned int u;
+    EXPECT_TRUE(m.getValue("uint", u));
+    EXPECT_EQ(2u, u);
+    double d;
+    EXPECT_TRUE(m.getValue("double", d));
+    EXPECT_EQ(3.5, d);
+    EXPECT_TRUE(m.getValue("nested.level.27", i));
+    EXPECT_EQ(27, i);
+    std::string s;
+    EXPECT_TRUE(m.getValue("string", s));
+    EXPECT_EQ("value", s);
+    EXPECT_FALSE(m.getValue("int", s));
+
+    const std::vector<std::string> keys = m.keys();
+    ASSERT_EQ(7, keys.size());
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    EXPECT_EQ(50, m.keys("nested.level").size());
+
+    ghoul::Dictionary level;
+    ASSERT_TRUE(m.getValue("nested.level", level));
+    EXPECT_EQ(50, level.size());
+    EXPECT_TRUE(level.getValue("13", i));
+    EXPECT_EQ(13, i);
+
+    ghoul::Dictionary all;
+    ASSERT_TRUE(m.getValue("", all));
+    glm::vec3 v;
+    EXPECT_TRUE(all.getValue("vec3", v));
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), v);
+    glm::ivec2 iv;
+    EXPECT_TRUE(all.getValue("ivec2", iv));
+    EXPECT_EQ(glm::ivec2(4, 5), iv);
+
+    // A corrupted file is rejected when the checksum is verified
+    {
+        std::fstream f("dictionary.bin",
+                       std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('x');
+    }
+    EXPECT_FALSE(ghoul::MappedDictionary("dictionary.bin", true).isValid());
+    EXPECT_FALSE(ghoul::MappedDictionary("nonexisting.bin").isValid());
+
+    // A nested table that points back at its parent is rejected instead of recursing
+    ghoul::Dictionary cyclic;
+    cyclic.setValue("a.b", 1, true);
+    ASSERT_TRUE(ghoul::MappedDictionary::write(cyclic, "dictionary.bin"));
+    {
+        // The root table follows the 32-byte header, its only record belongs to 'a'
+        const uint64_t rootOffset = 32;
+        std::fstream f("dictionary.bin",
+                       std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(rootOffset + sizeof(uint64_t) + 16);
+        f.write(reinterpret_cast<const char*>(&rootOffset), sizeof(uint64_t));
+    }
+    ghoul::MappedDictionary c("dictionary.bin");
+    ASSERT_TRUE(c.isValid());
+    ghoul::Dictionary result;
+    EXPECT_FALSE(c.getValue("", result));
+    EXPECT_FALSE(c.getValue("a", result));
+
+    // A key that lies outside of the file is not read when listing the keys
+    ASSERT_TRUE(ghoul::MappedDictionary::write(cyclic, "dictionary.bin"));
+    {
+        // The key offset is the first member of the first record of the root table
+        const uint64_t keyOffset = uint64_t(1) << 40;
+        std::fstream f("dictionary.bin",
+                       std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(32 + sizeof(uint64_t));
+        f.write(reinterpret_cast<const char*>(&keyOffset), sizeof(uint64_t));
+    }
+    ghoul::MappedDictionary k("dictionary.bin");
+    ASSERT_TRUE(k.isValid());
+    EXPECT_TRUE(k.keys().empty());
+}
+
+namespace {
+    struct SchemaInner {
+        int size = 0;
+        std::string type = "default";
+    };
+
+    struct SchemaOuter {
+        double scale = 1.0;
+        glm::vec3 position;
+        SchemaInner inner;
+    };
+} // namespace
+
+TEST_F(DictionaryTest, Schema) {
+    ghoul::DictionarySchema<SchemaInner> innerSchema;
+    innerSchema.field("Size", &SchemaInner::size)
+               .field("Type", &SchemaInner::type, true);
+    ghoul::DictionarySchema<SchemaOuter> schema;
+    schema.field("Scale", &SchemaOuter::scale)
+          .field("Position", &SchemaOuter::position)
+          .field("Inner", &SchemaOuter::inner, innerSchema);
+
+    _d->setValue("Scale", 2.0);
+    _d->setValue("Position", glm::vec3(1.f, 2.f, 3.f));
+    _d->setValue("Inner.Size", 4, true);
+    _d->setValue("Unbound", std::string("ignored"));
+
+    SchemaOuter o;
+    std::vector<std::string> errors;
+    EXPECT_TRUE(schema.decode(*_d, o, errors));
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(2.0, o.scale);
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), o.position);
+    EXPECT_EQ(4, o.inner.size);
+    EXPECT_EQ("default", o.inner.type);
+
+    // Encoding and decoding again results in the same object
+    o.inner.type = "type";
+    ghoul::Dictionary encoded;
+    schema.encode(o, encoded);
+    EXPECT_EQ(3, encoded.size());
+    SchemaOuter o2;
+    EXPECT_TRUE(schema.decode(encoded, o2, errors));
+    EXPECT_EQ(o.scale, o2.scale);
+    EXPECT_EQ(o.position, o2.position);
+    EXPECT_EQ(o.inner.size, o2.inner.size);
+    EXPECT_EQ("type", o2.inner.type);
+
+    // All errors are collected
+    ghoul::Dictionary invalid = {
+        { "Scale", std::string("wrong") },
+        { "Inner", ghoul::Dictionary() }
+    };
+    SchemaOuter o3;
+    EXPECT_FALSE(schema.decode(invalid, o3, errors));
+    ASSERT_EQ(3, errors.size());
+    EXPECT_NE(std::string::npos, errors[0].find("'Scale'"));
+    EXPECT_NE(std::string::npos, errors[1].find("'Inner.Size'"));
+    EXPECT_NE(std::string::npos, errors[2].find("'Position'"));
+}
+
+TEST_F(DictionaryTest, SchemaConversions) {
+    ghoul::DictionarySchema<SchemaOuter> schema;
+    schema.field("Scale", &SchemaOuter::scale)
+          .field("Position", &SchemaOuter::position);
+
+    // The values are converted the same way as by getValue, for example from the tables
+    // and arrays that are created by Lua
+    ghoul::Dictionary position = {
+        { "1", 4.0 },
+        { "2", 5.0 },
+        { "3", 6.0 }
+    };
+    _d->setValue("Scale", std::vector<double>{ 3.0 });
+    _d->setValue("Position", position);
+
+    SchemaOuter o;
+    std::vector<std::string> errors;
+    EXPECT_TRUE(schema.decode(*_d, o, errors));
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(3.0, o.scale);
+    EXPECT_EQ(glm::vec3(4.f, 5.f, 6.f), o.position);
+
+    _d->setValue("Position", std::vector<long long>{ 7, 8, 9 });
+    EXPECT_TRUE(schema.decode(*_d, o, errors));
+    EXPECT_EQ(glm::vec3(7.f, 8.f, 9.f), o.position);
+
+    // Arrays of the wrong size are rejected
+    _d->setValue("Position", std::vector<double>{ 1.0, 2.0 });
+    EXPECT_FALSE(schema.decode(*_d, o, errors));
+    ASSERT_EQ(1, errors.size());
+    EXPECT_NE(std::string::npos, errors[0].find("'Position'"));
+    EXPECT_EQ(glm::vec3(7.f, 8.f, 9.f), o.position);
+}
+
+TEST_F(DictionaryTest, Arena) {
+    EXPECT_EQ(nullptr, _d->arena());
+
+    std::shared_ptr<ghoul::MemoryArena> arena = std::make_shared<ghoul::MemoryArena>(4096);
+    {
+        ghoul::Dictionary d(arena);
+        for (int i = 0; i < 100; ++i) {
+            const std::string key =
+                "a.b" + std::to_string(i % 10) + "." + std::to_string(i);
+            d.setValue(key, i, true);
+        }
+        EXPECT_EQ(arena, d.arena());
+        EXPECT_EQ(arena, d.subDictionary("a").arena());
+        EXPECT_GT(arena->usedBytes(), 0);
+
+        // Levels that are copied before they are modified use the same arena
+        ghoul::Dictionary copy = d;
+        copy.setValue("a.b0.x", 1);
+        EXPECT_EQ(arena, copy.subDictionary("a.b0").arena());
+        EXPECT_FALSE(d.hasKey("a.b0.x"));
+        int value;
+        EXPECT_TRUE(d.getValue("a.b3.13", value));
+        EXPECT_EQ(13, value);
+
+        // Snapshots are independent of the arena
+        EXPECT_EQ(nullptr, copy.freeze()->arena());
+
+        d.clear();
+        EXPECT_TRUE(d.empty());
+        EXPECT_EQ(arena, d.arena());
+    }
+    EXPECT_EQ(0, arena->usedBytes());
+    EXPECT_GT(arena->peakBytes(), 0);
+    EXPECT_LE(arena->peakBytes(), arena->reservedBytes());
+    EXPECT_GT(arena->nBlocks(), 0);
+}
+
+TEST_F(DictionaryTest, DiffApply) {
+    _d->setValue("a", 1);
+    _d->setValue("b", std::string("string"));
+    _d->setValue("c.d", glm::vec3(1.f, 2.f, 3.f), true);
+    _d->setValue("c.e.f", 2.0, true);
+    _d->setValue("g.h", 3, true);
+    _d->setValue("i", 4);
+
+    ghoul::Dictionary other = *_d;
+    EXPECT_TRUE(_d->diff(other).empty());
+
+    other.setValue("b", std::string("other"));
+    other.setValue("c.e.f", 5.0);
+    other.setValue("c.d", glm::vec3(1.f, 2.f, 4.f));
+    other.setValue("c.e.j", 6);
+    other.removeKey("i");
+    other.setValue("g", 7);
+
+    const ghoul::Dictionary::ChangeSet changes = _d->diff(other);
+    typedef ghoul::Dictionary::Change::Type Type;
+    ASSERT_EQ(6, changes.changes.size());
+    EXPECT_EQ(Type::Removed, changes.changes[0].type);
+    EXPECT_EQ("i", changes.changes[0].key);
+    EXPECT_EQ(Type::Modified, changes.changes[1].type);
+    EXPECT_EQ("b", changes.changes[1].key);
+    EXPECT_EQ(Type::Modified, changes.changes[2].type);
+    EXPECT_EQ("c.d", changes.changes[2].key);
+    EXPECT_EQ(Type::Modified, changes.changes[3].type);
+    EXPECT_EQ("c.e.f", changes.changes[3].key);
+    EXPECT_EQ(Type::Added, changes.changes[4].type);
+    EXPECT_EQ("c.e.j", changes.changes[4].key);
+    EXPECT_EQ(Type::Modified, changes.changes[5].type);
+    EXPECT_EQ("g", changes.changes[5].key);
+
+    EXPECT_TRUE(changes.affects(""));
+    EXPECT_TRUE(changes.affects("c"));
+    EXPECT_TRUE(changes.affects("c.e.f"));
+    EXPECT_TRUE(changes.affects("g.h"));
+    EXPECT_FALSE(changes.affects("a"));
+    EXPECT_FALSE(changes.affects("c.e.k"));
+    EXPECT_FALSE(changes.affects("c.ee"));
+
+    ghoul::Dictionary copy = *_d;
+    EXPECT_TRUE(copy.apply(changes));
+    EXPECT_TRUE(copy.diff(other).empty());
+    EXPECT_TRUE(other.diff(copy).empty());
+    std::string s;
+    EXPECT_TRUE(copy.getValue("b", s));
+    EXPECT_EQ("other", s);
+    glm::vec3 v;
+    EXPECT_TRUE(copy.getValue("c.d", v));
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 4.f), v);
+    int i;
+    EXPECT_TRUE(copy.getValue("g", i));
+    EXPECT_EQ(7, i);
+    EXPECT_FALSE(copy.hasKey("i"));
+
+    // The original is unaffected by the changes to its copy
+    EXPECT_TRUE(_d->getValue("g.h", i));
+    EXPECT_EQ(3, i);
+
+    // The reverse direction undoes the changes
+    EXPECT_TRUE(copy.apply(other.diff(*_d)));
+    EXPECT_TRUE(copy.diff(*_d).empty());
+
+    // The contents of unsupported types are not part of the hash, so their levels are
+    // compared even if the hashes are equal
+    ghoul::Dictionary lhs;
+    lhs.setValue("a.b", std::vector<int>{ 1 }, true);
+    ghoul::Dictionary rhs;
+    rhs.setValue("a.b", std::vector<int>{ 2 }, true);
+    EXPECT_EQ(lhs.hash(), rhs.hash());
+    const ghoul::Dictionary::ChangeSet unsupported = lhs.diff(rhs);
+    ASSERT_EQ(1, unsupported.changes.size());
+    EXPECT_EQ(Type::Modified, unsupported.changes[0].type);
+    EXPECT_EQ("a.b", unsupported.changes[0].key);
+}
+
+TEST_F(DictionaryTest, Hash) {
+    EXPECT_EQ(ghoul::Dictionary().hash(), _d->hash());
+
+    _d->setValue("a", 1);
+    _d->setValue("b", std::string("string"));
+    _d->setValue("c.d", glm::vec3(1.f, 2.f, 3.f), true);
+    _d->setValue("c.e.f", 2.0, true);
+    const uint64_t hash = _d->hash();
+    EXPECT_NE(ghoul::Dictionary().hash(), hash);
+    EXPECT_EQ(hash, _d->hash());
+
+    // The order of the keys does not matter
+    ghoul::Dictionary other;
+    other.setValue("c.e.f", 2.0, true);
+    other.setValue("c.d", glm::vec3(1.f, 2.f, 3.f));
+    other.setValue("b", std::string("string"));
+    other.setValue("a", 1);
+    EXPECT_EQ(hash, other.hash());
+
+    // Changing a nested value changes the hash of all levels along the key
+    const uint64_t hashC = other.subDictionary("c").hash();
+    other.setValue("c.e.f", 3.0);
+    EXPECT_NE(hash, other.hash());
+    EXPECT_NE(hashC, other.subDictionary("c").hash());
+    other.setValue("c.e.f", 2.0);
+    EXPECT_EQ(hash, other.hash());
+    EXPECT_EQ(hashC, other.subDictionary("c").hash());
+
+    // The original is not affected by changes to a copy
+    ghoul::Dictionary copy = *_d;
+    copy.setValue("c.d", glm::vec3(1.f, 2.f, 4.f));
+    EXPECT_NE(hash, copy.hash());
+    EXPECT_EQ(hash, _d->hash());
+    EXPECT_EQ(hash, _d->freeze()->hash());
+    copy.removeKey("c");
+    _d->removeKey("c");
+    EXPECT_EQ(_d->hash(), copy.hash());
+
+    // The type of the value is part of the hash
+    ghoul::Dictionary integral = { { "a", 1 } };
+    ghoul::Dictionary floating = { { "a", 1.0 } };
+    EXPECT_NE(integral.hash(), floating.hash());
+
+    // Empty Dictionaries have the same hash whether or not they were ever modified
+    ghoul::Dictionary emptied = { { "a", 1 } };
+    emptied.removeKey("a");
+    ghoul::Dictionary reserved;
+    reserved.reserve(4);
+    ghoul::Dictionary cleared = { { "a", 1 } };
+    cleared.clear();
+    const uint64_t empty = ghoul::Dictionary().hash();
+    EXPECT_EQ(empty, emptied.hash());
+    EXPECT_EQ(empty, reserved.hash());
+    EXPECT_EQ(empty, cleared.hash());
+    EXPECT_EQ(empty, ghoul::Dictionary(std::make_shared<ghoul::MemoryArena>()).hash());
+
+    ghoul::Dictionary nestedEmpty = { { "a", ghoul::Dictionary() } };
+    ghoul::Dictionary nestedEmptied = { { "a", emptied } };
+    EXPECT_EQ(nestedEmpty.hash(), nestedEmptied.hash());
+}
+
+TEST_F(DictionaryTest, Query) {
+    for (int i = 0; i < 3; ++i) {
+        const std::string layer = "Layers.L" + std::to_string(i);
+        _d->setValue(layer + ".Opacity", 0.5 * i, true);
+        _d->setValue(layer + ".Name", "L" + std::to_string(i));
+    }
+    _d->setValue("Layers.L1.Nested.Opacity", 1.0, true);
+    _d->setValue("Opacity", 2.0);
+
+    std::vector<ghoul::Dictionary::Match> result;
+    _d->query("Layers.*.Opacity", result);
+    ASSERT_EQ(3, result.size());
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ("Layers.L" + std::to_string(i) + ".Opacity", result[i].key);
+        const double* value = result[i].valuePtr<double>();
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(0.5 * i, *value);
+        float f;
+        EXPECT_TRUE(result[i].getValue(f));
+        EXPECT_EQ(0.5f * i, f);
+    }
+
+    result.clear();
+    _d->query("**.Opacity", result);
+    ASSERT_EQ(5, result.size());
+    EXPECT_EQ("Layers.L1.Nested.Opacity", result[2].key);
+    EXPECT_EQ("Opacity", result[4].key);
+
+    result.clear();
+    _d->query("Layers.L1.**", result);
+    EXPECT_EQ(5, result.size());
+    EXPECT_EQ("Layers.L1", result[0].key);
+    EXPECT_NE(nullptr, result[0].valuePtr<ghoul::Dictionary>());
+
+    // Batches without wildcards and patterns that match the same values
+    result.clear();
+    _d->query({ "Layers.L2.Name", "Opacity", "Layers.L0.Name", "Missing.Key",
+                "Layers.*.Name" }, result);
+    ASSERT_EQ(4, result.size());
+    std::string name;
+    EXPECT_TRUE(result[0].getValue(name));
+    EXPECT_EQ("L0", name);
+    EXPECT_EQ("Layers.L2.Name", result[2].key);
+    EXPECT_EQ("Opacity", result[3].key);
+    EXPECT_EQ(_d, result[3].parent);
+
+    result.clear();
+    _d->query("Opacity.*", result);
+    EXPECT_TRUE(result.empty());
+
+    // Values are converted from the match itself, so keys with a literal separator work
+    _d->setValue(ghoul::DictionaryKey(std::vector<std::string>{ "Dotted", "a.b" }), 3.0,
+                 true);
+    result.clear();
+    _d->query("Dotted.*", result);
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ("Dotted.a.b", result[0].key);
+    EXPECT_NE(nullptr, result[0].valuePtr<double>());
+    float f = 0.f;
+    EXPECT_TRUE(result[0].getValue(f));
+    EXPECT_EQ(3.f, f);
+}
+
+TEST_F(DictionaryTest, KeyView) {
+    _d->setValue("a.b", 1, true);
+    _d->setValue("c", std::string("string"));
+
+    // Only the first characters of a larger buffer are used as the key
+    const char buffer[] = "a.bcdef";
+    const ghoul::Dictionary::KeyView key(buffer, 3);
+    EXPECT_EQ(3, key.size());
+    EXPECT_EQ("a.b", key.str());
+    EXPECT_TRUE(_d->hasKey(key));
+    EXPECT_TRUE(_d->hasValue<int>(key));
+    int value = 0;
+    EXPECT_TRUE(_d->getValue(key, value));
+    EXPECT_EQ(1, value);
+    EXPECT_FALSE(_d->hasKey(ghoul::Dictionary::KeyView(buffer, 4)));
+
+    const char* c = "c";
+    EXPECT_TRUE(_d->hasKeyAndValue<std::string>(c));
+    EXPECT_EQ(1, _d->keys("a").size());
+    EXPECT_TRUE(_d->subDictionary("a").hasKey("b"));
+    EXPECT_TRUE(_d->removeKey(ghoul::Dictionary::KeyView(buffer, 1)));
+    EXPECT_FALSE(_d->hasKey("a.b"));
+}
+
+TEST_F(DictionaryTest, TakeValue) {
+    const std::string large(1000, 'x');
+    _d->setValue("a.b", large, true);
+    _d->setValue("a.c", 5);
+    _d->setValue("d", std::vector<double>(100, 1.0));
+
+    ghoul::Dictionary copy = *_d;
+    std::string s;
+    EXPECT_TRUE(_d->takeValue("a.b", s));
+    EXPECT_EQ(large, s);
+    EXPECT_FALSE(_d->hasKey("a.b"));
+    EXPECT_TRUE(_d->hasKey("a.c"));
+    // The copy still shares the levels that were detached for the removal
+    EXPECT_TRUE(copy.hasValue<std::string>("a.b"));
+
+    // Converted values are retrieved as with getValue
+    int i = 0;
+    EXPECT_TRUE(_d->takeValue("a.c", i));
+    EXPECT_EQ(5, i);
+    EXPECT_TRUE(_d->hasKey("a"));
+    EXPECT_TRUE(_d->subDictionary("a").empty());
+
+    std::vector<double> array;
+    EXPECT_TRUE(_d->takeValue("d", array));
+    EXPECT_EQ(100, array.size());
+    EXPECT_FALSE(_d->hasKey("d"));
+
+    EXPECT_FALSE(_d->takeValue("missing", s));
+    _d->setValue("e", 1.0);
+    EXPECT_FALSE(_d->takeValue("e", s));
+    EXPECT_TRUE(_d->hasKey("e"));
+}
+
+TEST_F(DictionaryTest, EmplaceValue) {
+    EXPECT_TRUE(_d->emplaceValue<std::string>("a.b.c", 5, 'x'));
+    EXPECT_EQ("xxxxx", _d->value<std::string>("a.b.c"));
+    EXPECT_TRUE(_d->emplaceValue<std::vector<long long>>("a.d", 3, 7));
+    EXPECT_EQ(3, _d->valuePtr<std::vector<long long>>("a.d")->size());
+    EXPECT_TRUE(_d->emplaceValue<glm::vec3>("e", 1.f, 2.f, 3.f));
+    glm::vec3 v;
+    EXPECT_TRUE(_d->getValue("e", v));
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), v);
+}
+
+TEST_F(DictionaryTest, ExtractSubDictionary) {
+    _d->setValue("a.b.c", 1, true);
+    _d->setValue("a.d", std::string("string"));
+    _d->setValue("e", 2);
+
+    ghoul::Dictionary a = _d->extractSubDictionary("a");
+    EXPECT_FALSE(_d->hasKey("a"));
+    EXPECT_EQ(1, _d->size());
+    EXPECT_TRUE(a.hasKey("b.c"));
+    EXPECT_EQ("string", a.value<std::string>("d"));
+    // The extracted Dictionary is no longer shared, so modifying it copies nothing
+    EXPECT_EQ(0, a.memoryUsage().sharedBytes);
+
+    EXPECT_TRUE(_d->extractSubDictionary("missing").empty());
+    EXPECT_TRUE(_d->extractSubDictionary("e").empty());
+    EXPECT_TRUE(_d->hasKey("e"));
+}
+
+TEST_F(DictionaryTest, KeyInterning) {
+    EXPECT_FALSE(ghoul::Dictionary::isKeyInterningEnabled());
+    _d->setValue("Own", 1);
+
+    ghoul::Dictionary::setKeyInterningEnabled(true);
+    ghoul::Dictionary first;
+    first.setValue("Renderable.Type", std::string("Sphere"), true);
+    first.setValue("Own", 2);
+    ghoul::Dictionary second;
+    second.setValue("Renderable.Type", std::string("Sphere"), true);
+    ghoul::Dictionary::setKeyInterningEnabled(false);
+    second.setValue("Own", 2);
+
+    EXPECT_EQ("Sphere", first.value<std::string>("Renderable.Type"));
+    EXPECT_EQ(first.hash(), second.hash());
+    EXPECT_TRUE(first.diff(second).empty());
+    EXPECT_EQ(first.keys(), second.keys());
+
+    // Interned and non-interned keys can be mixed within one level
+    _d->setValue("Other", 3);
+    ghoul::Dictionary::setKeyInterningEnabled(true);
+    _d->setValue("Own", 4);
+    _d->setValue("Another", 5);
+    ghoul::Dictionary::setKeyInterningEnabled(false);
+    int value = 0;
+    EXPECT_TRUE(_d->getValue("Own", value));
+    EXPECT_EQ(4, value);
+    EXPECT_TRUE(_d->getValue("Other", value));
+    EXPECT_EQ(3, value);
+    EXPECT_TRUE(_d->getValue("Another", value));
+    EXPECT_EQ(5, value);
+    EXPECT_TRUE(_d->removeKey("Another"));
+    EXPECT_EQ(2, _d->size());
+}
+
 TEST_F(DictionaryTest, InitializerLists) {
 	ghoul::Dictionary d = { { "a", 1 } };
 	ghoul::Dictionary d2 = { { "a", 1 }, { "b", 2 } };
@@ -24,8 +24,12 @@
 ****************************************************************************************/
 
 #include <ghoul/filesystem/filesystem>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 #ifdef WIN32
 #include <windows.h>
@@ -135,3 +139,95 @@ TEST(FileSystemTest, OnChangeCallback) {
 	// Check that we can delete the file
 	EXPECT_EQ(FileSys.deleteFile(path), true);
 }
+
+TEST(FileSystemTest, OnChangeCallbackLatency) {
+	using ghoul::filesystem::File;
+	typedef std::chrono::steady_clock Clock;
+
+	const std::string path = absPath("${TEST_DIR}/tmplatency.txt");
+	std::ofstream(path) << "tmp";
+
+	std::atomic<bool> changed(false);
+	File file(path, true, [&changed](const File&) { changed = true; });
+
+	const Clock::time_point start = Clock::now();
+	std::ofstream(path) << "changed";
+	while (!changed && Clock::now() - start < std::chrono::seconds(4)) {
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+		FileSys.triggerFilesystemEvents();
+	}
+	const std::chrono::milliseconds latency =
+		std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+	std::cout << "Notification latency: " << latency.count() << " ms" << std::endl;
+	EXPECT_EQ(true, changed.load());
+	EXPECT_LT(latency.count(), 250);
+
+	// Files that are replaced, as many editors do when saving, are tracked further
+	changed = false;
+	const std::string replacement = absPath("${TEST_DIR}/tmplatency2.txt");
+	std::ofstream(replacement) << "replaced";
+	std::rename(replacement.c_str(), path.c_str());
+	for (int i = 0; i < 4000 && !changed; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		FileSys.triggerFilesystemEvents();
+	}
+	changed = false;
+	std::ofstream(path) << "changed again";
+	for (int i = 0; i < 4000 && !changed; ++i) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		FileSys.triggerFilesystemEvents();
+	}
+	EXPECT_EQ(true, changed.load());
+
+	file.setCallback(nullptr);
+	EXPECT_EQ(FileSys.deleteFile(path), true);
+}
+
+#if !defined(WIN32) && !defined(__APPLE__)
+
+TEST(FileSystemTest, OnChangeCallbackCoalescing) {
+	using ghoul::filesystem::File;
+
+	const std::string path = absPath("${TEST_DIR}/tmpcoalescing.txt");
+	std::ofstream(path) << "tmp";
+
+	int nCalls = 0;
+	File file(path, true, [&nCalls](const File&) { ++nCalls; });
+
+	// Each write causes its own events, but they are only dispatched on this thread
+	for (int i = 0; i < 10; ++i)
+		std::ofstream(path, std::ofstream::app) << i;
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(0, nCalls);
+
+	FileSys.triggerFilesystemEvents();
+	EXPECT_EQ(1, nCalls);
+	FileSys.triggerFilesystemEvents();
+	EXPECT_EQ(1, nCalls);
+
+	file.setCallback(nullptr);
+	EXPECT_EQ(FileSys.deleteFile(path), true);
+}
+
+TEST(FileSystemTest, TeardownTime) {
+	using ghoul::filesystem::FileSystem;
+	typedef std::chrono::steady_clock Clock;
+
+	const std::string testDir = absPath("${TEST_DIR}");
+	const std::string scriptsDir = absPath("${SCRIPTS_DIR}");
+
+	// Let the watcher thread go idle, so that it has to be woken up
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	const Clock::time_point start = Clock::now();
+	FileSystem::deinitialize();
+	const std::chrono::milliseconds teardown =
+		std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+	std::cout << "Teardown time: " << teardown.count() << " ms" << std::endl;
+	EXPECT_LT(teardown.count(), 100);
+
+	FileSystem::initialize();
+	FileSys.registerPathToken("${SCRIPTS_DIR}", scriptsDir);
+	FileSys.registerPathToken("${TEST_DIR}", testDir);
+}
+
+#endif // !WIN32 && !__APPLE__
@@ -24,10 +24,21 @@
  ****************************************************************************************/
 
 #include <ghoul/glm.h>
+#include <algorithm>
 #include <fstream>
 #include <random>
+#include <thread>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/directory.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/lua/configurationwatcher.h>
+#include <ghoul/lua/dictionaryproxy.h>
+#include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/lua/lua_helper.h>
+#include <ghoul/lua/luaallocator.h>
+#include <ghoul/lua/luabinding.h>
+#include <ghoul/lua/luaprofiler.h>
+#include <ghoul/lua/luastatepool.h>
 
 namespace {
     // A non-existing configuration file
@@ -488,4 +499,591 @@ TEST_F(LuaToDictionaryTest, LoadTest4CfgDirect) {
 
 
 
-}
\ No newline at end of file
+}
+TEST_F(LuaToDictionaryTest, ContiguousArrays) {
+    const std::string script =
+        "return { a = { 1, 2, 3 }, b = { 1, \"2\" }, c = { x = 1 }, d = { {1, 2} } }";
+
+    _d.clear();
+    bool success = ghoul::lua::loadDictionaryFromString(script, _d, nullptr, true);
+    ASSERT_EQ(true, success);
+    EXPECT_EQ(4, _d.size());
+
+    const std::vector<double>* a = _d.valuePtr<std::vector<double>>("a");
+    ASSERT_NE(nullptr, a);
+    EXPECT_EQ(std::vector<double>({ 1.0, 2.0, 3.0 }), *a);
+
+    glm::vec3 vec3Value;
+    success = _d.getValue("a", vec3Value);
+    EXPECT_EQ(true, success);
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), vec3Value);
+
+    EXPECT_EQ(true, _d.hasValue<ghoul::Dictionary>("b"));
+    EXPECT_EQ(true, _d.hasValue<ghoul::Dictionary>("c"));
+    EXPECT_EQ(true, _d.hasValue<std::vector<double>>("d.1"));
+}
+
+TEST_F(LuaToDictionaryTest, Arena) {
+    const std::string script = "return { a = { b = { c = 1 } }, d = \"e\" }";
+
+    // Without an arena, the levels are allocated individually
+    bool success = ghoul::lua::loadDictionaryFromString(script, _d);
+    ASSERT_EQ(true, success);
+    EXPECT_EQ(nullptr, _d.arena());
+    EXPECT_EQ(nullptr, _d.subDictionary("a").arena());
+
+    std::shared_ptr<ghoul::MemoryArena> arena = std::make_shared<ghoul::MemoryArena>();
+    _d = ghoul::Dictionary(arena);
+    success = ghoul::lua::loadDictionaryFromString(script, _d);
+    ASSERT_EQ(true, success);
+    EXPECT_EQ(arena, _d.arena());
+    EXPECT_EQ(arena, _d.subDictionary("a").arena());
+    EXPECT_EQ(arena, _d.subDictionary("a.b").arena());
+    EXPECT_EQ(1, arena->nBlocks());
+    EXPECT_GT(arena->peakBytes(), 0);
+}
+
+TEST_F(LuaToDictionaryTest, VerbatimKeys) {
+    const std::string script = "return { [\"a.b\"] = 1, a = { b = 2 }, c = true }";
+
+    bool success = ghoul::lua::loadDictionaryFromString(script, _d);
+    ASSERT_EQ(true, success);
+    EXPECT_EQ(3, _d.size());
+
+    // The literal key takes precedence over the nested one
+    double value = 0.0;
+    EXPECT_EQ(true, _d.getValue("a.b", value));
+    EXPECT_EQ(1.0, value);
+    EXPECT_EQ(true, _d.subDictionary("a").getValue("b", value));
+    EXPECT_EQ(2.0, value);
+
+    bool boolValue = false;
+    EXPECT_EQ(true, _d.getValue("c", boolValue));
+    EXPECT_EQ(true, boolValue);
+}
+
+TEST_F(LuaToDictionaryTest, VerbatimKeysDiffApply) {
+    bool success = ghoul::lua::loadDictionaryFromString("return { [\"a.b\"] = 1 }", _d);
+    ASSERT_EQ(true, success);
+    ghoul::Dictionary other;
+    success = ghoul::lua::loadDictionaryFromString(
+        "return { [\"a.b\"] = 2, c = { [\"d.e\"] = 3 } }",
+        other
+    );
+    ASSERT_EQ(true, success);
+
+    // Keys that contain a '.' are changed on their own level instead of being split
+    const ghoul::Dictionary::ChangeSet changes = _d.diff(other);
+    ASSERT_EQ(2, changes.changes.size());
+    EXPECT_EQ(1, changes.changes[0].path.nSegments());
+    EXPECT_EQ("a.b", changes.changes[0].path.segment(0));
+    EXPECT_EQ(2, changes.changes[1].path.nSegments());
+    EXPECT_EQ("d.e", changes.changes[1].path.segment(1));
+
+    ghoul::Dictionary copy = _d;
+    EXPECT_EQ(true, copy.apply(changes));
+    EXPECT_EQ(2, copy.size());
+    EXPECT_EQ(false, copy.hasKey("a"));
+    EXPECT_EQ(2.0, copy.value<double>("a.b"));
+    EXPECT_EQ(3.0, copy.subDictionary("c").value<double>("d.e"));
+    EXPECT_EQ(true, copy.diff(other).empty());
+
+    EXPECT_EQ(true, copy.apply(other.diff(_d)));
+    EXPECT_EQ(1, copy.size());
+    EXPECT_EQ(1.0, copy.value<double>("a.b"));
+}
+
+TEST_F(LuaToDictionaryTest, Sequences) {
+    const std::string script =
+        "local t = {} for i = 1, 20 do t[i] = 'v' .. i end "
+        "return { s = t, sparse = { [1] = 1, [3] = 3 }, e = {} }";
+
+    bool success = ghoul::lua::loadDictionaryFromString(script, _d);
+    ASSERT_EQ(true, success);
+
+    // Sequences are added in the order of their indices
+    const ghoul::Dictionary& s = _d.subDictionary("s");
+    EXPECT_EQ(20, s.size());
+    int i = 1;
+    s.forEach([&i](const std::string& key, const ghoul::Dictionary*) {
+        EXPECT_EQ(std::to_string(i), key);
+        ++i;
+    });
+    EXPECT_EQ("v12", s.value<std::string>("12"));
+
+    EXPECT_EQ(2, _d.subDictionary("sparse").size());
+    EXPECT_EQ(true, _d.hasKey("sparse.3"));
+    EXPECT_EQ(true, _d.subDictionary("e").empty());
+
+    EXPECT_THROW(
+        ghoul::lua::loadDictionaryFromString("return { 1, a = 2 }", _d),
+        ghoul::lua::FormattingException
+    );
+}
+
+TEST_F(LuaToDictionaryTest, StatePool) {
+    ghoul::lua::LuaStatePool pool(1);
+    lua_State* state = nullptr;
+    {
+        ghoul::lua::LuaStatePool::Lease lease = pool.acquire();
+        ASSERT_EQ(true, static_cast<bool>(lease));
+        state = lease.state();
+        ASSERT_EQ(0, luaL_dostring(state,
+            "x = 5 print = nil package.loaded.module = {} package.loaded.string = 1"
+        ));
+        EXPECT_EQ(0, pool.nIdleStates());
+    }
+    EXPECT_EQ(1, pool.nIdleStates());
+
+    // The returned state is reused after it has been reset
+    ghoul::lua::LuaStatePool::Lease lease = pool.acquire();
+    EXPECT_EQ(state, lease.state());
+    EXPECT_EQ(0, lua_gettop(state));
+    lua_getglobal(state, "x");
+    EXPECT_EQ(true, lua_isnil(state, -1));
+    lua_getglobal(state, "print");
+    EXPECT_EQ(true, lua_isfunction(state, -1));
+    // Modules that were loaded by the previous lease are loaded again
+    ASSERT_EQ(0, luaL_dostring(state,
+        "return package.loaded.module == nil and package.loaded.string == string"
+    ));
+    EXPECT_EQ(true, lua_toboolean(state, -1));
+    lua_settop(state, 0);
+
+    // Only one idle state is kept
+    {
+        ghoul::lua::LuaStatePool::Lease other = pool.acquire();
+        EXPECT_NE(state, other.state());
+    }
+    EXPECT_EQ(1, pool.nIdleStates());
+    pool.clear();
+    EXPECT_EQ(0, pool.nIdleStates());
+}
+
+TEST_F(LuaToDictionaryTest, LoadDictionariesFromFiles) {
+    std::vector<std::string> filenames;
+    for (int i = 0; i < 8; ++i) {
+        filenames.push_back(_configuration1);
+        filenames.push_back(_configuration2);
+        filenames.push_back(_configuration3);
+        filenames.push_back(_configuration4);
+    }
+
+    std::vector<ghoul::Dictionary> dictionaries;
+    bool success = ghoul::lua::loadDictionariesFromFiles(filenames, dictionaries);
+    ASSERT_EQ(true, success);
+    ASSERT_EQ(filenames.size(), dictionaries.size());
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        ghoul::Dictionary expected;
+        ghoul::lua::loadDictionaryFromFile(filenames[i], expected);
+        EXPECT_EQ(expected.hash(), dictionaries[i].hash()) << filenames[i];
+    }
+
+    filenames.push_back(_configuration0);
+    success = ghoul::lua::loadDictionariesFromFiles(filenames, dictionaries);
+    EXPECT_EQ(false, success);
+    EXPECT_EQ(filenames.size(), dictionaries.size());
+    EXPECT_EQ(true, dictionaries.back().empty());
+    EXPECT_EQ(false, dictionaries.front().empty());
+}
+
+TEST_F(LuaToDictionaryTest, BytecodeCache) {
+    using ghoul::lua::ScriptCache;
+    const std::string cacheDir = absPath("${TEST_DIR}/luatodictionary/cache");
+    const std::string script = absPath("${TEST_DIR}/luatodictionary/bytecode.cfg");
+    FileSys.createDirectory(cacheDir);
+    ASSERT_EQ(true, FileSys.createCacheManager(cacheDir));
+
+    auto load = [](const std::string& file, ghoul::Dictionary& d) {
+        return ghoul::lua::loadDictionaryFromFile(
+            file, d, nullptr, false, ScriptCache::Bytecode
+        );
+    };
+
+    std::ofstream(script) << "return { a = 1 }";
+    ghoul::Dictionary d;
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(1.0, d.value<double>("a"));
+    EXPECT_EQ(true, FileSys.cacheManager()->hasCachedFile(
+        ghoul::filesystem::File(script, true), "LuaBytecode")
+    );
+
+    // The second load uses the cached bytecode
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(1.0, d.value<double>("a"));
+
+    // Changing the script invalidates the cached bytecode
+    std::ofstream(script) << "return { a = 2 }";
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(2.0, d.value<double>("a"));
+
+    ghoul::Dictionary expected;
+    ghoul::lua::loadDictionaryFromFile(_configuration3, expected);
+    d.clear();
+    for (int i = 0; i < 2; ++i) {
+        load(_configuration3, d);
+        EXPECT_EQ(expected.hash(), d.hash());
+    }
+
+    FileSys.destroyCacheManager();
+    FileSys.deleteFile(script);
+    FileSys.deleteDirectory(cacheDir, true);
+}
+
+TEST_F(LuaToDictionaryTest, ResultCache) {
+    using ghoul::lua::ScriptCache;
+    const std::string cacheDir = absPath("${TEST_DIR}/luatodictionary/cache");
+    const std::string script = absPath("${TEST_DIR}/luatodictionary/result.cfg");
+    const std::string dependency = absPath("${TEST_DIR}/luatodictionary/dependency.cfg");
+    const std::string untracked = absPath("${TEST_DIR}/luatodictionary/untracked.txt");
+    FileSys.createDirectory(cacheDir);
+    ASSERT_EQ(true, FileSys.createCacheManager(cacheDir));
+
+    auto load = [](const std::string& file, ghoul::Dictionary& d) {
+        return ghoul::lua::loadDictionaryFromFile(
+            file, d, nullptr, false, ScriptCache::Result
+        );
+    };
+
+    // The file read with io.open is not a dependency, which shows whether the script was
+    // executed
+    std::ofstream(script) << "local f = io.open('" << untracked << "') "
+                             "local u = f:read('*n') f:close() "
+                             "return { a = dofile('" << dependency << "'), u = u }";
+    std::ofstream(dependency) << "return 1";
+    std::ofstream(untracked) << "1";
+
+    ghoul::Dictionary d;
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(1.0, d.value<double>("a"));
+    EXPECT_EQ(1.0, d.value<double>("u"));
+
+    // The cached result is used without executing the script
+    std::ofstream(untracked) << "2";
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(1.0, d.value<double>("a"));
+    EXPECT_EQ(1.0, d.value<double>("u"));
+
+    // The cached result is added to the provided values
+    ghoul::Dictionary e = { { "b", 5.0 } };
+    ASSERT_EQ(true, load(script, e));
+    EXPECT_EQ(1.0, e.value<double>("a"));
+    EXPECT_EQ(5.0, e.value<double>("b"));
+
+    // Changing a dependency invalidates the cached result
+    std::ofstream(dependency) << "return 3";
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(3.0, d.value<double>("a"));
+    EXPECT_EQ(2.0, d.value<double>("u"));
+
+    // A script with the same name in a different directory has its own cached result
+    const std::string otherDir = absPath("${TEST_DIR}/luatodictionary/other");
+    const std::string otherScript = otherDir + "/result.cfg";
+    FileSys.createDirectory(otherDir);
+    std::ofstream(otherScript) << "return { a = 4 }";
+    d.clear();
+    ASSERT_EQ(true, load(otherScript, d));
+    EXPECT_EQ(4.0, d.value<double>("a"));
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(3.0, d.value<double>("a"));
+
+    // A corrupted cached result is rejected and the script is executed again
+    using ghoul::filesystem::Directory;
+    for (const std::string& directory : Directory(cacheDir).readDirectories()) {
+        for (const std::string& f : Directory(directory).readFiles(true)) {
+            std::ifstream in(f, std::ifstream::binary);
+            std::string contents(
+                (std::istreambuf_iterator<char>(in)),
+                std::istreambuf_iterator<char>()
+            );
+            in.close();
+            if (!contents.empty())
+                contents.pop_back();
+            std::ofstream(f, std::ofstream::binary) << contents;
+        }
+    }
+    std::ofstream(untracked) << "6";
+    d.clear();
+    ASSERT_EQ(true, load(script, d));
+    EXPECT_EQ(3.0, d.value<double>("a"));
+    EXPECT_EQ(6.0, d.value<double>("u"));
+
+    FileSys.destroyCacheManager();
+    FileSys.deleteFile(script);
+    FileSys.deleteFile(dependency);
+    FileSys.deleteFile(untracked);
+    FileSys.deleteDirectory(otherDir, true);
+    FileSys.deleteDirectory(cacheDir, true);
+}
+
+TEST_F(LuaToDictionaryTest, Allocator) {
+    ghoul::lua::LuaAllocator allocator;
+    lua_State* state = ghoul::lua::createNewLuaState(allocator);
+    ASSERT_NE(nullptr, state);
+    const ghoul::lua::LuaAllocator::Statistics& stats = allocator.statistics();
+    EXPECT_LT(0, stats.currentBytes);
+    EXPECT_EQ(stats.currentBytes, static_cast<size_t>(lua_gc(state, LUA_GCCOUNT, 0)) *
+              1024 + lua_gc(state, LUA_GCCOUNTB, 0));
+
+    ghoul::Dictionary d;
+    ASSERT_EQ(true, ghoul::lua::loadDictionaryFromFile(_configuration3, d, state));
+    EXPECT_LE(stats.currentBytes, stats.peakBytes);
+    EXPECT_LT(stats.nDeallocations, stats.nAllocations);
+    EXPECT_EQ(0, stats.nFailedAllocations);
+
+    // Exceeding the memory limit raises an error in Lua
+    allocator.setMemoryLimit(stats.currentBytes + 64 * 1024);
+    ASSERT_EQ(
+        LUA_OK,
+        luaL_loadstring(state, "local t = {} for i = 1, 100000 do t[i] = i end")
+    );
+    EXPECT_EQ(LUA_ERRMEM, lua_pcall(state, 0, 0, 0));
+    EXPECT_LT(0, stats.nFailedAllocations);
+    EXPECT_GE(allocator.memoryLimit(), stats.peakBytes);
+    lua_settop(state, 0);
+    ghoul::lua::destroyLuaState(state);
+    EXPECT_EQ(0, stats.currentBytes);
+
+    // A state cannot be created if its libraries do not fit into the limit
+    ghoul::lua::LuaAllocator tinyAllocator(1024);
+    EXPECT_EQ(nullptr, ghoul::lua::createNewLuaState(tinyAllocator));
+}
+
+TEST_F(LuaToDictionaryTest, Profiler) {
+    lua_State* state = ghoul::lua::createNewLuaState();
+    ghoul::lua::LuaProfiler profiler(10);
+    profiler.attach(state);
+    EXPECT_EQ(true, profiler.isAttached());
+    ASSERT_EQ(0, luaL_dostring(state,
+        "local function f(n) local s = 0 for i = 1, n do s = s + i end return s end\n"
+        "for i = 1, 10 do f(1000) end\n"
+        "pcall(function() error('e') end)"
+    ));
+    profiler.detach();
+    EXPECT_EQ(false, profiler.isAttached());
+
+    const std::vector<ghoul::lua::LuaProfiler::FunctionProfile> functions =
+        profiler.functionProfiles();
+    auto f = std::find_if(functions.begin(), functions.end(),
+        [](const ghoul::lua::LuaProfiler::FunctionProfile& p) {
+            return p.name.find("f <") == 0;
+        }
+    );
+    ASSERT_NE(functions.end(), f);
+    EXPECT_EQ(10, f->nCalls);
+    EXPECT_LT(0, f->nInstructions);
+    EXPECT_LE(f->exclusiveTime, f->inclusiveTime);
+    EXPECT_EQ(false, profiler.lineProfiles().empty());
+
+    const std::string stacks = profiler.collapsedStacks(
+        ghoul::lua::LuaProfiler::StackValue::Instructions
+    );
+    EXPECT_NE(std::string::npos, stacks.find("main chunk <"));
+    EXPECT_NE(std::string::npos, stacks.find(";f <"));
+    EXPECT_NE(std::string::npos, profiler.flatProfile().find(f->name));
+
+    profiler.reset();
+    EXPECT_EQ(true, profiler.functionProfiles().empty());
+    ghoul::lua::destroyLuaState(state);
+}
+
+namespace {
+    double bindingAdd(double a, int b) { return a + b; }
+
+    std::tuple<std::string, glm::dvec3> bindingScale(const std::string& name,
+                                                     glm::dvec3 v, double s)
+    {
+        return std::make_tuple(name + "!", v * s);
+    }
+
+    int bindingThrow() { throw std::runtime_error("binding error"); }
+} // namespace
+
+TEST_F(LuaToDictionaryTest, Binding) {
+    lua_State* state = ghoul::lua::createNewLuaState();
+    ASSERT_NE(nullptr, state);
+    // The parentheses protect the template arguments from the macro
+    lua_register(state, "add", (&ghoul::lua::bind<decltype(&bindingAdd), &bindingAdd>));
+    lua_register(
+        state, "scale", (&ghoul::lua::bind<decltype(&bindingScale), &bindingScale>)
+    );
+    lua_register(
+        state, "throw", (&ghoul::lua::bind<decltype(&bindingThrow), &bindingThrow>)
+    );
+
+    int nCalls = 0;
+    ghoul::lua::pushFunction(state, std::function<int(ghoul::Dictionary)>(
+        [&nCalls](ghoul::Dictionary d) -> int {
+            ++nCalls;
+            return static_cast<int>(d.size());
+        }
+    ));
+    lua_setglobal(state, "count");
+
+    ASSERT_EQ(0, luaL_dostring(state, "return add(1.5, 2)"));
+    EXPECT_EQ(3.5, ghoul::lua::value<double>(state, -1));
+    lua_settop(state, 0);
+
+    ASSERT_EQ(0, luaL_dostring(state, "return scale('a', { 1, 2, 3 }, 2)"));
+    ASSERT_EQ(2, lua_gettop(state));
+    EXPECT_EQ("a!", ghoul::lua::value<std::string>(state, 1));
+    ASSERT_EQ(true, ghoul::lua::hasValue<glm::dvec3>(state, 2));
+    EXPECT_EQ(glm::dvec3(2.0, 4.0, 6.0), ghoul::lua::value<glm::dvec3>(state, 2));
+    lua_settop(state, 0);
+
+    ASSERT_EQ(0, luaL_dostring(state, "return count({ a = 1, b = { 2 } })"));
+    EXPECT_EQ(2, ghoul::lua::value<int>(state, -1));
+    EXPECT_EQ(1, nCalls);
+    lua_settop(state, 0);
+
+    EXPECT_NE(0, luaL_dostring(state, "return throw()"));
+    EXPECT_NE(std::string::npos,
+              ghoul::lua::value<std::string>(state, -1).find("binding error"));
+    lua_settop(state, 0);
+
+#if GHOUL_LUA_CHECK_ARGUMENTS
+    EXPECT_NE(0, luaL_dostring(state, "return add('a', 2)"));
+    EXPECT_NE(0, luaL_dostring(state, "return add(1)"));
+    lua_settop(state, 0);
+#endif // GHOUL_LUA_CHECK_ARGUMENTS
+
+    ghoul::Dictionary d = { { "a", 1.0 }, { "b", std::string("c") } };
+    d.setValue("seq.1", 2.0);
+    d.setValue("seq.2", 3.0);
+    ghoul::lua::push(state, d);
+    ghoul::Dictionary roundTrip = ghoul::lua::value<ghoul::Dictionary>(state, -1);
+    EXPECT_EQ(1.0, roundTrip.value<double>("a"));
+    EXPECT_EQ("c", roundTrip.value<std::string>("b"));
+    lua_rawgeti(state, -1, 1);
+    EXPECT_EQ(LUA_TNIL, lua_type(state, -1));
+    lua_getfield(state, -2, "seq");
+    EXPECT_EQ(2, static_cast<int>(lua_rawlen(state, -1)));
+
+    ghoul::lua::destroyLuaState(state);
+}
+
+TEST_F(LuaToDictionaryTest, DictionaryProxy) {
+    lua_State* state = ghoul::lua::createNewLuaState();
+    ASSERT_NE(nullptr, state);
+    lua_register(state, "toTable", &ghoul::lua::dictionaryProxyToTable);
+
+    ghoul::Dictionary d;
+    d.setValue("name", std::string("config"));
+    d.setValue("value", 2.5);
+    d.setValue("nested.inner", std::string("x"));
+    d.setValue("list.1", 1.0);
+    d.setValue("list.2", 2.0);
+    d.setValue("list.3", 3.0);
+    d.setValue("array", std::vector<double>{ 1.0, 2.0 });
+    ghoul::lua::pushDictionaryProxy(state, d);
+    lua_setglobal(state, "config");
+
+    const std::string script =
+        "assert(type(config) == 'userdata') "
+        "assert(config.name == 'config' and config.value == 2.5) "
+        "assert(config.missing == nil and config[1] == nil) "
+        "assert(config.nested.inner == 'x') "
+        "assert(config.nested == config.nested) "
+        "assert(#config.list == 3 and #config == 0 and config.list[2] == 2) "
+        "assert(config[1e300] == nil and config[0/0] == nil and config[1.5] == nil) "
+        "local n = 0 for k, v in pairs(config) do n = n + 1 end assert(n == 5) "
+        "local s = 0 for i, v in ipairs(config.list) do s = s + v end assert(s == 6) "
+        "local keys = {} for k in pairs(config.list) do keys[#keys + 1] = k end "
+        "assert(keys[1] == 1 and keys[3] == 3) "
+        "assert(not pcall(function() config.name = 'other' end)) "
+        "config.array[1] = 5 assert(config.array[1] == 1 and #config.array == 2) "
+        "local t = toTable(config) "
+        "assert(type(t) == 'table' and t.nested.inner == 'x' and #t.list == 3) "
+        "return config.nested";
+    ASSERT_EQ(0, luaL_dostring(state, script.c_str()));
+
+    const ghoul::Dictionary* nested = ghoul::lua::dictionaryFromProxy(state, -1);
+    ASSERT_NE(nullptr, nested);
+    EXPECT_EQ("x", nested->value<std::string>("inner"));
+    EXPECT_EQ(nullptr, ghoul::lua::dictionaryFromProxy(state, 1000));
+
+    // The proxy reads from a snapshot, so later modifications are not visible
+    d.setValue("name", std::string("changed"));
+    lua_settop(state, 0);
+    ASSERT_EQ(0, luaL_dostring(state, "return config.name"));
+    EXPECT_EQ("config", std::string(lua_tostring(state, -1)));
+
+    ghoul::lua::destroyLuaState(state);
+}
+
+TEST_F(LuaToDictionaryTest, ConfigurationWatcher) {
+    const std::string script = absPath("${TEST_DIR}/luatodictionary/watched.cfg");
+    std::ofstream(script) << "return { a = 1, b = 'b' }";
+
+    int nCalls = 0;
+    double a = 0.0;
+    bool bChanged = true;
+    ghoul::lua::ConfigurationWatcher watcher;
+    const bool success = watcher.watch(script,
+        [&](const ghoul::Dictionary& d, const ghoul::Dictionary::ChangeSet& changes) {
+            ++nCalls;
+            a = d.value<double>("a");
+            bChanged = changes.affects("b");
+        }
+    );
+    ASSERT_EQ(true, success);
+    EXPECT_EQ(true, watcher.isWatching(script));
+    // The initial configuration is delivered immediately
+    EXPECT_EQ(1, nCalls);
+    EXPECT_EQ(1.0, a);
+
+    // A burst of writes is debounced into a single reload
+    for (int i = 2; i <= 4; ++i)
+        std::ofstream(script) << "return { a = " << i << ", b = 'b' }";
+
+    for (int i = 0; i < 400 && a != 4.0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        FileSys.triggerFilesystemEvents();
+    }
+    // Keep delivering events for a few more debounce intervals so that a late second
+    // reload of the same burst would be noticed
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        FileSys.triggerFilesystemEvents();
+    }
+    EXPECT_EQ(2, nCalls);
+    EXPECT_EQ(4.0, a);
+    EXPECT_EQ(false, bChanged);
+    EXPECT_EQ(4.0, watcher.configuration(script)->value<double>("a"));
+
+    watcher.unwatch(script);
+    EXPECT_EQ(false, watcher.isWatching(script));
+    EXPECT_EQ(nullptr, watcher.configuration(script));
+    FileSys.deleteFile(script);
+}
+
+#ifdef GHL_TIMING_TESTS
+
+TEST_F(LuaToDictionaryTest, TimingTest) {
+    std::ofstream logFile("LuaToDictionaryTest.timing");
+
+    lua_State* state = ghoul::lua::createNewLuaState();
+    ASSERT_NE(nullptr, state);
+    const std::string script =
+        "local t = {} for i = 1, 1000000 do t[i] = i end return { values = t }";
+    ASSERT_EQ(0, luaL_dostring(state, script.c_str()));
+
+    START_TIMER(convert1MElementTable, logFile, 5);
+    ghoul::lua::luaDictionaryFromState(state, _d);
+    FINISH_TIMER(convert1MElementTable, logFile);
+    EXPECT_EQ(1000000, _d.subDictionary("values").size());
+
+    START_TIMER(convert1MElementTableContiguous, logFile, 5);
+    ghoul::lua::luaDictionaryFromState(state, _d, true);
+    FINISH_TIMER(convert1MElementTableContiguous, logFile);
+    EXPECT_EQ(1000000, _d.valuePtr<std::vector<double>>("values")->size());
+
+    ghoul::lua::destroyLuaState(state);
+}
+
+#endif // GHL_TIMING_TESTS
@@ -0,0 +1,91 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2015                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/mpscqueue.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueue, SingleThread) {
+    ghoul::MpscQueue<std::string> queue;
+    std::string value;
+    EXPECT_EQ(false, queue.pop(value));
+
+    queue.push("first");
+    queue.push("second");
+    ASSERT_EQ(true, queue.pop(value));
+    EXPECT_EQ("first", value);
+    queue.push("third");
+    ASSERT_EQ(true, queue.pop(value));
+    EXPECT_EQ("second", value);
+    ASSERT_EQ(true, queue.pop(value));
+    EXPECT_EQ("third", value);
+    EXPECT_EQ(false, queue.pop(value));
+}
+
+TEST(MpscQueue, RemainingValuesAreDestroyed) {
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    {
+        ghoul::MpscQueue<std::shared_ptr<int>> queue;
+        queue.push(value);
+        queue.push(value);
+        EXPECT_EQ(3, value.use_count());
+    }
+    EXPECT_EQ(1, value.use_count());
+}
+
+TEST(MpscQueue, MultipleProducers) {
+    const int nProducers = 4;
+    const int nValues = 20000;
+    ghoul::MpscQueue<std::pair<int, int>> queue;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < nProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < nValues; ++i)
+                queue.push(std::make_pair(p, i));
+        });
+    }
+
+    // The values of each producer have to arrive in order and exactly once
+    std::vector<int> next(nProducers, 0);
+    int nPopped = 0;
+    std::pair<int, int> value;
+    while (nPopped < nProducers * nValues) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(next[value.first], value.second);
+        ++next[value.first];
+        ++nPopped;
+    }
+    EXPECT_EQ(false, queue.pop(value));
+
+    for (std::thread& t : producers)
+        t.join();
+}